@@ -0,0 +1,67 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2017
+ * Value wrapper that shares its data between copies until one of them is modified.
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace dev
+{
+
+/**
+ * Holds a value of type T that is shared between copies of the wrapper. Read access is
+ * provided through the dereference operators, write access through write(), which
+ * detaches the value from all other copies first if needed.
+ * A default-constructed wrapper behaves as a default-constructed T and does not allocate.
+ */
+template <class T>
+class CopyOnWrite
+{
+public:
+	T const& operator*() const { return m_data ? *m_data : empty(); }
+	T const* operator->() const { return &operator*(); }
+
+	/// @returns a reference to the value that is not shared with any other copy.
+	T& write()
+	{
+		if (!m_data)
+			m_data = std::make_shared<T>();
+		else if (m_data.use_count() > 1)
+			m_data = std::make_shared<T>(*m_data);
+		return *m_data;
+	}
+	/// Replaces the value without copying the previous one.
+	void assign(T _value) { m_data = std::make_shared<T>(std::move(_value)); }
+	/// Resets the value to a default-constructed T.
+	void reset() { m_data.reset(); }
+
+private:
+	static T const& empty()
+	{
+		static T const s_empty;
+		return s_empty;
+	}
+
+	std::shared_ptr<T> m_data;
+};
+
+}
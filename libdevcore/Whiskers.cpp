@@ -25,16 +25,33 @@
 
 #include <libdevcore/Assertions.h>
 
-#include <boost/regex.hpp>
+#include <mutex>
 
 using namespace std;
 using namespace dev;
 
+/// Parsed form of a template: literal text, tags and list sections in the order they appear.
+struct Whiskers::Template
+{
+	struct Segment
+	{
+		enum class Kind { Text, Tag, List };
+		Kind kind;
+		/// The text itself for text segments, the name of the tag or list otherwise.
+		string value;
+		/// Template of a single item of a list.
+		shared_ptr<Template const> body;
+	};
+
+	/// Template text, for error messages.
+	string source;
+	vector<Segment> segments;
+};
+
 Whiskers::Whiskers(string const& _template):
-m_template(_template)
+m_template(compile(_template))
 {
 }
-
 Whiskers& Whiskers::operator ()(string const& _parameter, string const& _value)
 {
 	assertThrow(
@@ -74,60 +91,149 @@ Whiskers& Whiskers::operator ()(
 
 string Whiskers::render() const
 {
-	return replace(m_template, m_parameters, m_listParameters);
+	vector<Piece> pieces;
+	size_t size = 0;
+	collect(*m_template, m_parameters, &m_listParameters, nullptr, pieces, size);
+
+	string result;
+	result.reserve(size);
+	for (auto const& piece: pieces)
+		result.append(piece.first, piece.second);
+	return result;
+}
+
+shared_ptr<Whiskers::Template const> Whiskers::compile(string const& _template)
+{
+	// The code generator only uses a limited set of templates, but some of them are
+	// assembled at runtime, so the cache is dropped once it grows too large.
+	static size_t const maxCacheSize = 4096;
+	static mutex cacheMutex;
+	static map<string, shared_ptr<Template const>> cache;
+
+	lock_guard<mutex> lock(cacheMutex);
+	auto compiled = cache.find(_template);
+	if (compiled != cache.end())
+		return compiled->second;
+	if (cache.size() >= maxCacheSize)
+		cache.clear();
+	return cache[_template] = parse(_template);
 }
 
-string Whiskers::replace(
-	string const& _template,
+shared_ptr<Whiskers::Template const> Whiskers::parse(string const& _template)
+{
+	// Recognizes exactly what the regular expression
+	//   <([^#/>]+)>|<#([^>]+)>(.*?)</\2>
+	// would match, scanning from left to right. A "<" that does not start a match is text.
+	auto result = make_shared<Template>();
+	result->source = _template;
+	string text;
+	auto addSegment = [&](Template::Segment::Kind _kind, string _value, shared_ptr<Template const> _body)
+	{
+		if (!text.empty())
+			result->segments.push_back(Template::Segment{Template::Segment::Kind::Text, move(text), nullptr});
+		text.clear();
+		result->segments.push_back(Template::Segment{_kind, move(_value), move(_body)});
+	};
+
+	size_t position = 0;
+	while (position < _template.size())
+	{
+		size_t open = _template.find('<', position);
+		if (open == string::npos)
+			break;
+		text += _template.substr(position, open - position);
+		position = open + 1;
+		if (_template.compare(open, 2, "<#") == 0)
+		{
+			size_t nameEnd = _template.find('>', open + 2);
+			if (nameEnd != string::npos && nameEnd > open + 2)
+			{
+				string name = _template.substr(open + 2, nameEnd - open - 2);
+				size_t close = _template.find("</" + name + ">", nameEnd + 1);
+				if (close != string::npos)
+				{
+					addSegment(
+						Template::Segment::Kind::List,
+						name,
+						parse(_template.substr(nameEnd + 1, close - nameEnd - 1))
+					);
+					position = close + name.size() + 3;
+					continue;
+				}
+			}
+		}
+		else
+		{
+			size_t nameEnd = _template.find_first_of("#/>", open + 1);
+			if (nameEnd != string::npos && nameEnd > open + 1 && _template[nameEnd] == '>')
+			{
+				addSegment(Template::Segment::Kind::Tag, _template.substr(open + 1, nameEnd - open - 1), nullptr);
+				position = nameEnd + 1;
+				continue;
+			}
+		}
+		text += '<';
+	}
+	if (position < _template.size())
+		text += _template.substr(position);
+	if (!text.empty())
+		result->segments.push_back(Template::Segment{Template::Segment::Kind::Text, move(text), nullptr});
+	return result;
+}
+
+void Whiskers::collect(
+	Template const& _template,
 	StringMap const& _parameters,
-	map<string, vector<StringMap>> const& _listParameters
+	StringListMap const* _listParameters,
+	StringMap const* _listItem,
+	vector<Piece>& _pieces,
+	size_t& _size
 )
 {
-	using namespace boost;
-	static regex listOrTag("<([^#/>]+)>|<#([^>]+)>(.*?)</\\2>");
-	return regex_replace(_template, listOrTag, [&](match_results<string::const_iterator> _match) -> string
+	for (auto const& segment: _template.segments)
 	{
-		string tagName(_match[1]);
-		if (!tagName.empty())
+		string const* value = &segment.value;
+		switch (segment.kind)
+		{
+		case Template::Segment::Kind::Text:
+			break;
+		case Template::Segment::Kind::Tag:
 		{
+			if (_listItem && _listItem->count(segment.value))
+			{
+				value = &_listItem->at(segment.value);
+				break;
+			}
 			assertThrow(
-				_parameters.count(tagName),
+				_parameters.count(segment.value),
 				WhiskersError,
-				"Value for tag " + tagName + " not provided.\n" +
+				"Value for tag " + segment.value + " not provided.\n" +
 				"Template:\n" +
-				_template
+				_template.source
 			);
-			return _parameters.at(tagName);
+			value = &_parameters.at(segment.value);
+			break;
 		}
-		else
+		case Template::Segment::Kind::List:
 		{
-			string listName(_match[2]);
-			string templ(_match[3]);
-			assertThrow(!listName.empty(), WhiskersError, "");
 			assertThrow(
-				_listParameters.count(listName),
-				WhiskersError, "List parameter " + listName + " not set."
+				_listParameters && _listParameters->count(segment.value),
+				WhiskersError, "List parameter " + segment.value + " not set."
 			);
-			string replacement;
-			for (auto const& parameters: _listParameters.at(listName))
-				replacement += replace(templ, joinMaps(_parameters, parameters));
-			return replacement;
+			for (auto const& item: _listParameters->at(segment.value))
+			{
+				for (auto const& itemParameter: item)
+					assertThrow(
+						!_parameters.count(itemParameter.first),
+						WhiskersError,
+						"Parameter collision"
+					);
+				collect(*segment.body, _parameters, nullptr, &item, _pieces, _size);
+			}
+			continue;
 		}
-	});
-}
-
-Whiskers::StringMap Whiskers::joinMaps(
-	Whiskers::StringMap const& _a,
-	Whiskers::StringMap const& _b
-)
-{
-	Whiskers::StringMap ret = _a;
-	for (auto const& x: _b)
-		assertThrow(
-			ret.insert(x).second,
-			WhiskersError,
-			"Parameter collision"
-		);
-	return ret;
+		}
+		_pieces.push_back(Piece(value->data(), value->size()));
+		_size += value->size();
+	}
 }
-
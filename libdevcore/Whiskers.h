@@ -27,6 +27,7 @@
 
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace dev
@@ -51,6 +52,9 @@ DEV_SIMPLE_EXCEPTION(WhiskersError);
 /// results in s == "HEAD\nkey1 -> value1\nkey2 -> value2\n"
 ///
 /// Note that lists cannot themselves contain lists - this would be a future feature.
+///
+/// Templates are parsed only once per process: the parsed form of each template text is
+/// cached and rendering just concatenates its segments and the parameter values.
 class Whiskers
 {
 public:
@@ -70,16 +74,27 @@ public:
 	std::string render() const;
 
 private:
-	static std::string replace(
-		std::string const& _template,
+	struct Template;
+	/// Piece of the rendered output, referring to the template or to a parameter value.
+	using Piece = std::pair<char const*, size_t>;
+
+	/// @returns the parsed form of @a _template, parsing it only if it is not yet cached.
+	static std::shared_ptr<Template const> compile(std::string const& _template);
+	static std::shared_ptr<Template const> parse(std::string const& _template);
+
+	/// Appends the pieces @a _template renders to with the given parameters to @a _pieces
+	/// and their length to @a _size. @a _listItem, if given, holds the parameters of the
+	/// current list item, which must not collide with @a _parameters.
+	static void collect(
+		Template const& _template,
 		StringMap const& _parameters,
-		StringListMap const& _listParameters = StringListMap()
+		StringListMap const* _listParameters,
+		StringMap const* _listItem,
+		std::vector<Piece>& _pieces,
+		size_t& _size
 	);
 
-	/// Joins the two maps throwing an exception if two keys are equal.
-	static StringMap joinMaps(StringMap const& _a, StringMap const& _b);
-
-	std::string m_template;
+	std::shared_ptr<Template const> m_template;
 	StringMap m_parameters;
 	StringListMap m_listParameters;
 };
@@ -27,15 +27,53 @@
 #include <libevmasm/JumpdestRemover.h>
 #include <libevmasm/BlockDeduplicator.h>
 #include <libevmasm/ConstantOptimiser.h>
+#include <libevmasm/Inliner.h>
 #include <libevmasm/GasMeter.h>
+#include <libevmasm/SemanticInformation.h>
+#include <libevmasm/SimplificationRules.h>
 
 #include <fstream>
+#include <functional>
+#include <unordered_set>
 #include <json/json.h>
 
+#include <boost/functional/hash.hpp>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+namespace
+{
+
+struct AssemblyItemsHash
+{
+	size_t operator()(AssemblyItems const& _items) const
+	{
+		size_t seed = _items.size();
+		for (AssemblyItem const& item: _items)
+		{
+			boost::hash_combine(seed, item.hash());
+			// Source locations are interned, so their addresses identify them.
+			boost::hash_combine(seed, &item.location());
+			boost::hash_combine(seed, unsigned(item.getJumpType()));
+		}
+		return seed;
+	}
+};
+
+struct AssemblyItemsIdentical
+{
+	bool operator()(AssemblyItems const& _a, AssemblyItems const& _b) const
+	{
+		return _a.size() == _b.size() && equal(_a.begin(), _a.end(), _b.begin(),
+			[](AssemblyItem const& _x, AssemblyItem const& _y) { return _x.isIdenticalTo(_y); }
+		);
+	}
+};
+
+}
+
 void Assembly::append(Assembly const& _a)
 {
 	auto newDeposit = m_deposit + _a.deposit();
@@ -217,6 +255,48 @@ string Assembly::assemblyString(StringMap const& _sourceCodes) const
 	return tmp.str();
 }
 
+string Assembly::optimiserReport() const
+{
+	ostringstream out;
+	map<size_t, size_t> simplifications;
+	function<void(Assembly const&, string const&)> report = [&](Assembly const& _assembly, string const& _prefix)
+	{
+		for (size_t i = 0; i < _assembly.m_optimiserIterations.size(); ++i)
+		{
+			OptimiserIteration const& iteration = _assembly.m_optimiserIterations[i];
+			size_t iterationSimplifications = 0;
+			for (auto const& rule: iteration.simplifications)
+			{
+				simplifications[rule.first] += rule.second;
+				iterationSimplifications += rule.second;
+			}
+			out <<
+				_prefix << "iteration " << (i + 1) << ": " <<
+				iteration.itemsBefore << " -> " << iteration.itemsAfter << " items, " <<
+				iteration.changes << " changes, " <<
+				iteration.passesRun << " passes run, " <<
+				iteration.passesSkipped << " skipped, " <<
+				iteration.cseChunks << " CSE chunks (" <<
+				iteration.cseChunksReused << " reused, " <<
+				iteration.cseChunksReplaced << " replaced), " <<
+				iterationSimplifications << " simplifications" << endl;
+		}
+		for (size_t i = 0; i < _assembly.m_subs.size(); ++i)
+		{
+			out << _prefix << "sub " << i << ":" << endl;
+			report(*_assembly.m_subs[i], _prefix + "    ");
+		}
+	};
+	report(*this, "");
+	if (!simplifications.empty())
+	{
+		out << "simplification rules applied:" << endl;
+		for (auto const& rule: simplifications)
+			out << "    " << rule.second << " x " << Rules::standard().ruleDescription(rule.first) << endl;
+	}
+	return out.str();
+}
+
 Json::Value Assembly::createJsonValue(string _name, int _begin, int _end, string _value, string _jumpType)
 {
 	Json::Value value;
@@ -264,7 +344,7 @@ Json::Value Assembly::assemblyJSON(StringMap const& _sourceCodes) const
 					createJsonValue("PUSH [ErrorTag]", i.location().start, i.location().end, ""));
 			else
 				collection.append(
-					createJsonValue("PUSH [tag]", i.location().start, i.location().end, string(i.data())));
+					createJsonValue("PUSH [tag]", i.location().start, i.location().end, i.data().str()));
 			break;
 		case PushSub:
 			collection.append(
@@ -285,7 +365,7 @@ Json::Value Assembly::assemblyJSON(StringMap const& _sourceCodes) const
 			break;
 		case Tag:
 			collection.append(
-				createJsonValue("tag", i.location().start, i.location().end, string(i.data())));
+				createJsonValue("tag", i.location().start, i.location().end, i.data().str()));
 			collection.append(
 				createJsonValue("JUMPDEST", i.location().start, i.location().end));
 			break;
@@ -357,6 +437,7 @@ Assembly& Assembly::optimise(bool _enable, bool _isCreation, size_t _runs)
 	if (_enable)
 	{
 		settings.runDeduplicate = true;
+		settings.runInliner = true;
 		settings.runCSE = true;
 		settings.runConstantOptimiser = true;
 	}
@@ -377,6 +458,7 @@ map<u256, u256> Assembly::optimiseInternal(
 	std::set<size_t> const& _tagsReferencedFromOutside
 )
 {
+	AssemblyItemTables::Scope itemScope(m_itemTables);
 	// Run optimisation for sub-assemblies.
 	for (size_t subId = 0; subId < m_subs.size(); ++subId)
 	{
@@ -392,59 +474,131 @@ map<u256, u256> Assembly::optimiseInternal(
 	}
 
 	map<u256, u256> tagReplacements;
+	m_optimiserIterations.clear();
+
+	// All passes are deterministic and only depend on the items, so a pass that did not find
+	// anything to optimise will not find anything until another pass modified the items.
+	// For each pass, this records the value of `modifications` at the point where it last
+	// ran without finding anything.
+	size_t modifications = 0;
+	size_t const neverClean = size_t(-1);
+	size_t jumpdestRemoverClean = neverClean;
+	size_t peepholeClean = neverClean;
+	size_t deduplicatorClean = neverClean;
+	size_t inlinerClean = neverClean;
+	size_t cseClean = neverClean;
+	// The common subexpression eliminator analyses each chunk starting from an empty state,
+	// so its result only depends on the items of the chunk itself. Chunks that were not
+	// replaced are remembered, so that only new or modified chunks are analysed again.
+	unordered_set<AssemblyItems, AssemblyItemsHash, AssemblyItemsIdentical> stableChunks;
+
 	// Iterate until no new optimisation possibilities are found.
 	for (unsigned count = 1; count > 0;)
 	{
 		count = 0;
+		OptimiserIteration iteration;
+		iteration.itemsBefore = m_items.size();
+		auto shouldRun = [&](bool _enabled, size_t _clean) -> bool
+		{
+			if (!_enabled)
+				return false;
+			if (_clean == modifications)
+			{
+				iteration.passesSkipped++;
+				return false;
+			}
+			iteration.passesRun++;
+			return true;
+		};
 
-		if (_settings.runJumpdestRemover)
+		if (shouldRun(_settings.runJumpdestRemover, jumpdestRemoverClean))
 		{
 			JumpdestRemover jumpdestOpt(m_items);
 			if (jumpdestOpt.optimise(_tagsReferencedFromOutside))
+			{
 				count++;
+				modifications++;
+			}
+			else
+				jumpdestRemoverClean = modifications;
 		}
 
-		if (_settings.runPeephole)
+		if (shouldRun(_settings.runPeephole, peepholeClean))
 		{
+			// The peephole optimiser does not stop before all its rules are exhausted.
 			PeepholeOptimiser peepOpt(m_items);
-			while (peepOpt.optimise())
+			if (peepOpt.optimise())
 			{
 				count++;
-				assertThrow(count < 64000, OptimizerException, "Peephole optimizer seems to be stuck.");
+				modifications++;
 			}
+			peepholeClean = modifications;
 		}
 
 		// This only modifies PushTags, we have to run again to actually remove code.
-		if (_settings.runDeduplicate)
+		if (shouldRun(_settings.runDeduplicate, deduplicatorClean))
 		{
 			BlockDeduplicator dedup(m_items);
 			if (dedup.deduplicate())
 			{
 				tagReplacements.insert(dedup.replacedTags().begin(), dedup.replacedTags().end());
 				count++;
+				modifications++;
+			}
+			else
+				deduplicatorClean = modifications;
+		}
+
+		// The common subexpression eliminator removes the return addresses of inlined calls.
+		if (shouldRun(_settings.runInliner, inlinerClean))
+		{
+			Inliner inliner(
+				m_items,
+				_settings.isCreation ? 1 : _settings.expectedExecutionsPerDeployment,
+				_settings.isCreation
+			);
+			if (inliner.optimise(_tagsReferencedFromOutside))
+			{
+				count++;
+				modifications++;
 			}
+			else
+				inlinerClean = modifications;
 		}
 
-		if (_settings.runCSE)
+		if (shouldRun(_settings.runCSE, cseClean))
 		{
 			// Control flow graph optimization has been here before but is disabled because it
 			// assumes we only jump to tags that are pushed. This is not the case anymore with
 			// function types that can be stored in storage.
 			AssemblyItems optimisedItems;
+			optimisedItems.reserve(m_items.size());
 
 			auto iter = m_items.begin();
 			while (iter != m_items.end())
 			{
-				KnownState emptyState;
-				CommonSubexpressionEliminator eliminator(emptyState);
 				auto orig = iter;
-				iter = eliminator.feedItems(iter, m_items.end());
+				iter = find_if(iter, m_items.end(), SemanticInformation::breaksCSEAnalysisBlock);
+				if (iter != m_items.end())
+					++iter;
+				iteration.cseChunks++;
+				AssemblyItems chunk(orig, iter);
+				if (stableChunks.count(chunk))
+				{
+					iteration.cseChunksReused++;
+					optimisedItems += chunk;
+					continue;
+				}
+
+				KnownState emptyState;
+				CommonSubexpressionEliminator eliminator(emptyState, &iteration.simplifications);
+				eliminator.feedItems(chunk.cbegin(), chunk.cend());
 				bool shouldReplace = false;
 				AssemblyItems optimisedChunk;
 				try
 				{
 					optimisedChunk = eliminator.getOptimizedItems();
-					shouldReplace = (optimisedChunk.size() < size_t(iter - orig));
+					shouldReplace = (optimisedChunk.size() < chunk.size());
 				}
 				catch (StackTooDeepException const&)
 				{
@@ -460,17 +614,28 @@ map<u256, u256> Assembly::optimiseInternal(
 				if (shouldReplace)
 				{
 					count++;
+					iteration.cseChunksReplaced++;
 					optimisedItems += optimisedChunk;
 				}
 				else
-					copy(orig, iter, back_inserter(optimisedItems));
+				{
+					optimisedItems += chunk;
+					stableChunks.insert(move(chunk));
+				}
 			}
 			if (optimisedItems.size() < m_items.size())
 			{
 				m_items = move(optimisedItems);
 				count++;
+				modifications++;
 			}
+			else
+				cseClean = modifications;
 		}
+
+		iteration.changes = count;
+		iteration.itemsAfter = m_items.size();
+		m_optimiserIterations.push_back(iteration);
 	}
 
 	if (_settings.runConstantOptimiser)
@@ -489,6 +654,7 @@ LinkerObject const& Assembly::assemble() const
 	if (!m_assembledObject.bytecode.empty())
 		return m_assembledObject;
 
+	AssemblyItemTables::Scope itemScope(m_itemTables);
 	size_t subTagSize = 1;
 	for (auto const& sub: m_subs)
 	{
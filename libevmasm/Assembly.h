@@ -105,6 +105,7 @@ public:
 		bool runJumpdestRemover = false;
 		bool runPeephole = false;
 		bool runDeduplicate = false;
+		bool runInliner = false;
 		bool runCSE = false;
 		bool runConstantOptimiser = false;
 		/// This specifies an estimate on how often each opcode in this assembly will be executed,
@@ -112,6 +113,24 @@ public:
 		size_t expectedExecutionsPerDeployment = 200;
 	};
 
+	/// Statistics about one iteration of the optimiser loop.
+	struct OptimiserIteration
+	{
+		size_t itemsBefore = 0;
+		size_t itemsAfter = 0;
+		/// Number of optimisations found, the loop stops after the first iteration without any.
+		unsigned changes = 0;
+		unsigned passesRun = 0;
+		/// Passes that were not run because the items did not change since they last found nothing.
+		unsigned passesSkipped = 0;
+		size_t cseChunks = 0;
+		/// CSE chunks that were not analysed because they are already known not to improve.
+		size_t cseChunksReused = 0;
+		size_t cseChunksReplaced = 0;
+		/// Number of applications of each simplification rule during this iteration, by rule index.
+		std::map<size_t, size_t> simplifications;
+	};
+
 	/// Execute optimisation passes as defined by @a _settings and return the optimised assembly.
 	Assembly& optimise(OptimiserSettings const& _settings);
 
@@ -122,6 +141,11 @@ public:
 	/// If @a _enable is not set, will perform some simple peephole optimizations.
 	Assembly& optimise(bool _enable, bool _isCreation = true, size_t _runs = 200);
 
+	/// @returns the statistics of the last optimiser run on this assembly (excluding sub-assemblies).
+	std::vector<OptimiserIteration> const& optimiserIterations() const { return m_optimiserIterations; }
+	/// @returns a text report of the optimiser statistics of this assembly and its sub-assemblies.
+	std::string optimiserReport() const;
+
 	/// Create a text representation of the assembly.
 	std::string assemblyString(
 		StringMap const& _sourceCodes = StringMap()
@@ -158,6 +182,7 @@ protected:
 	/// Data that is appended to the very end of the contract.
 	bytes m_auxiliaryData;
 	std::vector<std::shared_ptr<Assembly>> m_subs;
+	std::vector<OptimiserIteration> m_optimiserIterations;
 	std::map<h256, std::string> m_strings;
 	std::map<h256, std::string> m_libraries; ///< Identifiers of libraries to be linked.
 
@@ -167,6 +192,8 @@ protected:
 	int m_deposit = 0;
 
 	SourceLocation m_currentSourceLocation;
+	/// Tables the items of this assembly are interned in, kept alive as long as the assembly.
+	std::shared_ptr<AssemblyItemTables> m_itemTables = AssemblyItemTables::current().shared_from_this();
 };
 
 inline std::ostream& operator<<(std::ostream& _out, Assembly const& _a)
@@ -20,12 +20,205 @@
 #include <libdevcore/CommonData.h>
 #include <libdevcore/FixedHash.h>
 
+#include <boost/functional/hash.hpp>
+
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+namespace
+{
+
+struct U256Hash
+{
+	size_t operator()(u256 const& _value) const
+	{
+		auto const& backend = _value.backend();
+		return boost::hash_range(backend.limbs(), backend.limbs() + backend.size());
+	}
+};
+
+/// Tables that are current on the calling thread, if any scope is active.
+thread_local AssemblyItemTables* s_currentTables = nullptr;
+
+}
+
+namespace dev
+{
+namespace eth
+{
+
+/// Pool of the values that do not fit into an assembly item.
+class ConstantPool
+{
+public:
+	u256 const* intern(u256 const& _value)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		// Elements of an unordered_set are not moved on rehash.
+		return &*m_values.insert(_value).first;
+	}
+
+	size_t size()
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return m_values.size();
+	}
+
+private:
+	mutex m_mutex;
+	unordered_set<u256, U256Hash> m_values;
+};
+
+/// Table of the source locations of assembly items. Source names are interned by their contents.
+/// Entries are never moved, so that items can refer to them without locking.
+class LocationTable
+{
+public:
+	SourceLocation const* intern(SourceLocation const& _location)
+	{
+		if (_location.start == -1 && _location.end == -1 && !_location.sourceName)
+			return nullptr;
+
+		lock_guard<mutex> lock(m_mutex);
+		// Consecutive items mostly share their location and source name.
+		if (_location.sourceName != m_lastSourceName)
+		{
+			m_lastSourceName = _location.sourceName;
+			m_lastName = nullptr;
+			if (_location.sourceName)
+				m_lastName = &m_names.insert(make_pair(*_location.sourceName, _location.sourceName)).first->second;
+		}
+		Key key{_location.start, _location.end, m_lastName ? m_lastName->get() : nullptr};
+		if (key == m_lastKey)
+			return m_lastLocation;
+
+		auto inserted = m_locations.insert(make_pair(key, nullptr));
+		if (inserted.second)
+		{
+			// Elements of a deque are not moved when appending.
+			m_entries.emplace_back(
+				_location.start,
+				_location.end,
+				m_lastName ? *m_lastName : shared_ptr<string const>()
+			);
+			inserted.first->second = &m_entries.back();
+		}
+		m_lastKey = key;
+		m_lastLocation = inserted.first->second;
+		return m_lastLocation;
+	}
+
+	size_t size()
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return m_entries.size();
+	}
+
+private:
+	struct Key
+	{
+		int start;
+		int end;
+		string const* sourceName; ///< Interned source name.
+		bool operator==(Key const& _other) const
+		{
+			return start == _other.start && end == _other.end && sourceName == _other.sourceName;
+		}
+	};
+	struct KeyHash
+	{
+		size_t operator()(Key const& _key) const
+		{
+			size_t seed = 0;
+			boost::hash_combine(seed, _key.start);
+			boost::hash_combine(seed, _key.end);
+			boost::hash_combine(seed, _key.sourceName);
+			return seed;
+		}
+	};
+
+	mutex m_mutex;
+	deque<SourceLocation> m_entries;
+	unordered_map<string, shared_ptr<string const>> m_names;
+	unordered_map<Key, SourceLocation const*, KeyHash> m_locations;
+	shared_ptr<string const> m_lastSourceName;
+	shared_ptr<string const> const* m_lastName = nullptr;
+	Key m_lastKey{-1, -1, nullptr};
+	SourceLocation const* m_lastLocation = nullptr;
+};
+
+}
+}
+
+AssemblyItemTables::Scope::Scope(shared_ptr<AssemblyItemTables> _tables):
+	m_tables(move(_tables)),
+	m_previous(s_currentTables)
+{
+	s_currentTables = m_tables.get();
+}
+
+AssemblyItemTables::Scope::~Scope()
+{
+	s_currentTables = m_previous;
+}
+
+AssemblyItemTables::AssemblyItemTables():
+	m_constants(new ConstantPool()),
+	m_locations(new LocationTable())
+{
+}
+
+AssemblyItemTables::~AssemblyItemTables()
+{
+}
+
+AssemblyItemTables& AssemblyItemTables::current()
+{
+	if (s_currentTables)
+		return *s_currentTables;
+	static shared_ptr<AssemblyItemTables> processTables = make_shared<AssemblyItemTables>();
+	return *processTables;
+}
+
+u256 const* AssemblyItemTables::internConstant(u256 const& _value)
+{
+	return m_constants->intern(_value);
+}
+
+SourceLocation const* AssemblyItemTables::internLocation(SourceLocation const& _location)
+{
+	return m_locations->intern(_location);
+}
+
+size_t AssemblyItemTables::constantCount() const
+{
+	return m_constants->size();
+}
+
+size_t AssemblyItemTables::locationCount() const
+{
+	return m_locations->size();
+}
+
+SourceLocation const AssemblyItem::s_emptyLocation;
+
+u256 const* AssemblyItem::internConstant(u256 const& _value)
+{
+	return AssemblyItemTables::current().internConstant(_value);
+}
+
+SourceLocation const* AssemblyItem::internLocation(SourceLocation const& _location)
+{
+	return AssemblyItemTables::current().internLocation(_location);
+}
+
 AssemblyItem AssemblyItem::toSubAssemblyTag(size_t _subId) const
 {
 	assertThrow(data() < (u256(1) << 64), Exception, "Tag already has subassembly set.");
@@ -49,6 +242,20 @@ void AssemblyItem::setPushTagSubIdAndTag(size_t _subId, size_t _tag)
 	setData(_tag + (u256(_subId + 1) << 64));
 }
 
+size_t AssemblyItem::hash() const
+{
+	size_t seed = 0;
+	boost::hash_combine(seed, unsigned(m_type));
+	if (m_type == Operation)
+		boost::hash_combine(seed, unsigned(m_instruction));
+	else if (m_wideData)
+		// Equal values from different tables have different addresses.
+		boost::hash_combine(seed, U256Hash()(*m_data.wide));
+	else
+		boost::hash_combine(seed, m_data.small);
+	return seed;
+}
+
 unsigned AssemblyItem::bytesRequired(unsigned _addressLength) const
 {
 	switch (m_type)
@@ -23,11 +23,14 @@
 
 #include <iostream>
 #include <sstream>
+#include <limits>
 #include <libdevcore/Common.h>
 #include <libdevcore/Assertions.h>
 #include <libevmasm/Instruction.h>
 #include <libevmasm/SourceLocation.h>
 #include "Exceptions.h"
+#include <boost/noncopyable.hpp>
+#include <memory>
 using namespace dev::solidity;
 
 namespace dev
@@ -35,7 +38,7 @@ namespace dev
 namespace eth
 {
 
-enum AssemblyItemType {
+enum AssemblyItemType: uint8_t {
 	UndefinedItem,
 	Operation,
 	Push,
@@ -50,27 +53,78 @@ enum AssemblyItemType {
 };
 
 class Assembly;
+class ConstantPool;
+class LocationTable;
 
+/**
+ * The wide constants and source locations assembly items refer to. Items are interned in the
+ * tables that are current on their thread when they are created (@see Scope), so those tables
+ * have to outlive them. Every Assembly keeps the tables it was created with alive, and a
+ * compilation makes tables of its own current, so that they are released together with its
+ * assemblies. Items created outside of any scope use tables that live as long as the process.
+ */
+class AssemblyItemTables: public std::enable_shared_from_this<AssemblyItemTables>, private boost::noncopyable
+{
+public:
+	/// Makes tables the current ones of the calling thread for the lifetime of the scope object.
+	class Scope: private boost::noncopyable
+	{
+	public:
+		explicit Scope(std::shared_ptr<AssemblyItemTables> _tables);
+		~Scope();
+
+	private:
+		std::shared_ptr<AssemblyItemTables> m_tables;
+		AssemblyItemTables* m_previous;
+	};
+
+	AssemblyItemTables();
+	~AssemblyItemTables();
+
+	/// @returns the tables new items are interned in on the calling thread.
+	static AssemblyItemTables& current();
+
+	/// @returns a pointer to the pooled copy of @a _value, which stays valid as long as the tables.
+	u256 const* internConstant(u256 const& _value);
+	/// @returns a pointer to the interned copy of @a _location, or nullptr for the empty location.
+	SourceLocation const* internLocation(SourceLocation const& _location);
+
+	/// @returns the number of distinct wide values in the constant pool.
+	size_t constantCount() const;
+	/// @returns the number of distinct source locations in the location table.
+	size_t locationCount() const;
+
+private:
+	std::unique_ptr<ConstantPool> m_constants;
+	std::unique_ptr<LocationTable> m_locations;
+};
+
+/**
+ * A single item of an assembly: an instruction, a push or a tag.
+ * Items are small and trivially copyable: Data that fits 64 bits is stored inline, wider values
+ * and source locations are interned in the current AssemblyItemTables, so that neither copying
+ * nor destroying items touches the heap.
+ */
 class AssemblyItem
 {
 public:
-	enum class JumpType { Ordinary, IntoFunction, OutOfFunction };
+	enum class JumpType: uint8_t { Ordinary, IntoFunction, OutOfFunction };
 
-	AssemblyItem(u256 _push, SourceLocation const& _location = SourceLocation()):
+	AssemblyItem(u256 const& _push, SourceLocation const& _location = SourceLocation()):
 		AssemblyItem(Push, _push, _location) { }
 	AssemblyItem(solidity::Instruction _i, SourceLocation const& _location = SourceLocation()):
 		m_type(Operation),
 		m_instruction(_i),
-		m_location(_location)
+		m_location(internLocation(_location))
 	{}
-	AssemblyItem(AssemblyItemType _type, u256 _data = 0, SourceLocation const& _location = SourceLocation()):
+	AssemblyItem(AssemblyItemType _type, u256 const& _data = 0, SourceLocation const& _location = SourceLocation()):
 		m_type(_type),
-		m_location(_location)
+		m_location(internLocation(_location))
 	{
 		if (m_type == Operation)
 			m_instruction = Instruction(byte(_data));
 		else
-			m_data = std::make_shared<u256>(_data);
+			setData(_data);
 	}
 
 	AssemblyItem tag() const { assertThrow(m_type == PushTag || m_type == Tag, Exception, ""); return AssemblyItem(Tag, data()); }
@@ -85,8 +139,20 @@ public:
 	void setPushTagSubIdAndTag(size_t _subId, size_t _tag);
 
 	AssemblyItemType type() const { return m_type; }
-	u256 const& data() const { assertThrow(m_type != Operation, Exception, ""); return *m_data; }
-	void setData(u256 const& _data) { assertThrow(m_type != Operation, Exception, ""); m_data = std::make_shared<u256>(_data); }
+	u256 data() const
+	{
+		assertThrow(m_type != Operation, Exception, "");
+		return m_wideData ? *m_data.wide : u256(m_data.small);
+	}
+	void setData(u256 const& _data)
+	{
+		assertThrow(m_type != Operation, Exception, "");
+		m_wideData = _data > std::numeric_limits<uint64_t>::max();
+		if (m_wideData)
+			m_data.wide = internConstant(_data);
+		else
+			m_data.small = uint64_t(_data);
+	}
 
 	/// @returns the instruction of this item (only valid if type() == Operation)
 	Instruction instruction() const { assertThrow(m_type == Operation, Exception, ""); return m_instruction; }
@@ -98,8 +164,12 @@ public:
 			return false;
 		if (type() == Operation)
 			return instruction() == _other.instruction();
-		else
-			return data() == _other.data();
+		// Wide values are interned, so equal values from the same tables have equal addresses.
+		return m_wideData == _other.m_wideData && (
+			m_wideData ?
+				m_data.wide == _other.m_data.wide || *m_data.wide == *_other.m_data.wide :
+				m_data.small == _other.m_data.small
+		);
 	}
 	bool operator!=(AssemblyItem const& _other) const { return !operator==(_other); }
 	/// Less-than operator compatible with operator==.
@@ -109,10 +179,25 @@ public:
 			return type() < _other.type();
 		else if (type() == Operation)
 			return instruction() < _other.instruction();
+		else if (m_wideData != _other.m_wideData)
+			return _other.m_wideData;
+		else if (m_wideData)
+			return m_data.wide != _other.m_data.wide && *m_data.wide < *_other.m_data.wide;
 		else
-			return data() < _other.data();
+			return m_data.small < _other.m_data.small;
 	}
 
+	/// @returns true if the items are equal and also have the same source location and jump type.
+	bool isIdenticalTo(AssemblyItem const& _other) const
+	{
+		return
+			*this == _other &&
+			(m_location == _other.m_location || location() == _other.location()) &&
+			m_jumpType == _other.m_jumpType;
+	}
+	/// @returns a hash value that is compatible with operator==.
+	size_t hash() const;
+
 	/// @returns an upper bound for the number of bytes required by this item, assuming that
 	/// the value of a jump tag takes @a _addressLength bytes.
 	unsigned bytesRequired(unsigned _addressLength) const;
@@ -123,27 +208,37 @@ public:
 	/// @returns true if the assembly item can be used in a functional context.
 	bool canBeFunctional() const;
 
-	void setLocation(SourceLocation const& _location) { m_location = _location; }
-	SourceLocation const& location() const { return m_location; }
+	void setLocation(SourceLocation const& _location) { m_location = internLocation(_location); }
+	SourceLocation const& location() const { return m_location ? *m_location : s_emptyLocation; }
 
 	void setJumpType(JumpType _jumpType) { m_jumpType = _jumpType; }
 	JumpType getJumpType() const { return m_jumpType; }
 	std::string getJumpTypeAsString() const;
 
-	void setPushedValue(u256 const& _value) const { m_pushedValue = std::make_shared<u256>(_value); }
-	u256 const* pushedValue() const { return m_pushedValue.get(); }
+	void setPushedValue(u256 const& _value) const { m_pushedValue = internConstant(_value); }
+	u256 const* pushedValue() const { return m_pushedValue; }
 
 	std::string toAssemblyText() const;
 
 private:
+	static u256 const* internConstant(u256 const& _value);
+	static SourceLocation const* internLocation(SourceLocation const& _location);
+
+	static SourceLocation const s_emptyLocation;
+
 	AssemblyItemType m_type;
 	Instruction m_instruction; ///< Only valid if m_type == Operation
-	std::shared_ptr<u256> m_data; ///< Only valid if m_type != Operation
-	SourceLocation m_location;
 	JumpType m_jumpType = JumpType::Ordinary;
+	bool m_wideData = false; ///< Whether m_data refers to the constant pool.
+	SourceLocation const* m_location = nullptr; ///< Interned location, nullptr if empty.
+	union
+	{
+		uint64_t small;
+		u256 const* wide;
+	} m_data = {0}; ///< Only valid if m_type != Operation
 	/// Pushed value for operations with data to be determined during assembly stage,
-	/// e.g. PushSubSize, PushTag, PushSub, etc.
-	mutable std::shared_ptr<u256> m_pushedValue;
+	/// e.g. PushSubSize, PushTag, PushSub, etc. Points into the constant pool.
+	mutable u256 const* m_pushedValue = nullptr;
 };
 
 using AssemblyItems = std::vector<AssemblyItem>;
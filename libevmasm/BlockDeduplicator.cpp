@@ -26,8 +26,10 @@
 #include <libevmasm/AssemblyItem.h>
 #include <libevmasm/SemanticInformation.h>
 
+#include <boost/functional/hash.hpp>
+
 #include <functional>
-#include <set>
+#include <unordered_map>
 
 using namespace std;
 using namespace dev;
@@ -36,8 +38,10 @@ using namespace dev::eth;
 
 bool BlockDeduplicator::deduplicate()
 {
-	// Compares indices based on the suffix that starts there, ignoring tags and stopping at
+	// Compares blocks based on the suffix that starts at their tag, ignoring tags and stopping at
 	// opcodes that stop the control flow.
+	// Candidates for equal blocks are found through a polynomial hash over their items, so that
+	// only blocks with equal hashes have to be compared item by item.
 
 	// Virtual tag that signifies "the current block" and which is used to optimise loops.
 	// We abort if this virtual tag actually exists.
@@ -48,45 +52,78 @@ bool BlockDeduplicator::deduplicate()
 	)
 		return false;
 
-	function<bool(size_t, size_t)> comparator = [&](size_t _i, size_t _j)
-	{
-		if (_i == _j)
-			return false;
-
-		// To compare recursive loops, we have to already unify PushTag opcodes of the
-		// block's own tag.
-		AssemblyItem pushFirstTag(pushSelf);
-		AssemblyItem pushSecondTag(pushSelf);
-
-		if (_i < m_items.size() && m_items.at(_i).type() == Tag)
-			pushFirstTag = m_items.at(_i).pushTag();
-		if (_j < m_items.size() && m_items.at(_j).type() == Tag)
-			pushSecondTag = m_items.at(_j).pushTag();
-
-		BlockIterator first(m_items.begin() + _i, m_items.end(), &pushFirstTag, &pushSelf);
-		BlockIterator second(m_items.begin() + _j, m_items.end(), &pushSecondTag, &pushSelf);
-		BlockIterator end(m_items.end(), m_items.end());
-
-		if (first != end && (*first).type() == Tag)
-			++first;
-		if (second != end && (*second).type() == Tag)
-			++second;
-
-		return std::lexicographical_compare(first, end, second, end);
-	};
+	uint64_t const base = 0x100000001b3;
+	using ItemHash = std::function<size_t(AssemblyItem const&)>;
+	ItemHash itemHash = [](AssemblyItem const& _item) { return _item.hash(); };
 
 	size_t iterations = 0;
 	for (; ; ++iterations)
 	{
-		//@todo this should probably be optimized.
-		set<size_t, function<bool(size_t, size_t)>> blocksSeen(comparator);
-		for (size_t i = 0; i < m_items.size(); ++i)
+		size_t const size = m_items.size();
+		// Tags are not part of blocks, so positions in the hash sequence are counted in non-tag
+		// items: rank[i] is the number of non-tag items before position i and prefixHash[r] the
+		// hash of the first r non-tag items.
+		vector<size_t> rank(size + 1);
+		vector<uint64_t> prefixHash{0};
+		vector<uint64_t> powers{1};
+		prefixHash.reserve(size + 1);
+		powers.reserve(size + 1);
+		// Ranks of the pushes of each tag, used to unify pushes of a block's own tag.
+		unordered_map<AssemblyItem, vector<size_t>, ItemHash> tagPushes(0, itemHash);
+		for (size_t i = 0; i < size; ++i)
 		{
-			if (m_items.at(i).type() != Tag)
+			rank[i] = prefixHash.size() - 1;
+			AssemblyItem const& item = m_items[i];
+			if (item.type() == Tag)
 				continue;
-			auto it = blocksSeen.find(i);
-			if (it == blocksSeen.end())
-				blocksSeen.insert(i);
+			if (item.type() == PushTag)
+				tagPushes[item].push_back(rank[i]);
+			prefixHash.push_back(prefixHash.back() * base + item.hash());
+			powers.push_back(powers.back() * base);
+		}
+		rank[size] = prefixHash.size() - 1;
+
+		// blockEnd[i] is the rank after the last item of the block that contains position i.
+		vector<size_t> blockEnd(size + 1);
+		blockEnd[size] = rank[size];
+		for (size_t i = size; i-- > 0;)
+		{
+			AssemblyItem const& item = m_items[i];
+			if (
+				item.type() != Tag &&
+				SemanticInformation::altersControlFlow(item) &&
+				item != AssemblyItem(Instruction::JUMPI)
+			)
+				blockEnd[i] = rank[i] + 1;
+			else
+				blockEnd[i] = blockEnd[i + 1];
+		}
+
+		uint64_t const selfHash = pushSelf.hash();
+		// Blocks by hash and length, only the first block of every class of equal blocks is stored.
+		unordered_map<pair<uint64_t, size_t>, vector<size_t>, boost::hash<pair<uint64_t, size_t>>> blocksSeen;
+		for (size_t i = 0; i < size; ++i)
+		{
+			if (m_items[i].type() != Tag)
+				continue;
+			size_t begin = rank[i];
+			size_t end = blockEnd[i];
+			uint64_t hash = prefixHash[end] - prefixHash[begin] * powers[end - begin];
+			auto pushes = tagPushes.find(m_items[i].pushTag());
+			if (pushes != tagPushes.end())
+			{
+				uint64_t correction = selfHash - uint64_t(pushes->first.hash());
+				for (size_t pushRank: pushes->second)
+					if (begin <= pushRank && pushRank < end)
+						hash += correction * powers[end - 1 - pushRank];
+			}
+
+			vector<size_t>& candidates = blocksSeen[make_pair(hash, end - begin)];
+			auto it = find_if(candidates.begin(), candidates.end(), [&](size_t _j) {
+				return sameBlock(_j, i, pushSelf);
+			});
+			if (it == candidates.end())
+				candidates.push_back(i);
 			else
 				m_replacedTags[m_items.at(i).data()] = m_items.at(*it).data();
 		}
@@ -144,3 +181,23 @@ AssemblyItem const& BlockDeduplicator::BlockIterator::operator*() const
 	else
 		return *it;
 }
+
+bool BlockDeduplicator::sameBlock(size_t _i, size_t _j, AssemblyItem const& _pushSelf) const
+{
+	// To compare recursive loops, we have to already unify PushTag opcodes of the
+	// block's own tag.
+	AssemblyItem pushFirstTag = m_items.at(_i).pushTag();
+	AssemblyItem pushSecondTag = m_items.at(_j).pushTag();
+
+	BlockIterator first(m_items.begin() + _i, m_items.end(), &pushFirstTag, &_pushSelf);
+	BlockIterator second(m_items.begin() + _j, m_items.end(), &pushSecondTag, &_pushSelf);
+	BlockIterator end(m_items.end(), m_items.end());
+
+	// Skip the tags themselves.
+	++first;
+	++second;
+	for (; first != end && second != end; ++first, ++second)
+		if (*first != *second)
+			return false;
+	return first == end && second == end;
+}
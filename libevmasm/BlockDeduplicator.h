@@ -85,6 +85,10 @@ private:
 		AssemblyItem const* replaceWith;
 	};
 
+	/// @returns true if the blocks starting at the tags at positions @a _i and @a _j have the same
+	/// content, where pushes of their own tags are replaced by @a _pushSelf.
+	bool sameBlock(size_t _i, size_t _j, AssemblyItem const& _pushSelf) const;
+
 	std::map<u256, u256> m_replacedTags;
 	AssemblyItems& m_items;
 };
@@ -33,6 +33,10 @@ using namespace dev::eth;
 
 vector<AssemblyItem> CommonSubexpressionEliminator::getOptimizedItems()
 {
+	ExpressionClasses& classes = m_state.expressionClasses();
+	classes.countRuleHits(m_ruleHits);
+	ScopeGuard stopCounting([&]() { classes.countRuleHits(nullptr); });
+
 	optimizeBreakingItem();
 
 	KnownState nextInitialState = m_state;
@@ -266,8 +270,8 @@ void CSECodeGenerator::addDependencies(Id _c)
 				Id length = expr.arguments.at(1);
 				AssemblyItem offsetInstr(Instruction::SUB, expr.item->location());
 				Id offsetToStart = m_expressionClasses.find(offsetInstr, {slot, slotToLoadFrom});
-				u256 const* o = m_expressionClasses.knownConstant(offsetToStart);
-				u256 const* l = m_expressionClasses.knownConstant(length);
+				boost::optional<u256> o = m_expressionClasses.knownConstant(offsetToStart);
+				boost::optional<u256> l = m_expressionClasses.knownConstant(length);
 				if (l && *l == 0)
 					knownToBeIndependent = true;
 				else if (o)
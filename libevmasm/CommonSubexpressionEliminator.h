@@ -61,7 +61,12 @@ public:
 	using Id = ExpressionClasses::Id;
 	using StoreOperation = KnownState::StoreOperation;
 
-	explicit CommonSubexpressionEliminator(KnownState const& _state): m_initialState(_state), m_state(_state) {}
+	/// @param _ruleHits if given, counts the applications of simplification rules (by rule index).
+	explicit CommonSubexpressionEliminator(
+		KnownState const& _state,
+		std::map<size_t, size_t>* _ruleHits = nullptr
+	):
+		m_initialState(_state), m_state(_state), m_ruleHits(_ruleHits) {}
 
 	/// Feeds AssemblyItems into the eliminator and @returns the iterator pointing at the first
 	/// item that must be fed into a new instance of the eliminator.
@@ -80,6 +85,7 @@ private:
 
 	KnownState m_initialState;
 	KnownState m_state;
+	std::map<size_t, size_t>* m_ruleHits = nullptr;
 	/// Keeps information about which storage or memory slots were written to at which sequence
 	/// number with what instruction.
 	std::vector<StoreOperation> m_storeOperations;
@@ -172,6 +178,9 @@ _AssemblyItemIterator CommonSubexpressionEliminator::feedItems(
 )
 {
 	assertThrow(!m_breakingItem, OptimizerException, "Invalid use of CommonSubexpressionEliminator.");
+	ExpressionClasses& classes = m_state.expressionClasses();
+	classes.countRuleHits(m_ruleHits);
+	ScopeGuard stopCounting([&]() { classes.countRuleHits(nullptr); });
 	for (; _iterator != _end && !SemanticInformation::breaksCSEAnalysisBlock(*_iterator); ++_iterator)
 		feedItem(*_iterator);
 	if (_iterator != _end)
@@ -22,10 +22,150 @@
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/Assembly.h>
 #include <libevmasm/GasMeter.h>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <tuple>
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+namespace
+{
+
+/// The cheapest way to represent a constant for some parameters.
+struct Representation
+{
+	enum class Method { Literal, CodeCopy, Compute };
+	Method method = Method::Literal;
+	/// Only used for Method::Compute.
+	AssemblyItems routine;
+};
+
+Representation findBestRepresentation(ConstantOptimisationMethod::Params const& _params, u256 const& _value)
+{
+	LiteralMethod lit(_params, _value);
+	bigint literalGas = lit.gasNeeded();
+	CodeCopyMethod copy(_params, _value);
+	bigint copyGas = copy.gasNeeded();
+	ComputeMethod compute(_params, _value);
+	bigint computeGas = compute.gasNeeded();
+	Representation representation;
+	if (copyGas < literalGas && copyGas < computeGas)
+		representation.method = Representation::Method::CodeCopy;
+	else if (computeGas < literalGas && computeGas <= copyGas)
+	{
+		representation.method = Representation::Method::Compute;
+		representation.routine = compute.routine();
+	}
+	return representation;
+}
+
+/// @returns copies of @a _items that are interned in the current tables.
+AssemblyItems reinterned(AssemblyItems const& _items)
+{
+	AssemblyItems items;
+	items.reserve(_items.size());
+	for (AssemblyItem const& item: _items)
+		if (item.type() == Operation)
+			items.push_back(AssemblyItem(item.instruction(), item.location()));
+		else
+			items.push_back(AssemblyItem(item.type(), item.data(), item.location()));
+	return items;
+}
+
+/// Process-wide cache of the best representation of constants. The representation only depends
+/// on the value and the parameters, and the same constants (masks, hashes, function selectors)
+/// appear in many contracts and in both their creation and their runtime code.
+/// The routines are kept in tables of the cache, since the tables of the compilations they come
+/// from are released with them.
+class RepresentationCache
+{
+public:
+	using Key = tuple<u256, bool, size_t, size_t>;
+
+	static RepresentationCache& instance()
+	{
+		static RepresentationCache cache;
+		return cache;
+	}
+
+	static Key key(ConstantOptimisationMethod::Params const& _params, u256 const& _value)
+	{
+		return make_tuple(_value, _params.isCreation, _params.runs, _params.multiplicity);
+	}
+
+	bool lookup(Key const& _key, Representation& _representation)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		auto it = m_representations.find(_key);
+		if (it == m_representations.end())
+			return false;
+		_representation.method = it->second.method;
+		_representation.routine = reinterned(it->second.routine);
+		return true;
+	}
+
+	void store(Key const& _key, Representation const& _representation)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		// Bound the memory used by long-running processes.
+		if (m_representations.size() >= c_maxSize)
+		{
+			m_representations.clear();
+			m_itemTables = make_shared<AssemblyItemTables>();
+		}
+		AssemblyItemTables::Scope itemScope(m_itemTables);
+		Representation& representation = m_representations[_key];
+		representation.method = _representation.method;
+		representation.routine = reinterned(_representation.routine);
+	}
+
+private:
+	static size_t const c_maxSize = 0x4000;
+
+	mutex m_mutex;
+	map<Key, Representation> m_representations;
+	shared_ptr<AssemblyItemTables> m_itemTables = make_shared<AssemblyItemTables>();
+};
+
+/// Minimal number of constants not found in the cache for the evaluation to be done in parallel.
+size_t const c_minConstantsPerThread = 16;
+
+/// Evaluates @a _evaluate for all indices in [0, _count), in parallel if it is worth it.
+void forEachIndex(size_t _count, function<void(size_t)> const& _evaluate)
+{
+	size_t threads = 1;
+#if !ETH_EMSCRIPTEN
+	threads = min<size_t>(thread::hardware_concurrency(), _count / c_minConstantsPerThread);
+#endif
+	if (threads <= 1)
+	{
+		for (size_t i = 0; i < _count; ++i)
+			_evaluate(i);
+		return;
+	}
+	atomic<size_t> next(0);
+	vector<future<void>> workers;
+	// The workers create items in the tables of the calling thread.
+	shared_ptr<AssemblyItemTables> itemTables = AssemblyItemTables::current().shared_from_this();
+	for (size_t i = 0; i < threads; ++i)
+		workers.push_back(async(launch::async, [&]()
+		{
+			AssemblyItemTables::Scope itemScope(itemTables);
+			for (size_t index = next++; index < _count; index = next++)
+				_evaluate(index);
+		}));
+	// Waits for all workers before rethrowing the first exception.
+	for (auto& worker: workers)
+		worker.wait();
+	for (auto& worker: workers)
+		worker.get();
+}
+
+}
+
 unsigned ConstantOptimisationMethod::optimiseConstants(
 	bool _isCreation,
 	size_t _runs,
@@ -38,35 +178,55 @@ unsigned ConstantOptimisationMethod::optimiseConstants(
 	for (AssemblyItem const& item: _items)
 		if (item.type() == Push)
 			pushes[item]++;
-	map<u256, AssemblyItems> pendingReplacements;
+
+	vector<pair<u256, Params>> constants;
 	for (auto it: pushes)
 	{
-		AssemblyItem const& item = it.first;
-		if (item.data() < 0x100)
+		u256 value = it.first.data();
+		if (value < 0x100)
 			continue;
 		Params params;
 		params.multiplicity = it.second;
 		params.isCreation = _isCreation;
 		params.runs = _runs;
-		LiteralMethod lit(params, item.data());
-		bigint literalGas = lit.gasNeeded();
-		CodeCopyMethod copy(params, item.data());
-		bigint copyGas = copy.gasNeeded();
-		ComputeMethod compute(params, item.data());
-		bigint computeGas = compute.gasNeeded();
+		constants.push_back(make_pair(move(value), params));
+	}
+
+	RepresentationCache& cache = RepresentationCache::instance();
+	vector<Representation> representations(constants.size());
+	vector<size_t> missing;
+	for (size_t i = 0; i < constants.size(); ++i)
+		if (!cache.lookup(RepresentationCache::key(constants[i].second, constants[i].first), representations[i]))
+			missing.push_back(i);
+	forEachIndex(missing.size(), [&](size_t _index)
+	{
+		size_t i = missing[_index];
+		representations[i] = findBestRepresentation(constants[i].second, constants[i].first);
+	});
+	for (size_t i: missing)
+		cache.store(RepresentationCache::key(constants[i].second, constants[i].first), representations[i]);
+
+	map<u256, AssemblyItems> pendingReplacements;
+	for (size_t i = 0; i < constants.size(); ++i)
+	{
+		u256 const& value = constants[i].first;
 		AssemblyItems replacement;
-		if (copyGas < literalGas && copyGas < computeGas)
+		switch (representations[i].method)
 		{
-			replacement = copy.execute(_assembly);
-			optimisations++;
+		case Representation::Method::Literal:
+			break;
+		case Representation::Method::CodeCopy:
+			replacement = CodeCopyMethod(constants[i].second, value).execute(_assembly);
+			break;
+		case Representation::Method::Compute:
+			replacement = representations[i].routine;
+			break;
 		}
-		else if (computeGas < literalGas && computeGas <= copyGas)
+		if (!replacement.empty())
 		{
-			replacement = compute.execute(_assembly);
 			optimisations++;
+			pendingReplacements[value] = replacement;
 		}
-		if (!replacement.empty())
-			pendingReplacements[item.data()] = replacement;
 	}
 	if (!pendingReplacements.empty())
 		replaceConstants(_items, pendingReplacements);
@@ -46,6 +46,8 @@ class ConstantOptimisationMethod
 public:
 	/// Tries to optimised how constants are represented in the source code and modifies
 	/// @a _assembly and its @a _items.
+	/// The best representation of each constant is cached for the lifetime of the process and
+	/// constants that are not in the cache yet are evaluated in parallel if there are many.
 	/// @returns zero if no optimisations could be performed.
 	static unsigned optimiseConstants(
 		bool _isCreation,
@@ -94,7 +96,7 @@ protected:
 	static void replaceConstants(AssemblyItems& _items, std::map<u256, AssemblyItems> const& _replacements);
 
 	Params m_params;
-	u256 const& m_value;
+	u256 m_value;
 };
 
 /**
@@ -146,6 +148,7 @@ public:
 	{
 		return m_routine;
 	}
+	AssemblyItems const& routine() const { return m_routine; }
 
 protected:
 	/// Tries to recursively find a way to compute @a _value.
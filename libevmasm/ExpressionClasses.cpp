@@ -27,6 +27,7 @@
 #include <functional>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/functional/hash.hpp>
 #include <libevmasm/Assembly.h>
 #include <libevmasm/CommonSubexpressionEliminator.h>
 #include <libevmasm/SimplificationRules.h>
@@ -50,9 +51,29 @@ bool ExpressionClasses::Expression::operator<(ExpressionClasses::Expression cons
 		return std::tie(instr, arguments, sequenceNumber) <
 			std::tie(otherInstr, _other.arguments, _other.sequenceNumber);
 	}
+	else if (*item != *_other.item)
+		// Compares the data without copying it out of the items.
+		return *item < *_other.item;
 	else
-		return std::tie(item->data(), arguments, sequenceNumber) <
-			std::tie(_other.item->data(), _other.arguments, _other.sequenceNumber);
+		return std::tie(arguments, sequenceNumber) < std::tie(_other.arguments, _other.sequenceNumber);
+}
+
+bool ExpressionClasses::Expression::operator==(ExpressionClasses::Expression const& _other) const
+{
+	assertThrow(!!item && !!_other.item, OptimizerException, "");
+	return
+		*item == *_other.item &&
+		arguments == _other.arguments &&
+		sequenceNumber == _other.sequenceNumber;
+}
+
+size_t ExpressionClasses::Expression::hash() const
+{
+	assertThrow(!!item, OptimizerException, "");
+	size_t seed = item->hash();
+	boost::hash_combine(seed, arguments);
+	boost::hash_combine(seed, sequenceNumber);
+	return seed;
 }
 
 ExpressionClasses::Id ExpressionClasses::find(
@@ -133,7 +154,7 @@ bool ExpressionClasses::knownToBeDifferent(ExpressionClasses::Id _a, ExpressionC
 bool ExpressionClasses::knownToBeDifferentBy32(ExpressionClasses::Id _a, ExpressionClasses::Id _b)
 {
 	// Try to simplify "_a - _b" and return true iff the value is at least 32 away from zero.
-	u256 const* v = knownConstant(find(Instruction::SUB, {_a, _b}));
+	boost::optional<u256> v = knownConstant(find(Instruction::SUB, {_a, _b}));
 	// forbidden interval is ["-31", 31]
 	return v && *v + 31 > u256(62);
 }
@@ -148,20 +169,20 @@ bool ExpressionClasses::knownNonZero(Id _c)
 	return Pattern(u256(0)).matches(representative(find(Instruction::ISZERO, {_c})), *this);
 }
 
-u256 const* ExpressionClasses::knownConstant(Id _c)
+boost::optional<u256> ExpressionClasses::knownConstant(Id _c)
 {
 	map<unsigned, Expression const*> matchGroups;
 	Pattern constant(Push);
 	constant.setMatchGroup(1, matchGroups);
 	if (!constant.matches(representative(_c), *this))
-		return nullptr;
-	return &constant.d();
+		return boost::none;
+	return constant.d();
 }
 
 AssemblyItem const* ExpressionClasses::storeItem(AssemblyItem const& _item)
 {
-	m_spareAssemblyItems.push_back(make_shared<AssemblyItem>(_item));
-	return m_spareAssemblyItems.back().get();
+	m_spareAssemblyItems.push_back(_item);
+	return &m_spareAssemblyItems.back();
 }
 
 string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
@@ -183,7 +204,7 @@ string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
 
 ExpressionClasses::Id ExpressionClasses::tryToSimplify(Expression const& _expr, bool _secondRun)
 {
-	static Rules rules;
+	Rules& rules = Rules::standard();
 
 	if (
 		!_expr.item ||
@@ -202,6 +223,8 @@ ExpressionClasses::Id ExpressionClasses::tryToSimplify(Expression const& _expr,
 		//cout << "with rule " << match->first.toString() << endl;
 		//ExpressionTemplate t(match->second());
 		//cout << "to " << match->second().toString() << endl;
+		if (m_ruleHits)
+			(*m_ruleHits)[rules.ruleIndex(*match)]++;
 		return rebuildExpression(ExpressionTemplate(match->second(), _expr.item->location()));
 	}
 
@@ -26,10 +26,13 @@
 #include <libdevcore/Common.h>
 #include <libevmasm/AssemblyItem.h>
 
+#include <boost/optional.hpp>
+
 #include <vector>
+#include <deque>
 #include <map>
 #include <memory>
-#include <set>
+#include <unordered_set>
 
 namespace dev
 {
@@ -58,6 +61,10 @@ public:
 		unsigned sequenceNumber = 0;
 		/// Behaves as if this was a tuple of (item->type(), item->data(), arguments, sequenceNumber).
 		bool operator<(Expression const& _other) const;
+		/// Compares item, arguments and sequence number, but not the id.
+		bool operator==(Expression const& _other) const;
+		/// @returns a hash value that is compatible with operator==.
+		size_t hash() const;
 	};
 
 	/// Retrieves the id of the expression equivalence class resulting from the given item applied to the
@@ -95,9 +102,8 @@ public:
 	/// @returns true if the value of the given class is known to be nonzero.
 	/// @note that this is not the negation of knownZero
 	bool knownNonZero(Id _c);
-	/// @returns a pointer to the value if the given class is known to be a constant,
-	/// and a nullptr otherwise.
-	u256 const* knownConstant(Id _c);
+	/// @returns the value if the given class is known to be a constant, and an empty optional otherwise.
+	boost::optional<u256> knownConstant(Id _c);
 
 	/// Stores a copy of the given AssemblyItem and returns a pointer to the copy that is valid for
 	/// the lifetime of the ExpressionClasses object.
@@ -105,6 +111,10 @@ public:
 
 	std::string fullDAGToString(Id _id) const;
 
+	/// Counts the applications of simplification rules in @a _ruleHits (by rule index) from now on,
+	/// stops counting if it is nullptr.
+	void countRuleHits(std::map<size_t, size_t>* _ruleHits) { m_ruleHits = _ruleHits; }
+
 private:
 	/// Tries to simplify the given expression.
 	/// @returns its class if it possible or Id(-1) otherwise.
@@ -116,11 +126,19 @@ private:
 
 	std::vector<std::pair<Pattern, std::function<Pattern()>>> createRules() const;
 
+	struct ExpressionHash
+	{
+		size_t operator()(Expression const& _expression) const { return _expression.hash(); }
+	};
+
 	/// Expression equivalence class representatives - we only store one item of an equivalence.
 	std::vector<Expression> m_representatives;
 	/// All expression ever encountered.
-	std::set<Expression> m_expressions;
-	std::vector<std::shared_ptr<AssemblyItem>> m_spareAssemblyItems;
+	std::unordered_set<Expression, ExpressionHash> m_expressions;
+	/// Copies of assembly items referenced by expressions, the deque keeps their addresses stable.
+	std::deque<AssemblyItem> m_spareAssemblyItems;
+	/// Counter for the applications of simplification rules, can be nullptr.
+	std::map<size_t, size_t>* m_ruleHits = nullptr;
 };
 
 }
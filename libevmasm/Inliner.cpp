@@ -0,0 +1,264 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Inlines small internal functions at their call sites.
+ */
+
+#include <libevmasm/Inliner.h>
+
+#include <libevmasm/AssemblyItem.h>
+#include <libevmasm/GasMeter.h>
+#include <libevmasm/SemanticInformation.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::solidity;
+
+namespace
+{
+
+/**
+ * Follows the stack slots through a sequence of items without control flow. Slots that were
+ * already on the stack before the sequence are identified by their (negative) depth at its
+ * start, values produced by the sequence by non-negative numbers.
+ */
+class StackTracker
+{
+public:
+	/// @returns false if the effect of the item on the stack is not known.
+	bool apply(AssemblyItem const& _item)
+	{
+		if (_item.type() == UndefinedItem)
+			return false;
+		if (SemanticInformation::isDupInstruction(_item))
+		{
+			unsigned depth = getDupNumber(_item.instruction());
+			m_stack.push_back(at(depth - 1));
+		}
+		else if (SemanticInformation::isSwapInstruction(_item))
+		{
+			unsigned depth = getSwapNumber(_item.instruction());
+			materialise(depth + 1);
+			swap(m_stack.back(), m_stack[m_stack.size() - 1 - depth]);
+		}
+		else
+		{
+			materialise(_item.arguments());
+			m_stack.resize(m_stack.size() - _item.arguments());
+			for (int i = 0; i < _item.returnValues(); ++i)
+				push();
+		}
+		return true;
+	}
+	/// Pushes a new value and @returns its identifier.
+	long push()
+	{
+		m_stack.push_back(m_nextValue++);
+		return m_stack.back();
+	}
+	/// @returns the identifier of the value @a _depth slots below the top of the stack.
+	long at(size_t _depth)
+	{
+		materialise(_depth + 1);
+		return m_stack[m_stack.size() - 1 - _depth];
+	}
+	/// @returns the depth at the start of the sequence of a slot that was on the stack before.
+	static size_t entryDepth(long _value) { return size_t(-1 - _value); }
+	static bool isEntrySlot(long _value) { return _value < 0; }
+
+private:
+	/// Makes sure that at least @a _size slots are tracked, adding the slots that were on the
+	/// stack before the sequence below the tracked ones.
+	void materialise(size_t _size)
+	{
+		if (m_stack.size() < _size)
+		{
+			size_t missing = _size - m_stack.size();
+			vector<long> slots;
+			for (size_t i = 0; i < missing; ++i)
+				slots.push_back(-1 - long(m_entrySlots + missing - 1 - i));
+			m_entrySlots += missing;
+			m_stack.insert(m_stack.begin(), slots.begin(), slots.end());
+		}
+	}
+
+	vector<long> m_stack;
+	size_t m_entrySlots = 0;
+	long m_nextValue = 0;
+};
+
+bool isLocalTag(AssemblyItem const& _item, AssemblyItemType _type)
+{
+	return _item.type() == _type && _item.splitForeignPushTag().first == size_t(-1);
+}
+
+bool isJump(AssemblyItem const& _item, AssemblyItem::JumpType _jumpType)
+{
+	return _item == AssemblyItem(Instruction::JUMP) && _item.getJumpType() == _jumpType;
+}
+
+}
+
+bool Inliner::optimise(set<size_t> const& _tagsReferencedFromOutside)
+{
+	map<size_t, size_t> tagPositions;
+	map<size_t, size_t> referenceCounts;
+	for (size_t i = 0; i < m_items.size(); ++i)
+		if (isLocalTag(m_items[i], Tag))
+			tagPositions[m_items[i].splitForeignPushTag().second] = i;
+		else if (isLocalTag(m_items[i], PushTag))
+			referenceCounts[m_items[i].splitForeignPushTag().second]++;
+
+	map<size_t, InlinableFunction> functions;
+	set<size_t> otherTags;
+	for (size_t i = 0; i + 2 < m_items.size(); ++i)
+	{
+		if (
+			!isLocalTag(m_items[i], PushTag) ||
+			!isJump(m_items[i + 1], AssemblyItem::JumpType::IntoFunction) ||
+			!isLocalTag(m_items[i + 2], Tag)
+		)
+			continue;
+		size_t tag = m_items[i].splitForeignPushTag().second;
+		if (otherTags.count(tag) || !tagPositions.count(tag))
+			continue;
+		auto function = functions.find(tag);
+		if (function == functions.end())
+		{
+			InlinableFunction analysed;
+			if (!analyseFunction(tagPositions.at(tag), analysed))
+			{
+				otherTags.insert(tag);
+				continue;
+			}
+			function = functions.insert(make_pair(tag, analysed)).first;
+		}
+		if (isInlinableCall(i, function->second.returnAddressDepth))
+			function->second.callSites.push_back(i);
+	}
+
+	map<size_t, InlinableFunction const*> callSites;
+	for (auto const& function: functions)
+	{
+		if (function.second.callSites.empty())
+			continue;
+		bool bodyRemovable =
+			!_tagsReferencedFromOutside.count(function.first) &&
+			referenceCounts[function.first] == function.second.callSites.size();
+		if (shouldInline(function.second, bodyRemovable))
+			for (size_t callSite: function.second.callSites)
+				callSites[callSite] = &function.second;
+	}
+	if (callSites.empty())
+		return false;
+
+	AssemblyItems optimisedItems;
+	optimisedItems.reserve(m_items.size());
+	for (size_t i = 0; i < m_items.size(); ++i)
+	{
+		auto callSite = callSites.find(i);
+		if (callSite == callSites.end())
+		{
+			optimisedItems.push_back(m_items[i]);
+			continue;
+		}
+		InlinableFunction const& function = *callSite->second;
+		optimisedItems.insert(
+			optimisedItems.end(),
+			m_items.begin() + function.begin,
+			m_items.begin() + function.end
+		);
+		// The return address is on top of the stack and execution continues at the return tag anyway.
+		optimisedItems.push_back(AssemblyItem(Instruction::POP, m_items[function.end].location()));
+		// Skip the jump into the function.
+		++i;
+	}
+	m_items = move(optimisedItems);
+	return true;
+}
+
+bool Inliner::analyseFunction(size_t _tagPosition, InlinableFunction& _function) const
+{
+	StackTracker stack;
+	size_t end = _tagPosition + 1;
+	for (; end < m_items.size(); ++end)
+	{
+		AssemblyItem const& item = m_items[end];
+		if (isJump(item, AssemblyItem::JumpType::OutOfFunction))
+			break;
+		if (item.type() == Tag || SemanticInformation::altersControlFlow(item) || !stack.apply(item))
+			return false;
+	}
+	if (end == m_items.size())
+		return false;
+	long returnAddress = stack.at(0);
+	if (!StackTracker::isEntrySlot(returnAddress))
+		return false;
+
+	_function.begin = _tagPosition + 1;
+	_function.end = end;
+	_function.returnAddressDepth = StackTracker::entryDepth(returnAddress);
+	return true;
+}
+
+bool Inliner::isInlinableCall(size_t _callSite, size_t _returnAddressDepth) const
+{
+	AssemblyItem const pushReturnTag = m_items[_callSite + 2].pushTag();
+	// Search the push of the return tag in the basic block of the call.
+	size_t pushPosition = _callSite;
+	while (pushPosition > 0)
+	{
+		AssemblyItem const& item = m_items[--pushPosition];
+		if (item.type() == Tag || SemanticInformation::altersControlFlow(item))
+			return false;
+		if (item == pushReturnTag)
+			break;
+	}
+	if (m_items[pushPosition] != pushReturnTag)
+		return false;
+
+	StackTracker stack;
+	long returnAddress = stack.push();
+	for (size_t i = pushPosition + 1; i < _callSite; ++i)
+		if (!stack.apply(m_items[i]))
+			return false;
+	return stack.at(_returnAddressDepth) == returnAddress;
+}
+
+bool Inliner::shouldInline(InlinableFunction const& _function, bool _bodyRemovable) const
+{
+	AssemblyItems body(m_items.begin() + _function.begin, m_items.begin() + _function.end);
+	bigint bodySize = bytesRequired(body, 3);
+	bigint callSize = AssemblyItem(PushTag).bytesRequired(3) + AssemblyItem(Instruction::JUMP).bytesRequired(3);
+	bigint calls = _function.callSites.size();
+
+	// Each call site is replaced by the body and a POP.
+	bigint sizeIncrease = calls * (bodySize + 1 - callSize);
+	// The body, its JUMPDEST and the final jump can be removed if no other reference is left.
+	if (_bodyRemovable)
+		sizeIncrease -= bodySize + 2;
+	// Saved per call: pushing the function tag, both jumps and the JUMPDEST, but a POP is added.
+	bigint gasSavedPerCall =
+		GasMeter::runGas(Instruction::PUSH1) +
+		2 * GasMeter::runGas(Instruction::JUMP) +
+		GasMeter::runGas(Instruction::JUMPDEST) -
+		GasMeter::runGas(Instruction::POP);
+	bigint dataGasPerByte = m_isCreation ? GasCosts::txDataNonZeroGas : GasCosts::createDataGas;
+
+	return bigint(m_runs) * calls * gasSavedPerCall > sizeIncrease * dataGasPerByte;
+}
@@ -0,0 +1,89 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Inlines small internal functions at their call sites.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <set>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+
+class AssemblyItem;
+using AssemblyItems = std::vector<AssemblyItem>;
+
+/**
+ * Optimizer class that copies the bodies of small internal functions to their call sites.
+ *
+ * A function qualifies if its body is a single basic block that starts at its tag and ends
+ * with a jump out of the function. A call site is "PUSH tag_f JUMP [in] tag_ret", where the
+ * return tag has to be pushed in the same basic block before the call, at exactly the stack
+ * position the function body jumps to. At such a call site, the body is copied and its final
+ * jump is replaced by a POP of the return address, so that execution continues at the return
+ * tag. Whether this pays off is decided per function from the additional code size and the
+ * runtime gas saved per call, weighted by the expected number of executions.
+ *
+ * Pushing and popping the return address is left to the common subexpression eliminator,
+ * and the function body itself is removed by the other passes once it is not referenced anymore.
+ */
+class Inliner
+{
+public:
+	Inliner(AssemblyItems& _items, size_t _runs, bool _isCreation):
+		m_items(_items), m_runs(_runs), m_isCreation(_isCreation) {}
+
+	/// @returns true if something was inlined.
+	bool optimise(std::set<size_t> const& _tagsReferencedFromOutside);
+
+private:
+	/// Body of a function that can be inlined.
+	struct InlinableFunction
+	{
+		/// Position of the first item after the function's tag.
+		size_t begin = 0;
+		/// Position of the final jump.
+		size_t end = 0;
+		/// Number of stack slots above the return address when the function is entered.
+		size_t returnAddressDepth = 0;
+		/// Positions of the call sites that can be replaced by the body.
+		std::vector<size_t> callSites;
+	};
+
+	/// @returns true and fills @a _function if the tag at position @a _tagPosition starts a
+	/// function body that can be inlined.
+	bool analyseFunction(size_t _tagPosition, InlinableFunction& _function) const;
+	/// @returns true if the PUSH tag_f JUMP [in] at position @a _callSite pushes its return
+	/// address at stack depth @a _returnAddressDepth.
+	bool isInlinableCall(size_t _callSite, size_t _returnAddressDepth) const;
+	/// @returns true if inlining @a _function at all its call sites reduces the combined
+	/// deployment and execution costs. @a _bodyRemovable is true if the function's tag is
+	/// not referenced anywhere else.
+	bool shouldInline(InlinableFunction const& _function, bool _bodyRemovable) const;
+
+	AssemblyItems& m_items;
+	size_t m_runs;
+	bool m_isCreation;
+};
+
+}
+}
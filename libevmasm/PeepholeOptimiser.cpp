@@ -24,6 +24,8 @@
 #include <libevmasm/AssemblyItem.h>
 #include <libevmasm/SemanticInformation.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace dev::eth;
 using namespace dev;
@@ -33,13 +35,6 @@ using namespace dev;
 namespace
 {
 
-struct OptimiserState
-{
-	AssemblyItems const& items;
-	size_t i;
-	std::back_insert_iterator<AssemblyItems> out;
-};
-
 template <class Method, size_t Arguments>
 struct ApplyRule
 {
@@ -72,45 +67,50 @@ struct ApplyRule<Method, 1>
 template <class Method, size_t WindowSize>
 struct SimplePeepholeOptimizerMethod
 {
-	static bool apply(OptimiserState& _state)
+	static size_t apply(AssemblyItems::const_iterator _in, AssemblyItems::const_iterator _end, AssemblyItems& _out)
 	{
 		if (
-			_state.i + WindowSize <= _state.items.size() &&
-			ApplyRule<Method, WindowSize>::applyRule(_state.items.begin() + _state.i, _state.out)
+			size_t(_end - _in) >= WindowSize &&
+			ApplyRule<Method, WindowSize>::applyRule(_in, std::back_inserter(_out))
 		)
-		{
-			_state.i += WindowSize;
-			return true;
-		}
+			return WindowSize;
 		else
-			return false;
+			return 0;
 	}
-};
 
-struct Identity: SimplePeepholeOptimizerMethod<Identity, 1>
-{
-	static bool applySimple(AssemblyItem const& _item, std::back_insert_iterator<AssemblyItems> _out)
+	static PeepholeRule rule(string const& _name)
 	{
-		*_out = _item;
-		return true;
+		return PeepholeRule{_name, WindowSize, &Method::startsWith, &Method::apply};
 	}
 };
 
 struct PushPop: SimplePeepholeOptimizerMethod<PushPop, 2>
 {
-	static bool applySimple(AssemblyItem const& _push, AssemblyItem const& _pop, std::back_insert_iterator<AssemblyItems>)
+	static bool startsWith(AssemblyItem const& _push)
 	{
 		auto t = _push.type();
-		return _pop == Instruction::POP && (
+		return
 			SemanticInformation::isDupInstruction(_push) ||
 			t == Push || t == PushString || t == PushTag || t == PushSub ||
-			t == PushSubSize || t == PushProgramSize || t == PushData || t == PushLibraryAddress
-		);
+			t == PushSubSize || t == PushProgramSize || t == PushData || t == PushLibraryAddress;
+	}
+
+	static bool applySimple(AssemblyItem const& _push, AssemblyItem const& _pop, std::back_insert_iterator<AssemblyItems>)
+	{
+		return _pop == Instruction::POP && startsWith(_push);
 	}
 };
 
 struct OpPop: SimplePeepholeOptimizerMethod<OpPop, 2>
 {
+	static bool startsWith(AssemblyItem const& _op)
+	{
+		if (_op.type() != Operation || !isValidInstruction(_op.instruction()))
+			return false;
+		InstructionInfo info = instructionInfo(_op.instruction());
+		return info.ret == 1 && !info.sideEffects;
+	}
+
 	static bool applySimple(
 		AssemblyItem const& _op,
 		AssemblyItem const& _pop,
@@ -120,7 +120,13 @@ struct OpPop: SimplePeepholeOptimizerMethod<OpPop, 2>
 		if (_pop == Instruction::POP && _op.type() == Operation)
 		{
 			Instruction instr = _op.instruction();
-			if (instructionInfo(instr).ret == 1 && !instructionInfo(instr).sideEffects)
+			// The replacement has one POP per argument, which makes the code bigger for
+			// ADDMOD and MULMOD.
+			if (
+				instructionInfo(instr).ret == 1 &&
+				!instructionInfo(instr).sideEffects &&
+				instructionInfo(instr).args <= 2
+			)
 			{
 				for (int j = 0; j < instructionInfo(instr).args; j++)
 					*_out = {Instruction::POP, _op.location()};
@@ -133,6 +139,11 @@ struct OpPop: SimplePeepholeOptimizerMethod<OpPop, 2>
 
 struct DoubleSwap: SimplePeepholeOptimizerMethod<DoubleSwap, 2>
 {
+	static bool startsWith(AssemblyItem const& _s1)
+	{
+		return SemanticInformation::isSwapInstruction(_s1);
+	}
+
 	static size_t applySimple(AssemblyItem const& _s1, AssemblyItem const& _s2, std::back_insert_iterator<AssemblyItems>)
 	{
 		return _s1 == _s2 && SemanticInformation::isSwapInstruction(_s1);
@@ -141,6 +152,11 @@ struct DoubleSwap: SimplePeepholeOptimizerMethod<DoubleSwap, 2>
 
 struct DoublePush: SimplePeepholeOptimizerMethod<DoublePush, 2>
 {
+	static bool startsWith(AssemblyItem const& _push1)
+	{
+		return _push1.type() == Push;
+	}
+
 	static bool applySimple(AssemblyItem const& _push1, AssemblyItem const& _push2, std::back_insert_iterator<AssemblyItems> _out)
 	{
 		if (_push1.type() == Push && _push2.type() == Push && _push1.data() == _push2.data())
@@ -156,6 +172,11 @@ struct DoublePush: SimplePeepholeOptimizerMethod<DoublePush, 2>
 
 struct JumpToNext: SimplePeepholeOptimizerMethod<JumpToNext, 3>
 {
+	static bool startsWith(AssemblyItem const& _pushTag)
+	{
+		return _pushTag.type() == PushTag;
+	}
+
 	static size_t applySimple(
 		AssemblyItem const& _pushTag,
 		AssemblyItem const& _jump,
@@ -182,6 +203,11 @@ struct JumpToNext: SimplePeepholeOptimizerMethod<JumpToNext, 3>
 
 struct TagConjunctions: SimplePeepholeOptimizerMethod<TagConjunctions, 3>
 {
+	static bool startsWith(AssemblyItem const& _pushTag)
+	{
+		return _pushTag.type() == PushTag;
+	}
+
 	static bool applySimple(
 		AssemblyItem const& _pushTag,
 		AssemblyItem const& _pushConstant,
@@ -205,72 +231,130 @@ struct TagConjunctions: SimplePeepholeOptimizerMethod<TagConjunctions, 3>
 };
 
 /// Removes everything after a JUMP (or similar) until the next JUMPDEST.
+/// Only the first item has to be re-examined after a rewrite, since rewrites never remove tags.
 struct UnreachableCode
 {
-	static bool apply(OptimiserState& _state)
+	static bool startsWith(AssemblyItem const& _item)
 	{
-		auto it = _state.items.begin() + _state.i;
-		auto end = _state.items.end();
-		if (it == end)
-			return false;
-		if (
-			it[0] != Instruction::JUMP &&
-			it[0] != Instruction::RETURN &&
-			it[0] != Instruction::STOP &&
-			it[0] != Instruction::INVALID &&
-			it[0] != Instruction::SELFDESTRUCT &&
-			it[0] != Instruction::REVERT
-		)
-			return false;
+		return
+			_item == Instruction::JUMP ||
+			_item == Instruction::RETURN ||
+			_item == Instruction::STOP ||
+			_item == Instruction::INVALID ||
+			_item == Instruction::SELFDESTRUCT ||
+			_item == Instruction::REVERT;
+	}
+
+	static size_t apply(AssemblyItems::const_iterator _in, AssemblyItems::const_iterator _end, AssemblyItems& _out)
+	{
+		if (_in == _end || !startsWith(_in[0]))
+			return 0;
 
 		size_t i = 1;
-		while (it + i != end && it[i].type() != Tag)
+		while (_in + i != _end && _in[i].type() != Tag)
 			i++;
 		if (i > 1)
 		{
-			*_state.out = it[0];
-			_state.i += i;
-			return true;
+			_out.push_back(_in[0]);
+			return i;
 		}
 		else
-			return false;
+			return 0;
+	}
+
+	static PeepholeRule rule(string const& _name)
+	{
+		return PeepholeRule{_name, 1, &startsWith, &apply};
 	}
 };
 
-void applyMethods(OptimiserState&)
-{
-	assertThrow(false, OptimizerException, "Peephole optimizer failed to apply identity.");
 }
 
-template <typename Method, typename... OtherMethods>
-void applyMethods(OptimiserState& _state, Method, OtherMethods... _other)
+PeepholeRules const& PeepholeRules::standard()
 {
-	if (!Method::apply(_state))
-		applyMethods(_state, _other...);
+	static PeepholeRules const rules = []()
+	{
+		PeepholeRules rules;
+		rules.add(PushPop::rule("PushPop"));
+		rules.add(OpPop::rule("OpPop"));
+		rules.add(DoublePush::rule("DoublePush"));
+		rules.add(DoubleSwap::rule("DoubleSwap"));
+		rules.add(JumpToNext::rule("JumpToNext"));
+		rules.add(UnreachableCode::rule("UnreachableCode"));
+		rules.add(TagConjunctions::rule("TagConjunctions"));
+		return rules;
+	}();
+	return rules;
 }
 
-size_t numberOfPops(AssemblyItems const& _items)
+void PeepholeRules::add(PeepholeRule _rule)
 {
-	return std::count(_items.begin(), _items.end(), Instruction::POP);
+	assertThrow(_rule.windowSize > 0 && _rule.startsWith && _rule.apply, OptimizerException, "Invalid peephole rule.");
+	size_t index = m_rules.size();
+	for (unsigned i = 0; i < 256; ++i)
+		if (_rule.startsWith(AssemblyItem(Instruction(i))))
+			m_table[i].push_back(index);
+	for (unsigned type = 0; type <= unsigned(PushLibraryAddress); ++type)
+		if (AssemblyItemType(type) != Operation && _rule.startsWith(AssemblyItem(AssemblyItemType(type))))
+			m_table[256 + type].push_back(index);
+	m_maxWindowSize = max(m_maxWindowSize, _rule.windowSize);
+	m_rules.push_back(move(_rule));
 }
 
+size_t PeepholeRules::key(AssemblyItem const& _item)
+{
+	if (_item.type() == Operation)
+		return size_t(_item.instruction());
+	else
+		return 256 + size_t(_item.type());
 }
 
 bool PeepholeOptimiser::optimise()
 {
-	OptimiserState state {m_items, 0, std::back_inserter(m_optimisedItems)};
-	while (state.i < m_items.size())
-		applyMethods(state, PushPop(), OpPop(), DoublePush(), DoubleSwap(), JumpToNext(), UnreachableCode(), TagConjunctions(), Identity());
-	if (m_optimisedItems.size() < m_items.size() || (
-		m_optimisedItems.size() == m_items.size() && (
-			eth::bytesRequired(m_optimisedItems, 3) < eth::bytesRequired(m_items, 3) ||
-			numberOfPops(m_optimisedItems) > numberOfPops(m_items)
-		)
-	))
+	// m_items[0, written) is the optimised code and m_items[read, end) still has to be scanned.
+	// Replacements are put in front of the unscanned part, together with the last few items of
+	// the optimised code, so that they are scanned again.
+	size_t written = 0;
+	size_t read = 0;
+	size_t const backtrack = m_rules.maxWindowSize() - 1;
+	size_t const maxRewrites = 64000 + 64 * m_items.size();
+	size_t rewrites = 0;
+	AssemblyItems replacement;
+	while (read < m_items.size())
 	{
-		m_items = std::move(m_optimisedItems);
-		return true;
+		size_t consumed = 0;
+		for (size_t index: m_rules.candidates(m_items[read]))
+		{
+			replacement.clear();
+			consumed = m_rules.rule(index).apply(m_items.begin() + read, m_items.end(), replacement);
+			if (consumed > 0)
+				break;
+		}
+		if (consumed == 0)
+		{
+			if (written != read)
+				m_items[written] = m_items[read];
+			++written;
+			++read;
+			continue;
+		}
+
+		assertThrow(++rewrites < maxRewrites, OptimizerException, "Peephole optimizer seems to be stuck.");
+		read += consumed;
+		if (replacement.size() > read - written)
+		{
+			size_t missing = replacement.size() - (read - written);
+			m_items.insert(m_items.begin() + read, missing, AssemblyItem(UndefinedItem));
+			read += missing;
+		}
+		read -= replacement.size();
+		copy(replacement.begin(), replacement.end(), m_items.begin() + read);
+
+		size_t back = min(written, backtrack);
+		move_backward(m_items.begin() + written - back, m_items.begin() + written, m_items.begin() + read);
+		written -= back;
+		read -= back;
 	}
-	else
-		return false;
+	m_items.erase(m_items.begin() + written, m_items.end());
+	return rewrites > 0;
 }
@@ -20,9 +20,11 @@
  */
 #pragma once
 
-#include <vector>
+#include <array>
 #include <cstddef>
-#include <iterator>
+#include <functional>
+#include <string>
+#include <vector>
 
 namespace dev
 {
@@ -31,23 +33,68 @@ namespace eth
 class AssemblyItem;
 using AssemblyItems = std::vector<AssemblyItem>;
 
-class PeepholeOptimisationMethod
+/**
+ * A local rewrite rule of the peephole optimiser.
+ */
+struct PeepholeRule
+{
+	std::string name;
+	/// Number of items the rule looks at. After a rewrite, the optimiser backtracks by one less
+	/// than the largest window size, so that matches overlapping the rewritten code are found.
+	size_t windowSize;
+	/// Decides whether the rule can match a window starting with an item of the same type and
+	/// instruction as the given item. This is only used to build the dispatch table and must not
+	/// depend on any other properties of the item.
+	std::function<bool(AssemblyItem const&)> startsWith;
+	/// Tries to match the rule at @a _in and @returns the number of consumed items (zero if it
+	/// did not match). The replacement is appended to @a _out.
+	std::function<size_t(AssemblyItems::const_iterator _in, AssemblyItems::const_iterator _end, AssemblyItems& _out)> apply;
+};
+
+/**
+ * Registry of peephole rules with a dispatch table that maps the first item of a window
+ * to the rules that can match there, in the order they were added.
+ */
+class PeepholeRules
 {
 public:
-	virtual size_t windowSize() const;
-	virtual bool apply(AssemblyItems::const_iterator _in, std::back_insert_iterator<AssemblyItems> _out);
+	/// @returns the registry containing the built-in rules.
+	static PeepholeRules const& standard();
+
+	void add(PeepholeRule _rule);
+
+	/// @returns the indices of the rules that can match a window starting with @a _item.
+	std::vector<size_t> const& candidates(AssemblyItem const& _item) const { return m_table[key(_item)]; }
+	PeepholeRule const& rule(size_t _index) const { return m_rules[_index]; }
+	size_t maxWindowSize() const { return m_maxWindowSize; }
+
+private:
+	/// Instructions for operations, item types offset by 256 for all other items.
+	static size_t key(AssemblyItem const& _item);
+	static size_t const c_keys = 256 + 16;
+
+	std::vector<PeepholeRule> m_rules;
+	std::array<std::vector<size_t>, c_keys> m_table;
+	size_t m_maxWindowSize = 1;
 };
 
+/**
+ * Applies peephole rules to a list of items. The items are rewritten in place in a single scan:
+ * after each rewrite, the scan continues slightly before the rewritten code, so that no further
+ * optimisation opportunities are left when it reaches the end.
+ */
 class PeepholeOptimiser
 {
 public:
-	explicit PeepholeOptimiser(AssemblyItems& _items): m_items(_items) {}
+	explicit PeepholeOptimiser(AssemblyItems& _items, PeepholeRules const& _rules = PeepholeRules::standard()):
+		m_items(_items), m_rules(_rules) {}
 
+	/// @returns true if something was changed.
 	bool optimise();
 
 private:
 	AssemblyItems& m_items;
-	AssemblyItems m_optimisedItems;
+	PeepholeRules const& m_rules;
 };
 
 }
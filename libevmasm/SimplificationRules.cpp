@@ -25,6 +25,7 @@
 #include <utility>
 #include <tuple>
 #include <functional>
+#include <set>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/noncopyable.hpp>
 #include <libevmasm/Assembly.h>
@@ -36,7 +37,15 @@ using namespace dev;
 using namespace dev::eth;
 
 
-pair<Pattern, function<Pattern()> > const* Rules::findFirstMatch(
+size_t const Rules::DecisionNode::none;
+
+Rules& Rules::standard()
+{
+	static Rules rules;
+	return rules;
+}
+
+Rules::Rule const* Rules::findFirstMatch(
 	Expression const& _expr,
 	ExpressionClasses const& _classes
 )
@@ -44,24 +53,116 @@ pair<Pattern, function<Pattern()> > const* Rules::findFirstMatch(
 	resetMatchGroups();
 
 	assertThrow(_expr.item, OptimizerException, "");
-	for (auto const& rule: m_rules[byte(_expr.item->instruction())])
+	size_t nodeIndex = m_decisionTrees[byte(_expr.item->instruction())];
+	if (nodeIndex == DecisionNode::none)
+		return nullptr;
+	while (!m_decisionNodes[nodeIndex].isLeaf)
+	{
+		DecisionNode const& node = m_decisionNodes[nodeIndex];
+		assertThrow(node.argument < _expr.arguments.size(), OptimizerException, "");
+		AssemblyItem const* argument = _classes.representative(_expr.arguments[node.argument]).item;
+		nodeIndex = node.other;
+		if (argument && argument->type() == Operation)
+		{
+			auto child = node.byInstruction.find(argument->instruction());
+			if (child != node.byInstruction.end())
+				nodeIndex = child->second;
+		}
+		else if (argument && argument->type() == Push)
+		{
+			auto child = node.byConstant.find(argument->data());
+			nodeIndex = child != node.byConstant.end() ? child->second : node.otherConstant;
+		}
+	}
+	for (size_t ruleIndex: m_decisionNodes[nodeIndex].rules)
 	{
-		if (rule.first.matches(_expr, _classes))
-			return &rule;
+		if (m_rules[ruleIndex].first.matches(_expr, _classes))
+		{
+			return &m_rules[ruleIndex];
+		}
 		resetMatchGroups();
 	}
 	return nullptr;
 }
 
-void Rules::addRules(std::vector<std::pair<Pattern, std::function<Pattern ()> > > const& _rules)
+size_t Rules::ruleIndex(Rule const& _rule) const
+{
+	assertThrow(&_rule >= m_rules.data() && &_rule < m_rules.data() + m_rules.size(), OptimizerException, "");
+	return &_rule - m_rules.data();
+}
+
+string Rules::ruleDescription(size_t _index) const
+{
+	return m_rules.at(_index).first.toString();
+}
+
+void Rules::addRules(vector<Rule> const& _rules)
 {
 	for (auto const& r: _rules)
 		addRule(r);
 }
 
-void Rules::addRule(std::pair<Pattern, std::function<Pattern()> > const& _rule)
+void Rules::addRule(Rule const& _rule)
+{
+	m_rules.push_back(_rule);
+}
+
+size_t Rules::buildDecisionTree(vector<size_t> const& _rules, size_t _argument)
 {
-	m_rules[byte(_rule.first.instruction())].push_back(_rule);
+	size_t const index = m_decisionNodes.size();
+	m_decisionNodes.push_back(DecisionNode());
+	size_t arguments = _rules.empty() ? 0 : m_rules[_rules.front()].first.arguments().size();
+	if (_rules.size() <= 1 || _argument >= arguments)
+	{
+		m_decisionNodes[index].rules = _rules;
+		return index;
+	}
+
+	vector<Pattern> patterns;
+	set<Instruction> instructions;
+	set<u256> constants;
+	for (size_t rule: _rules)
+	{
+		vector<Pattern> ruleArguments = m_rules[rule].first.arguments();
+		assertThrow(ruleArguments.size() == arguments, OptimizerException, "Rules with different number of arguments.");
+		patterns.push_back(ruleArguments[_argument]);
+		if (patterns.back().type() == Operation)
+			instructions.insert(patterns.back().instruction());
+		else if (patterns.back().type() == Push && patterns.back().requiresDataMatch())
+			constants.insert(patterns.back().data());
+	}
+	// Patterns for other item types are only checked by the full match.
+	auto matchesAnything = [](Pattern const& _pattern)
+	{
+		return _pattern.type() != Operation && _pattern.type() != Push;
+	};
+	auto select = [&](function<bool(Pattern const&)> const& _accepts)
+	{
+		vector<size_t> selected;
+		for (size_t i = 0; i < _rules.size(); ++i)
+			if (matchesAnything(patterns[i]) || _accepts(patterns[i]))
+				selected.push_back(_rules[i]);
+		return buildDecisionTree(selected, _argument + 1);
+	};
+
+	// Build the node separately, the recursion invalidates references into m_decisionNodes.
+	DecisionNode node;
+	node.isLeaf = false;
+	node.argument = _argument;
+	for (Instruction instruction: instructions)
+		node.byInstruction[instruction] = select([&](Pattern const& _pattern) {
+			return _pattern.type() == Operation && _pattern.instruction() == instruction;
+		});
+	for (u256 const& constant: constants)
+		node.byConstant[constant] = select([&](Pattern const& _pattern) {
+			return _pattern.type() == Push && (!_pattern.requiresDataMatch() || _pattern.data() == constant);
+		});
+	node.otherConstant = select([&](Pattern const& _pattern) {
+		return _pattern.type() == Push && !_pattern.requiresDataMatch();
+	});
+	node.other = select([&](Pattern const&) { return false; });
+	m_decisionNodes[index] = move(node);
+	return index;
 }
 
 template <class S> S divWorkaround(S const& _a, S const& _b)
@@ -92,7 +193,7 @@ Rules::Rules()
 	Y.setMatchGroup(5, m_matchGroups);
 	Z.setMatchGroup(6, m_matchGroups);
 
-	addRules(vector<pair<Pattern, function<Pattern()>>>{
+	addRules(vector<Rule>{
 		// arithmetics on constants
 		{{Instruction::ADD, {A, B}}, [=]{ return A.d() + B.d(); }},
 		{{Instruction::MUL, {A, B}}, [=]{ return A.d() * B.d(); }},
@@ -202,7 +303,7 @@ Rules::Rules()
 		// Moving constants to the outside, order matters here!
 		// we need actions that return expressions (or patterns?) here, and we need also reversed rules
 		// (X+A)+B -> X+(A+B)
-		addRules(vector<pair<Pattern, function<Pattern()>>>{{
+		addRules(vector<Rule>{{
 			{op, {{op, {X, A}}, B}},
 			[=]() -> Pattern { return {op, {X, fun(A.d(), B.d())}}; }
 		}, {
@@ -220,7 +321,7 @@ Rules::Rules()
 	}
 
 	// move constants across subtractions
-	addRules(vector<pair<Pattern, function<Pattern()>>>{
+	addRules(vector<Rule>{
 		{
 			// X - A -> X + (-A)
 			{Instruction::SUB, {X, A}},
@@ -243,6 +344,14 @@ Rules::Rules()
 			[=]() -> Pattern { return {Instruction::ADD, {{Instruction::SUB, {X, Y}}, 0 - A.d()}}; }
 		}
 	});
+
+	vector<vector<size_t>> rulesByInstruction(256);
+	for (size_t i = 0; i < m_rules.size(); ++i)
+		rulesByInstruction[byte(m_rules[i].first.instruction())].push_back(i);
+	for (size_t i = 0; i < 256; ++i)
+		m_decisionTrees[i] = rulesByInstruction[i].empty() ?
+			DecisionNode::none :
+			buildDecisionTree(rulesByInstruction[i], 0);
 }
 
 Pattern::Pattern(Instruction _instruction, std::vector<Pattern> const& _arguments):
@@ -25,7 +25,9 @@
 
 #include <libevmasm/ExpressionClasses.h>
 
+#include <array>
 #include <functional>
+#include <map>
 #include <vector>
 
 namespace dev
@@ -37,29 +39,66 @@ class Pattern;
 
 /**
  * Container for all simplification rules.
+ * For each instruction, the rules are compiled into a decision tree that dispatches on the
+ * instructions and constants found in the arguments of the expression, so that only rules
+ * whose arguments can match are tried.
  */
 class Rules: public boost::noncopyable
 {
 public:
 	using Expression = ExpressionClasses::Expression;
+	using Rule = std::pair<Pattern, std::function<Pattern()>>;
 
 	Rules();
 
+	/// @returns the rules used for all expression classes.
+	static Rules& standard();
+
 	/// @returns a pointer to the first matching pattern and sets the match
 	/// groups accordingly.
-	std::pair<Pattern, std::function<Pattern()>> const* findFirstMatch(
+	Rule const* findFirstMatch(
 		Expression const& _expr,
 		ExpressionClasses const& _classes
 	);
 
+	/// @returns the number of rules.
+	size_t size() const { return m_rules.size(); }
+	/// @returns the index of @a _rule (as returned by findFirstMatch) in the order the rules
+	/// were added.
+	size_t ruleIndex(Rule const& _rule) const;
+	/// @returns a human-readable form of the pattern of the rule with the given index.
+	std::string ruleDescription(size_t _index) const;
+
 private:
-	void addRules(std::vector<std::pair<Pattern, std::function<Pattern()>>> const& _rules);
-	void addRule(std::pair<Pattern, std::function<Pattern()>> const& _rule);
+	/// Node of the decision tree. Inner nodes select a child depending on the argument at
+	/// position @a argument of the expression, leaves list the rules to try in order.
+	struct DecisionNode
+	{
+		static size_t const none = size_t(-1);
+		bool isLeaf = true;
+		size_t argument = 0;
+		std::vector<size_t> rules;
+		std::map<Instruction, size_t> byInstruction;
+		std::map<u256, size_t> byConstant;
+		/// Child for constants not in byConstant.
+		size_t otherConstant = none;
+		/// Child for all other arguments.
+		size_t other = none;
+	};
+
+	void addRules(std::vector<Rule> const& _rules);
+	void addRule(Rule const& _rule);
+	/// Builds the decision tree for the given rules (all for the same instruction), starting
+	/// at the argument with index @a _argument. @returns the index of its root.
+	size_t buildDecisionTree(std::vector<size_t> const& _rules, size_t _argument);
 
 	void resetMatchGroups() { m_matchGroups.clear(); }
 
 	std::map<unsigned, Expression const*> m_matchGroups;
-	std::vector<std::pair<Pattern, std::function<Pattern()>>> m_rules[256];
+	std::vector<Rule> m_rules;
+	std::vector<DecisionNode> m_decisionNodes;
+	/// Root of the decision tree for each instruction, if there are rules for it.
+	std::array<size_t, 256> m_decisionTrees;
 };
 
 /**
@@ -94,7 +133,7 @@ public:
 	/// @returns the id of the matched expression if this pattern is part of a match group.
 	Id id() const { return matchGroupValue().id; }
 	/// @returns the data of the matched expression if this pattern is part of a match group.
-	u256 const& d() const { return matchGroupValue().item->data(); }
+	u256 d() const { return matchGroupValue().item->data(); }
 
 	std::string toString() const;
 
@@ -104,11 +143,13 @@ public:
 		assertThrow(type() == Operation, OptimizerException, "");
 		return m_instruction;
 	}
+	/// @returns true if this pattern only matches a specific constant, which is returned by data().
+	bool requiresDataMatch() const { return m_requireDataMatch; }
+	u256 const& data() const;
 
 private:
 	bool matchesBaseItem(AssemblyItem const* _item) const;
 	Expression const& matchGroupValue() const;
-	u256 const& data() const;
 
 	AssemblyItemType m_type;
 	bool m_requireDataMatch = false;
@@ -47,7 +47,7 @@ public:
 	/// @param _identifierAccess used to resolve identifiers external to the inline assembly
 	CodeTransform(
 		julia::AbstractAssembly& _assembly,
-		solidity::assembly::AsmAnalysisInfo& _analysisInfo,
+		solidity::assembly::AsmAnalysisInfo const& _analysisInfo,
 		bool _julia = false,
 		bool _evm15 = false,
 		ExternalIdentifierAccess const& _identifierAccess = ExternalIdentifierAccess(),
@@ -76,7 +76,7 @@ protected:
 
 	CodeTransform(
 		julia::AbstractAssembly& _assembly,
-		solidity::assembly::AsmAnalysisInfo& _analysisInfo,
+		solidity::assembly::AsmAnalysisInfo const& _analysisInfo,
 		bool _julia,
 		bool _evm15,
 		ExternalIdentifierAccess const& _identifierAccess,
@@ -138,7 +138,7 @@ private:
 	void checkStackHeight(void const* _astElement);
 
 	julia::AbstractAssembly& m_assembly;
-	solidity::assembly::AsmAnalysisInfo& m_info;
+	solidity::assembly::AsmAnalysisInfo const& m_info;
 	solidity::assembly::Scope* m_scope = nullptr;
 	bool m_julia = false;
 	bool m_evm15 = false;
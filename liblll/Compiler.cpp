@@ -33,6 +33,7 @@ bytes dev::eth::compileLLL(string const& _src, bool _opt, vector<string>* _error
 {
 	try
 	{
+		AssemblyItemTables::Scope itemScope(make_shared<AssemblyItemTables>());
 		CompilerState cs;
 		cs.populateStandard();
 		auto assembly = CodeFragment::compile(_src, cs, _readFile).assembly(cs);
@@ -71,6 +72,7 @@ std::string dev::eth::compileLLLToAsm(std::string const& _src, bool _opt, std::v
 {
 	try
 	{
+		AssemblyItemTables::Scope itemScope(make_shared<AssemblyItemTables>());
 		CompilerState cs;
 		cs.populateStandard();
 		auto assembly = CodeFragment::compile(_src, cs, _readFile).assembly(cs);
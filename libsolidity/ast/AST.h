@@ -23,6 +23,7 @@
 #pragma once
 
 #include <libsolidity/ast/ASTForward.h>
+#include <libsolidity/ast/ASTArena.h>
 #include <libsolidity/parsing/Token.h>
 #include <libsolidity/ast/Types.h>
 #include <libsolidity/ast/ASTAnnotations.h>
@@ -121,7 +122,11 @@ std::vector<_T const *> ASTNode::filteredNodes(std::vector<ASTPointer<ASTNode>>
 class SourceUnit : public ASTNode
 {
   public:
-	SourceUnit(SourceLocation const &_location, std::vector<ASTPointer<ASTNode>> const &_nodes) : ASTNode(_location), m_nodes(_nodes) {}
+	SourceUnit(
+		SourceLocation const &_location,
+		std::vector<ASTPointer<ASTNode>> const &_nodes,
+		ASTArenaPointer const &_arena = ASTArenaPointer()
+	) : ASTNode(_location), m_nodes(_nodes), m_arena(_arena) {}
 
 	virtual void accept(ASTVisitor &_visitor) override;
 	virtual void accept(ASTConstVisitor &_visitor) const override;
@@ -132,8 +137,13 @@ class SourceUnit : public ASTNode
 	/// @returns a set of referenced SourceUnits. Recursively if @a _recurse is true.
 	std::set<SourceUnit const *> referencedSourceUnits(bool _recurse = false, std::set<SourceUnit const *> _skipList = std::set<SourceUnit const *>()) const;
 
+	/// @returns the arena the nodes of this source unit are allocated in, or nullptr if they live on the heap.
+	/// Nodes added to the source unit later on can be created in the same arena through makeArenaNode.
+	ASTArenaPointer const &arena() const { return m_arena; }
+
   private:
 	std::vector<ASTPointer<ASTNode>> m_nodes;
+	ASTArenaPointer m_arena;
 };
 
 /**
@@ -0,0 +1,51 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Arena allocation for AST nodes.
+ */
+
+#include <libsolidity/ast/ASTArena.h>
+#include <libsolidity/interface/Exceptions.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+void* ASTArena::allocate(size_t _size, size_t _alignment)
+{
+	solAssert(_alignment > 0 && (_alignment & (_alignment - 1)) == 0, "Invalid alignment.");
+	size_t padding = (_alignment - reinterpret_cast<uintptr_t>(m_current) % _alignment) % _alignment;
+	if (!m_current || padding + _size > m_remaining)
+	{
+		// Oversized requests get a chunk of their own.
+		size_t chunkSize = max(m_chunkSize, _size + _alignment);
+		m_chunks.emplace_back(new char[chunkSize]);
+		m_current = m_chunks.back().get();
+		m_remaining = chunkSize;
+		m_reservedBytes += chunkSize;
+		m_chunkSize = min(2 * m_chunkSize, m_maxChunkSize);
+		padding = (_alignment - reinterpret_cast<uintptr_t>(m_current) % _alignment) % _alignment;
+	}
+	char* result = m_current + padding;
+	m_current += padding + _size;
+	m_remaining -= padding + _size;
+	++m_allocationCount;
+	m_allocatedBytes += _size;
+	return result;
+}
@@ -0,0 +1,115 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Arena allocation for AST nodes.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTForward.h>
+
+#include <boost/intrusive_ptr.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+using ASTArenaPointer = boost::intrusive_ptr<ASTArena>;
+
+/**
+ * Bump-pointer memory arena for the nodes of one source unit.
+ * Memory is never returned to the arena individually, it is released as a whole once the
+ * arena is destroyed. Every node allocated from the arena keeps it alive through its allocator,
+ * so the arena is destroyed together with the last of its nodes.
+ * The reference count is not atomic: ASTs are only ever built and destroyed on a single thread.
+ */
+class ASTArena: private boost::noncopyable
+{
+public:
+	/// Chunks start at @a _initialChunkSize and double in size up to @a _maxChunkSize,
+	/// so that small sources do not reserve large amounts of memory.
+	explicit ASTArena(size_t _initialChunkSize = 2 * 1024, size_t _maxChunkSize = 32 * 1024):
+		m_chunkSize(_initialChunkSize), m_maxChunkSize(_maxChunkSize) {}
+
+	void* allocate(size_t _size, size_t _alignment);
+
+	/// @returns the number of allocations served by the arena.
+	size_t allocationCount() const { return m_allocationCount; }
+	/// @returns the number of bytes handed out by the arena (excluding padding).
+	size_t allocatedBytes() const { return m_allocatedBytes; }
+	/// @returns the number of bytes reserved from the system.
+	size_t reservedBytes() const { return m_reservedBytes; }
+
+	friend void intrusive_ptr_add_ref(ASTArena* _arena) { ++_arena->m_references; }
+	friend void intrusive_ptr_release(ASTArena* _arena) { if (--_arena->m_references == 0) delete _arena; }
+
+private:
+	size_t m_references = 0;
+	size_t m_chunkSize;
+	size_t m_maxChunkSize;
+	std::vector<std::unique_ptr<char[]>> m_chunks;
+	char* m_current = nullptr;
+	size_t m_remaining = 0;
+	size_t m_allocationCount = 0;
+	size_t m_allocatedBytes = 0;
+	size_t m_reservedBytes = 0;
+};
+
+/**
+ * Standard allocator handing out memory from an ASTArena. Deallocation is a no-op.
+ */
+template <class T>
+class ASTArenaAllocator
+{
+public:
+	using value_type = T;
+
+	explicit ASTArenaAllocator(ASTArenaPointer _arena): m_arena(std::move(_arena)) {}
+	template <class U>
+	ASTArenaAllocator(ASTArenaAllocator<U> const& _other): m_arena(_other.arena()) {}
+
+	T* allocate(size_t _n) { return static_cast<T*>(m_arena->allocate(_n * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) {}
+
+	ASTArenaPointer const& arena() const { return m_arena; }
+
+	template <class U>
+	bool operator==(ASTArenaAllocator<U> const& _other) const { return m_arena == _other.arena(); }
+	template <class U>
+	bool operator!=(ASTArenaAllocator<U> const& _other) const { return m_arena != _other.arena(); }
+
+private:
+	ASTArenaPointer m_arena;
+};
+
+/// Creates an AST node (together with its reference count) in @a _arena,
+/// or on the heap if no arena is given.
+template <class NodeType, typename... Args>
+ASTPointer<NodeType> makeArenaNode(ASTArenaPointer const& _arena, Args&&... _args)
+{
+	if (!_arena)
+		return std::make_shared<NodeType>(std::forward<Args>(_args)...);
+	return std::allocate_shared<NodeType>(ASTArenaAllocator<NodeType>(_arena), std::forward<Args>(_args)...);
+}
+
+}
+}
@@ -88,9 +88,10 @@ class Literal;
 
 class VariableScope;
 
-// Used as pointers to AST nodes, to be replaced by more clever pointers, e.g. pointers which do
-// not do reference counting but point to a special memory area that is completely released
-// explicitly.
+class ASTArena;
+
+// Used as pointers to AST nodes. Nodes created by the parser live in an ASTArena, see
+// makeArenaNode.
 template <class T>
 using ASTPointer = std::shared_ptr<T>;
 
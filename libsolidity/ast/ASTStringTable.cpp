@@ -0,0 +1,37 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Table of interned identifiers and literals used by the AST.
+ */
+
+#include <libsolidity/ast/ASTStringTable.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+ASTPointer<ASTString> const& ASTStringTable::intern(string const& _string)
+{
+	++m_lookups;
+	auto it = m_strings.find(boost::string_ref(_string));
+	if (it != m_strings.end())
+		return it->second;
+	auto interned = make_shared<ASTString>(_string);
+	m_characters += interned->size();
+	// The key refers to the characters of the interned string, which are never modified.
+	return m_strings.emplace(boost::string_ref(*interned), interned).first->second;
+}
@@ -0,0 +1,67 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Table of interned identifiers and literals used by the AST.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTForward.h>
+
+#include <boost/functional/hash.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include <unordered_map>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Interns the identifiers, member names and literals of the ASTs of one compilation, so that
+ * equal names share a single ASTString instead of each node allocating its own copy.
+ * Interned strings are shared between nodes and must not be modified.
+ */
+class ASTStringTable: private boost::noncopyable
+{
+public:
+	/// @returns the interned instance of @a _string, creating it if it does not exist yet.
+	ASTPointer<ASTString> const& intern(std::string const& _string);
+
+	/// @returns the number of distinct strings in the table.
+	size_t size() const { return m_strings.size(); }
+	/// @returns the number of calls to intern.
+	size_t lookups() const { return m_lookups; }
+	/// @returns the number of characters stored in the table.
+	size_t characters() const { return m_characters; }
+
+private:
+	struct Hash
+	{
+		size_t operator()(boost::string_ref const& _string) const { return boost::hash_range(_string.begin(), _string.end()); }
+	};
+
+	/// Maps from a reference to the contents of each interned string to the string itself.
+	std::unordered_map<boost::string_ref, ASTPointer<ASTString>, Hash> m_strings;
+	size_t m_lookups = 0;
+	size_t m_characters = 0;
+};
+
+}
+}
@@ -21,6 +21,7 @@
  */
 
 #include <libsolidity/ast/ASTUtils.h>
+#include <libsolidity/ast/AST.h>
 
 using namespace std;
 using namespace dev;
@@ -46,3 +47,10 @@ bool LocationFinder::visitNode(const ASTNode& _node)
 	}
 	return false;
 }
+
+VariableDeclaration const* dev::solidity::referencedVariable(Expression const* _expression)
+{
+	if (auto identifier = dynamic_cast<Identifier const*>(_expression))
+		return dynamic_cast<VariableDeclaration const*>(identifier->annotation().referencedDeclaration);
+	return nullptr;
+}
@@ -50,5 +50,8 @@ private:
 	ASTNode const* m_bestMatch = nullptr;
 };
 
+/// @returns the variable @a _expression refers to if it is an identifier and nullptr otherwise.
+VariableDeclaration const* referencedVariable(Expression const* _expression);
+
 }
 }
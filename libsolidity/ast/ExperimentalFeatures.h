@@ -32,6 +32,7 @@ enum class ExperimentalFeature
 	SMTChecker,
 	ABIEncoderV2, // new ABI encoder that makes use of JULIA
 	V050, // v0.5.0 breaking changes
+	StoragePacking, // reorder state variables and struct members to occupy fewer storage slots
 	Test,
 	TestOnlyAnalysis
 };
@@ -47,6 +48,7 @@ static const std::map<std::string, ExperimentalFeature> ExperimentalFeatureNames
 	{ "SMTChecker", ExperimentalFeature::SMTChecker },
 	{ "ABIEncoderV2", ExperimentalFeature::ABIEncoderV2 },
 	{ "v0.5.0", ExperimentalFeature::V050 },
+	{ "StoragePacking", ExperimentalFeature::StoragePacking },
 	{ "__test", ExperimentalFeature::Test },
 	{ "__testOnlyAnalysis", ExperimentalFeature::TestOnlyAnalysis },
 };
@@ -0,0 +1,138 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Canonical instances of types.
+ */
+
+#include <libsolidity/ast/TypeProvider.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+thread_local TypeProvider* TypeProvider::s_current = nullptr;
+
+TypeProvider::Scope::Scope(TypeProvider& _provider):
+	m_previous(s_current)
+{
+	s_current = &_provider;
+}
+
+TypeProvider::Scope::~Scope()
+{
+	s_current = m_previous;
+}
+
+TypeProvider& TypeProvider::instance()
+{
+	solAssert(s_current, "Types requested outside of a TypeProvider::Scope.");
+	return *s_current;
+}
+
+shared_ptr<BoolType const> const& TypeProvider::boolean()
+{
+	TypeProvider& provider = instance();
+	if (!provider.m_boolean)
+		provider.m_boolean = make_shared<BoolType>();
+	return provider.m_boolean;
+}
+
+shared_ptr<IntegerType const> const& TypeProvider::integer(unsigned _bits, IntegerType::Modifier _modifier)
+{
+	TypeProvider& provider = instance();
+	if (_modifier == IntegerType::Modifier::Address)
+	{
+		if (!provider.m_address)
+			provider.m_address = make_shared<IntegerType>(_bits, _modifier);
+		solAssert(_bits == 160, "");
+		return provider.m_address;
+	}
+	solAssert(_bits > 0 && _bits <= 256 && _bits % 8 == 0, "Invalid bit number for integer type: " + dev::toString(_bits));
+	auto& type = provider.m_integers[_modifier == IntegerType::Modifier::Signed][_bits / 8 - 1];
+	if (!type)
+		type = make_shared<IntegerType>(_bits, _modifier);
+	return type;
+}
+
+shared_ptr<FixedBytesType const> const& TypeProvider::fixedBytes(unsigned _bytes)
+{
+	solAssert(_bytes <= 32, "Invalid byte number for fixed bytes type: " + dev::toString(_bytes));
+	auto& type = instance().m_fixedBytes[_bytes];
+	if (!type)
+		type = make_shared<FixedBytesType>(_bytes);
+	return type;
+}
+
+shared_ptr<FixedPointType const> const& TypeProvider::fixedPoint(
+	unsigned _totalBits,
+	unsigned _fractionalDigits,
+	FixedPointType::Modifier _modifier
+)
+{
+	auto& type = instance().m_fixedPoints[make_tuple(_totalBits, _fractionalDigits, _modifier)];
+	if (!type)
+		type = make_shared<FixedPointType>(_totalBits, _fractionalDigits, _modifier);
+	return type;
+}
+
+shared_ptr<ArrayType const> const& TypeProvider::byteArray(DataLocation _location, bool _isString)
+{
+	auto& type = instance().m_byteArrays[unsigned(_location)][_isString];
+	if (!type)
+		type = make_shared<ArrayType>(_location, _isString);
+	return type;
+}
+
+shared_ptr<ArrayType const> const& TypeProvider::array(DataLocation _location, TypePointer const& _baseType)
+{
+	solAssert(_baseType, "");
+	auto& interned = instance().m_arrays[make_tuple(_location, _baseType.get(), true, u256(0))];
+	if (!interned.type)
+	{
+		interned.components = TypePointers{_baseType};
+		interned.type = make_shared<ArrayType>(_location, _baseType);
+	}
+	return interned.type;
+}
+
+shared_ptr<ArrayType const> const& TypeProvider::array(
+	DataLocation _location,
+	TypePointer const& _baseType,
+	u256 const& _length
+)
+{
+	solAssert(_baseType, "");
+	auto& interned = instance().m_arrays[make_tuple(_location, _baseType.get(), false, _length)];
+	if (!interned.type)
+	{
+		interned.components = TypePointers{_baseType};
+		interned.type = make_shared<ArrayType>(_location, _baseType, _length);
+	}
+	return interned.type;
+}
+
+shared_ptr<MappingType const> const& TypeProvider::mapping(TypePointer const& _keyType, TypePointer const& _valueType)
+{
+	solAssert(_keyType && _valueType, "");
+	auto& interned = instance().m_mappings[make_pair(_keyType.get(), _valueType.get())];
+	if (!interned.type)
+	{
+		interned.components = TypePointers{_keyType, _valueType};
+		interned.type = make_shared<MappingType>(_keyType, _valueType);
+	}
+	return interned.type;
+}
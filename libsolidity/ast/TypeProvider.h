@@ -0,0 +1,131 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Canonical instances of types.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/Types.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Hands out canonical, shared instances of types, so that frequently used types are not
+ * re-allocated at every use and their member lists are only computed once.
+ *
+ * Elementary types are singletons. Mappings and arrays are interned by the identity of their
+ * component types, so they are shared whenever their components are (as it is the case for
+ * elementary components).
+ *
+ * The member lists cached in the canonical types depend on the contracts they are accessed from,
+ * so canonical types must not outlive the source units they are used with. Because of that, every
+ * compilation owns a provider and makes it the one the static functions below use while it
+ * analyses and compiles (@see Scope). Requesting a type outside of any scope is an error.
+ */
+class TypeProvider: private boost::noncopyable
+{
+public:
+	static std::shared_ptr<BoolType const> const& boolean();
+
+	/// @returns the integer type of @a _bits bits, which has to be a multiple of 8 between 8 and 256.
+	static std::shared_ptr<IntegerType const> const& integer(
+		unsigned _bits,
+		IntegerType::Modifier _modifier = IntegerType::Modifier::Unsigned
+	);
+	static std::shared_ptr<IntegerType const> const& uint256() { return integer(256); }
+	static std::shared_ptr<IntegerType const> const& address() { return integer(160, IntegerType::Modifier::Address); }
+
+	/// @returns the fixed bytes type of @a _bytes bytes, which has to be at most 32.
+	static std::shared_ptr<FixedBytesType const> const& fixedBytes(unsigned _bytes);
+	static std::shared_ptr<FixedPointType const> const& fixedPoint(
+		unsigned _totalBits,
+		unsigned _fractionalDigits,
+		FixedPointType::Modifier _modifier
+	);
+
+	/// @returns the type of "bytes" or "string" at the given location (as pointers).
+	static std::shared_ptr<ArrayType const> const& byteArray(DataLocation _location, bool _isString = false);
+	static std::shared_ptr<ArrayType const> const& bytesStorage() { return byteArray(DataLocation::Storage); }
+	static std::shared_ptr<ArrayType const> const& bytesMemory() { return byteArray(DataLocation::Memory); }
+	static std::shared_ptr<ArrayType const> const& stringStorage() { return byteArray(DataLocation::Storage, true); }
+	static std::shared_ptr<ArrayType const> const& stringMemory() { return byteArray(DataLocation::Memory, true); }
+
+	/// @returns the dynamically sized array type with the given base type.
+	static std::shared_ptr<ArrayType const> const& array(DataLocation _location, TypePointer const& _baseType);
+	/// @returns the statically sized array type with the given base type.
+	static std::shared_ptr<ArrayType const> const& array(
+		DataLocation _location,
+		TypePointer const& _baseType,
+		u256 const& _length
+	);
+
+	static std::shared_ptr<MappingType const> const& mapping(TypePointer const& _keyType, TypePointer const& _valueType);
+
+	/**
+	 * Makes a provider the one that hands out types on the current thread for the lifetime of
+	 * the scope object.
+	 */
+	class Scope: private boost::noncopyable
+	{
+	public:
+		explicit Scope(TypeProvider& _provider);
+		~Scope();
+
+	private:
+		TypeProvider* m_previous;
+	};
+
+	TypeProvider() = default;
+
+private:
+	/// @returns the provider of the innermost scope of the current thread, which has to exist.
+	static TypeProvider& instance();
+	/// The provider of the innermost scope of the current thread, if any.
+	static thread_local TypeProvider* s_current;
+
+	std::shared_ptr<BoolType const> m_boolean;
+	/// Signed and unsigned integer types, indexed by modifier and number of bytes - 1.
+	std::array<std::array<std::shared_ptr<IntegerType const>, 32>, 2> m_integers;
+	std::shared_ptr<IntegerType const> m_address;
+	std::array<std::shared_ptr<FixedBytesType const>, 33> m_fixedBytes;
+	std::map<std::tuple<unsigned, unsigned, FixedPointType::Modifier>, std::shared_ptr<FixedPointType const>> m_fixedPoints;
+	/// Byte arrays and strings, indexed by location and whether they are strings.
+	std::array<std::array<std::shared_ptr<ArrayType const>, 2>, 3> m_byteArrays;
+
+	/// Interned compound types keep their component types alive, so that the addresses used as
+	/// keys are not reused by other types.
+	template <class T>
+	struct Interned
+	{
+		TypePointers components;
+		std::shared_ptr<T const> type;
+	};
+	std::map<std::tuple<DataLocation, Type const*, bool, u256>, Interned<ArrayType>> m_arrays;
+	std::map<std::pair<Type const*, Type const*>, Interned<MappingType>> m_mappings;
+};
+
+}
+}
@@ -21,6 +21,7 @@
  */
 
 #include <libsolidity/ast/Types.h>
+#include <libsolidity/ast/TypeProvider.h>
 
 #include <libsolidity/ast/AST.h>
 
@@ -45,10 +46,19 @@ using namespace dev::solidity;
 
 void StorageOffsets::computeOffsets(TypePointers const& _types)
 {
+	vector<size_t> order(_types.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	computeOffsets(_types, order);
+}
+
+void StorageOffsets::computeOffsets(TypePointers const& _types, vector<size_t> const& _order)
+{
+	solAssert(_order.size() == _types.size(), "");
 	bigint slotOffset = 0;
 	unsigned byteOffset = 0;
 	map<size_t, pair<u256, unsigned>> offsets;
-	for (size_t i = 0; i < _types.size(); ++i)
+	for (size_t i: _order)
 	{
 		TypePointer const& type = _types[i];
 		if (!type->canBeStored())
@@ -79,6 +89,52 @@ void StorageOffsets::computeOffsets(TypePointers const& _types)
 	swap(m_offsets, offsets);
 }
 
+vector<size_t> StorageOffsets::packedOrder(TypePointers const& _types)
+{
+	// Elements that take a slot on their own, keyed by their index, and bins of elements
+	// that share a slot, each holding at most 32 bytes.
+	map<size_t, vector<size_t>> units;
+	vector<size_t> small;
+	for (size_t i = 0; i < _types.size(); ++i)
+		if (_types[i]->canBeStored() && _types[i]->storageSize() == 1 && _types[i]->storageBytes() < 32)
+			small.push_back(i);
+		else
+			units[i] = vector<size_t>{i};
+	stable_sort(small.begin(), small.end(), [&](size_t _a, size_t _b) {
+		return _types[_a]->storageBytes() > _types[_b]->storageBytes();
+	});
+	vector<vector<size_t>> bins;
+	vector<unsigned> binBytes;
+	for (size_t i: small)
+	{
+		unsigned bytes = _types[i]->storageBytes();
+		size_t bin = 0;
+		while (bin < bins.size() && binBytes[bin] + bytes > 32)
+			++bin;
+		if (bin == bins.size())
+		{
+			bins.push_back({});
+			binBytes.push_back(0);
+		}
+		bins[bin].push_back(i);
+		binBytes[bin] += bytes;
+	}
+	for (vector<size_t>& bin: bins)
+	{
+		// Keep the declaration order inside a slot.
+		sort(bin.begin(), bin.end());
+		units[bin.front()] = move(bin);
+	}
+
+	// Since every bin fits into a slot, placing the units one after the other never needs
+	// more slots than there are bins and larger elements.
+	vector<size_t> order;
+	order.reserve(_types.size());
+	for (auto const& unit: units)
+		order += unit.second;
+	return order;
+}
+
 pair<u256, unsigned> const* StorageOffsets::offset(size_t _index) const
 {
 	if (m_offsets.count(_index))
@@ -101,7 +157,7 @@ void MemberList::combine(MemberList const & _other)
 	m_memberTypes += _other.m_memberTypes;
 }
 
-pair<u256, unsigned> const* MemberList::memberStorageOffset(string const& _name) const
+pair<u256, unsigned> const* MemberList::memberStorageOffset(string const& _name, bool _packed) const
 {
 	if (!m_storageOffsets)
 	{
@@ -110,7 +166,10 @@ pair<u256, unsigned> const* MemberList::memberStorageOffset(string const& _name)
 		for (auto const& member: m_memberTypes)
 			memberTypes.push_back(member.type);
 		m_storageOffsets.reset(new StorageOffsets());
-		m_storageOffsets->computeOffsets(memberTypes);
+		if (_packed)
+			m_storageOffsets->computeOffsets(memberTypes, StorageOffsets::packedOrder(memberTypes));
+		else
+			m_storageOffsets->computeOffsets(memberTypes);
 	}
 	for (size_t index = 0; index < m_memberTypes.size(); ++index)
 		if (m_memberTypes[index].name == _name)
@@ -118,10 +177,10 @@ pair<u256, unsigned> const* MemberList::memberStorageOffset(string const& _name)
 	return nullptr;
 }
 
-u256 const& MemberList::storageSize() const
+u256 const& MemberList::storageSize(bool _packed) const
 {
 	// trigger lazy computation
-	memberStorageOffset("");
+	memberStorageOffset("", _packed);
 	return m_storageOffsets->storageSize();
 }
 
@@ -183,33 +242,33 @@ TypePointer Type::fromElementaryTypeName(ElementaryTypeNameToken const& _type)
 	switch (token)
 	{
 	case Token::IntM:
-		return make_shared<IntegerType>(m, IntegerType::Modifier::Signed);
+		return TypeProvider::integer(m, IntegerType::Modifier::Signed);
 	case Token::UIntM:
-		return make_shared<IntegerType>(m, IntegerType::Modifier::Unsigned);
+		return TypeProvider::integer(m, IntegerType::Modifier::Unsigned);
 	case Token::BytesM:
-		return make_shared<FixedBytesType>(m);
+		return TypeProvider::fixedBytes(m);
 	case Token::FixedMxN:
-		return make_shared<FixedPointType>(m, n, FixedPointType::Modifier::Signed);
+		return TypeProvider::fixedPoint(m, n, FixedPointType::Modifier::Signed);
 	case Token::UFixedMxN:
-		return make_shared<FixedPointType>(m, n, FixedPointType::Modifier::Unsigned);
+		return TypeProvider::fixedPoint(m, n, FixedPointType::Modifier::Unsigned);
 	case Token::Int:
-		return make_shared<IntegerType>(256, IntegerType::Modifier::Signed);
+		return TypeProvider::integer(256, IntegerType::Modifier::Signed);
 	case Token::UInt:
-		return make_shared<IntegerType>(256, IntegerType::Modifier::Unsigned);
+		return TypeProvider::integer(256, IntegerType::Modifier::Unsigned);
 	case Token::Fixed:
-		return make_shared<FixedPointType>(128, 19, FixedPointType::Modifier::Signed);
+		return TypeProvider::fixedPoint(128, 19, FixedPointType::Modifier::Signed);
 	case Token::UFixed:
-		return make_shared<FixedPointType>(128, 19, FixedPointType::Modifier::Unsigned);
+		return TypeProvider::fixedPoint(128, 19, FixedPointType::Modifier::Unsigned);
 	case Token::Byte:
-		return make_shared<FixedBytesType>(1);
+		return TypeProvider::fixedBytes(1);
 	case Token::Address:
-		return make_shared<IntegerType>(160, IntegerType::Modifier::Address);
+		return TypeProvider::address();
 	case Token::Bool:
-		return make_shared<BoolType>();
+		return TypeProvider::boolean();
 	case Token::Bytes:
-		return make_shared<ArrayType>(DataLocation::Storage);
+		return TypeProvider::byteArray(DataLocation::Storage);
 	case Token::String:
-		return make_shared<ArrayType>(DataLocation::Storage, true);
+		return TypeProvider::byteArray(DataLocation::Storage, true);
 	//no types found
 	default:
 		solAssert(
@@ -234,7 +293,7 @@ TypePointer Type::forLiteral(Literal const& _literal)
 	{
 	case Token::TrueLiteral:
 	case Token::FalseLiteral:
-		return make_shared<BoolType>();
+		return TypeProvider::boolean();
 	case Token::Number:
 	{
 		tuple<bool, rational> validLiteral = RationalNumberType::isValidLiteral(_literal);
@@ -1003,7 +1062,7 @@ shared_ptr<IntegerType const> RationalNumberType::integerType() const
 	if (value > u256(-1))
 		return shared_ptr<IntegerType const>();
 	else
-		return make_shared<IntegerType>(
+		return TypeProvider::integer(
 			max(bytesRequired(value), 1u) * 8,
 			negative ? IntegerType::Modifier::Signed : IntegerType::Modifier::Unsigned
 		);
@@ -1039,7 +1098,7 @@ shared_ptr<FixedPointType const> RationalNumberType::fixedPointType() const
 	unsigned totalBits = max(bytesRequired(v), 1u) * 8;
 	solAssert(totalBits <= 256, "");
 
-	return make_shared<FixedPointType>(
+	return TypeProvider::fixedPoint(
 		totalBits, fractionalDigits,
 		negative ? FixedPointType::Modifier::Signed : FixedPointType::Modifier::Unsigned
 	);
@@ -1089,7 +1148,7 @@ std::string StringLiteralType::toString(bool) const
 
 TypePointer StringLiteralType::mobileType() const
 {
-	return make_shared<ArrayType>(DataLocation::Memory, true);
+	return TypeProvider::byteArray(DataLocation::Memory, true);
 }
 
 bool StringLiteralType::isValidUTF8() const
@@ -1097,11 +1156,11 @@ bool StringLiteralType::isValidUTF8() const
 	return dev::validateUTF8(m_value);
 }
 
-shared_ptr<FixedBytesType> FixedBytesType::smallestTypeForLiteral(string const& _literal)
+shared_ptr<FixedBytesType const> FixedBytesType::smallestTypeForLiteral(string const& _literal)
 {
 	if (_literal.length() <= 32)
-		return make_shared<FixedBytesType>(_literal.length());
-	return shared_ptr<FixedBytesType>();
+		return TypeProvider::fixedBytes(_literal.length());
+	return shared_ptr<FixedBytesType const>();
 }
 
 FixedBytesType::FixedBytesType(int _bytes): m_bytes(_bytes)
@@ -1160,7 +1219,7 @@ TypePointer FixedBytesType::binaryOperatorResult(Token::Value _operator, TypePoi
 
 MemberList::MemberMap FixedBytesType::nativeMembers(const ContractDefinition*) const
 {
-	return MemberList::MemberMap{MemberList::Member{"length", make_shared<IntegerType>(8)}};
+	return MemberList::MemberMap{MemberList::Member{"length", TypeProvider::integer(8)}};
 }
 
 string FixedBytesType::identifier() const
@@ -1301,6 +1360,13 @@ string ReferenceType::identifierLocationSuffix() const
 	return id;
 }
 
+ArrayType::ArrayType(DataLocation _location, bool _isString):
+	ReferenceType(_location),
+	m_arrayKind(_isString ? ArrayKind::String : ArrayKind::Bytes),
+	m_baseType(TypeProvider::fixedBytes(1))
+{
+}
+
 bool ArrayType::isImplicitlyConvertibleTo(const Type& _convertTo) const
 {
 	if (_convertTo.category() != category())
@@ -1379,6 +1445,8 @@ string ArrayType::identifier() const
 
 bool ArrayType::operator==(Type const& _other) const
 {
+	if (&_other == this)
+		return true;
 	if (_other.category() != category())
 		return false;
 	ArrayType const& other = dynamic_cast<ArrayType const&>(_other);
@@ -1508,11 +1576,11 @@ MemberList::MemberMap ArrayType::nativeMembers(ContractDefinition const*) const
 	MemberList::MemberMap members;
 	if (!isString())
 	{
-		members.push_back({"length", make_shared<IntegerType>(256)});
+		members.push_back({"length", TypeProvider::uint256()});
 		if (isDynamicallySized() && location() == DataLocation::Storage)
 			members.push_back({"push", make_shared<FunctionType>(
 				TypePointers{baseType()},
-				TypePointers{make_shared<IntegerType>(256)},
+				TypePointers{TypeProvider::uint256()},
 				strings{string()},
 				strings{string()},
 				isByteArray() ? FunctionType::Kind::ByteArrayPush : FunctionType::Kind::ArrayPush
@@ -1524,7 +1592,7 @@ MemberList::MemberMap ArrayType::nativeMembers(ContractDefinition const*) const
 TypePointer ArrayType::encodingType() const
 {
 	if (location() == DataLocation::Storage)
-		return make_shared<IntegerType>(256);
+		return TypeProvider::uint256();
 	else
 		return this->copyForLocation(DataLocation::Memory, true);
 }
@@ -1532,7 +1600,7 @@ TypePointer ArrayType::encodingType() const
 TypePointer ArrayType::decodingType() const
 {
 	if (location() == DataLocation::Storage)
-		return make_shared<IntegerType>(256);
+		return TypeProvider::uint256();
 	else
 		return shared_from_this();
 }
@@ -1550,9 +1618,9 @@ TypePointer ArrayType::interfaceType(bool _inLibrary) const
 		return TypePointer();
 
 	if (isDynamicallySized())
-		return make_shared<ArrayType>(DataLocation::Memory, baseExt);
+		return TypeProvider::array(DataLocation::Memory, baseExt);
 	else
-		return make_shared<ArrayType>(DataLocation::Memory, baseExt, m_length);
+		return TypeProvider::array(DataLocation::Memory, baseExt, m_length);
 }
 
 bool ArrayType::canBeUsedExternally(bool _inLibrary) const
@@ -1611,6 +1679,11 @@ string ContractType::toString(bool) const
 		m_contract.name();
 }
 
+TypePointer ContractType::encodingType() const
+{
+	return TypeProvider::address();
+}
+
 string ContractType::canonicalName() const
 {
 	return m_contract.annotation().canonicalName;
@@ -1712,15 +1785,30 @@ shared_ptr<FunctionType const> const& ContractType::newExpressionType() const
 vector<tuple<VariableDeclaration const*, u256, unsigned>> ContractType::stateVariables() const
 {
 	vector<VariableDeclaration const*> variables;
+	TypePointers types;
+	vector<size_t> order;
 	for (ContractDefinition const* contract: boost::adaptors::reverse(m_contract.annotation().linearizedBaseContracts))
+	{
+		// The variables of each contract are placed after those of its bases, so that
+		// the layout of a base does not depend on the contracts derived from it.
+		size_t first = variables.size();
+		TypePointers contractTypes;
 		for (VariableDeclaration const* variable: contract->stateVariables())
 			if (!variable->isConstant())
+			{
 				variables.push_back(variable);
-	TypePointers types;
-	for (auto variable: variables)
-		types.push_back(variable->annotation().type);
+				contractTypes.push_back(variable->annotation().type);
+			}
+		types += contractTypes;
+		if (contract->sourceUnit().annotation().experimentalFeatures.count(ExperimentalFeature::StoragePacking))
+			for (size_t index: StorageOffsets::packedOrder(contractTypes))
+				order.push_back(first + index);
+		else
+			for (size_t index = first; index < variables.size(); ++index)
+				order.push_back(index);
+	}
 	StorageOffsets offsets;
-	offsets.computeOffsets(types);
+	offsets.computeOffsets(types, order);
 
 	vector<tuple<VariableDeclaration const*, u256, unsigned>> variablesAndOffsets;
 	for (size_t index = 0; index < variables.size(); ++index)
@@ -1794,7 +1882,7 @@ u256 StructType::memorySize() const
 
 u256 StructType::storageSize() const
 {
-	return max<u256>(1, members(nullptr).storageSize());
+	return max<u256>(1, members(nullptr).storageSize(packedStorage()));
 }
 
 string StructType::toString(bool _short) const
@@ -1824,6 +1912,11 @@ MemberList::MemberMap StructType::nativeMembers(ContractDefinition const*) const
 	return members;
 }
 
+TypePointer StructType::encodingType() const
+{
+	return location() == DataLocation::Storage ? TypeProvider::uint256() : shared_from_this();
+}
+
 TypePointer StructType::interfaceType(bool _inLibrary) const
 {
 	if (!canBeUsedExternally(_inLibrary))
@@ -1907,11 +2000,16 @@ FunctionTypePointer StructType::constructorType() const
 
 pair<u256, unsigned> const& StructType::storageOffsetsOfMember(string const& _name) const
 {
-	auto const* offsets = members(nullptr).memberStorageOffset(_name);
+	auto const* offsets = members(nullptr).memberStorageOffset(_name, packedStorage());
 	solAssert(offsets, "Storage offset of non-existing member requested.");
 	return *offsets;
 }
 
+bool StructType::packedStorage() const
+{
+	return m_struct.sourceUnit().annotation().experimentalFeatures.count(ExperimentalFeature::StoragePacking);
+}
+
 u256 StructType::memoryOffsetOfMember(string const& _name) const
 {
 	u256 offset;
@@ -1987,6 +2085,11 @@ bool EnumType::operator==(Type const& _other) const
 	return other.m_enum == m_enum;
 }
 
+TypePointer EnumType::encodingType() const
+{
+	return TypeProvider::integer(8 * storageBytes());
+}
+
 unsigned EnumType::storageBytes() const
 {
 	size_t elements = numberOfMembers();
@@ -2191,7 +2294,7 @@ FunctionType::FunctionType(VariableDeclaration const& _varDecl):
 				break;
 			returnType = arrayType->baseType();
 			paramNames.push_back("");
-			paramTypes.push_back(make_shared<IntegerType>(256));
+			paramTypes.push_back(TypeProvider::uint256());
 		}
 		else
 			break;
@@ -2372,6 +2475,8 @@ string FunctionType::identifier() const
 
 bool FunctionType::operator==(Type const& _other) const
 {
+	if (&_other == this)
+		return true;
 	if (_other.category() != category())
 		return false;
 
@@ -2572,7 +2677,7 @@ MemberList::MemberMap FunctionType::nativeMembers(ContractDefinition const*) con
 		if (m_kind == Kind::External)
 			members.push_back(MemberList::Member(
 				"selector",
-				make_shared<FixedBytesType>(4)
+				TypeProvider::fixedBytes(4)
 			));
 		if (m_kind != Kind::BareDelegateCall)
 		{
@@ -2820,6 +2925,8 @@ string MappingType::identifier() const
 
 bool MappingType::operator==(Type const& _other) const
 {
+	if (&_other == this)
+		return true;
 	if (_other.category() != category())
 		return false;
 	MappingType const& other = dynamic_cast<MappingType const&>(_other);
@@ -2836,6 +2943,11 @@ string MappingType::canonicalName() const
 	return "mapping(" + keyType()->canonicalName() + " => " + valueType()->canonicalName() + ")";
 }
 
+TypePointer MappingType::encodingType() const
+{
+	return TypeProvider::uint256();
+}
+
 string TypeType::identifier() const
 {
 	return "t_type" + identifierList(actualType());
@@ -3006,25 +3118,25 @@ MemberList::MemberMap MagicType::nativeMembers(ContractDefinition const*) const
 	{
 	case Kind::Block:
 		return MemberList::MemberMap({
-			{"coinbase", make_shared<IntegerType>(160, IntegerType::Modifier::Address)},
-			{"timestamp", make_shared<IntegerType>(256)},
+			{"coinbase", TypeProvider::address()},
+			{"timestamp", TypeProvider::uint256()},
 			{"blockhash", make_shared<FunctionType>(strings{"uint"}, strings{"bytes32"}, FunctionType::Kind::BlockHash, false, StateMutability::View)},
-			{"difficulty", make_shared<IntegerType>(256)},
-			{"number", make_shared<IntegerType>(256)},
-			{"gaslimit", make_shared<IntegerType>(256)}
+			{"difficulty", TypeProvider::uint256()},
+			{"number", TypeProvider::uint256()},
+			{"gaslimit", TypeProvider::uint256()}
 		});
 	case Kind::Message:
 		return MemberList::MemberMap({
-			{"sender", make_shared<IntegerType>(160, IntegerType::Modifier::Address)},
-			{"gas", make_shared<IntegerType>(256)},
-			{"value", make_shared<IntegerType>(256)},
-			{"data", make_shared<ArrayType>(DataLocation::CallData)},
-			{"sig", make_shared<FixedBytesType>(4)}
+			{"sender", TypeProvider::address()},
+			{"gas", TypeProvider::uint256()},
+			{"value", TypeProvider::uint256()},
+			{"data", TypeProvider::byteArray(DataLocation::CallData)},
+			{"sig", TypeProvider::fixedBytes(4)}
 		});
 	case Kind::Transaction:
 		return MemberList::MemberMap({
-			{"origin", make_shared<IntegerType>(160, IntegerType::Modifier::Address)},
-			{"gasprice", make_shared<IntegerType>(256)}
+			{"origin", TypeProvider::address()},
+			{"gasprice", TypeProvider::uint256()}
 		});
 	default:
 		solAssert(false, "Unknown kind of magic.");
@@ -3045,3 +3157,8 @@ string MagicType::toString(bool) const
 		solAssert(false, "Unknown kind of magic.");
 	}
 }
+
+TypePointer InaccessibleDynamicType::decodingType() const
+{
+	return TypeProvider::uint256();
+}
@@ -63,6 +63,14 @@ public:
 	/// Resets the StorageOffsets objects and determines the position in storage for each
 	/// of the elements of @a _types.
 	void computeOffsets(TypePointers const& _types);
+	/// Same as above, but the elements are placed in the order given by @a _order, which
+	/// is a permutation of the indices into @a _types. Offsets are still keyed by the index.
+	void computeOffsets(TypePointers const& _types, std::vector<size_t> const& _order);
+	/// @returns an order of the elements of @a _types in which they occupy as few slots as
+	/// possible: the elements smaller than a slot are distributed into slots first-fit
+	/// decreasing, then the slots and the larger elements are sorted by their first element.
+	/// The result only depends on the types, so the layout does not change between compilations.
+	static std::vector<size_t> packedOrder(TypePointers const& _types);
 	/// @returns the offset of the given member, might be null if the member is not part of storage.
 	std::pair<u256, unsigned> const* offset(size_t _index) const;
 	/// @returns the total number of slots occupied by all members.
@@ -119,10 +127,12 @@ public:
 		return members;
 	}
 	/// @returns the offset of the given member in storage slots and bytes inside a slot or
-	/// a nullptr if the member is not part of storage.
-	std::pair<u256, unsigned> const* memberStorageOffset(std::string const& _name) const;
+	/// a nullptr if the member is not part of storage. If @a _packed is true, the members are
+	/// reordered to occupy fewer slots (see StorageOffsets::packedOrder). The offsets are
+	/// computed on the first call, so all calls have to use the same value for @a _packed.
+	std::pair<u256, unsigned> const* memberStorageOffset(std::string const& _name, bool _packed = false) const;
 	/// @returns the number of storage slots occupied by the members.
-	u256 const& storageSize() const;
+	u256 const& storageSize(bool _packed = false) const;
 
 	MemberMap::const_iterator begin() const { return m_memberTypes.begin(); }
 	MemberMap::const_iterator end() const { return m_memberTypes.end(); }
@@ -483,7 +493,7 @@ public:
 
 	/// @returns the smallest bytes type for the given literal or an empty pointer
 	/// if no type fits.
-	static std::shared_ptr<FixedBytesType> smallestTypeForLiteral(std::string const& _literal);
+	static std::shared_ptr<FixedBytesType const> smallestTypeForLiteral(std::string const& _literal);
 
 	explicit FixedBytesType(int _bytes);
 
@@ -595,12 +605,7 @@ public:
 	virtual Category category() const override { return Category::Array; }
 
 	/// Constructor for a byte array ("bytes") and string.
-	explicit ArrayType(DataLocation _location, bool _isString = false):
-		ReferenceType(_location),
-		m_arrayKind(_isString ? ArrayKind::String : ArrayKind::Bytes),
-		m_baseType(std::make_shared<FixedBytesType>(1))
-	{
-	}
+	explicit ArrayType(DataLocation _location, bool _isString = false);
 	/// Constructor for a dynamically sized array type ("type[]")
 	ArrayType(DataLocation _location, TypePointer const& _baseType):
 		ReferenceType(_location),
@@ -688,10 +693,7 @@ public:
 	virtual std::string canonicalName() const override;
 
 	virtual MemberList::MemberMap nativeMembers(ContractDefinition const* _currentScope) const override;
-	virtual TypePointer encodingType() const override
-	{
-		return std::make_shared<IntegerType>(160, IntegerType::Modifier::Address);
-	}
+	virtual TypePointer encodingType() const override;
 	virtual TypePointer interfaceType(bool _inLibrary) const override
 	{
 		return _inLibrary ? shared_from_this() : encodingType();
@@ -742,10 +744,7 @@ public:
 	virtual std::string toString(bool _short) const override;
 
 	virtual MemberList::MemberMap nativeMembers(ContractDefinition const* _currentScope) const override;
-	virtual TypePointer encodingType() const override
-	{
-		return location() == DataLocation::Storage ? std::make_shared<IntegerType>(256) : shared_from_this();
-	}
+	virtual TypePointer encodingType() const override;
 	virtual TypePointer interfaceType(bool _inLibrary) const override;
 	virtual bool canBeUsedExternally(bool _inLibrary) const override;
 
@@ -773,6 +772,10 @@ public:
 	bool recursive() const;
 
 private:
+	/// @returns true if the members are reordered in storage, which is requested by
+	/// ``pragma experimental StoragePacking;`` in the source unit that defines the struct.
+	bool packedStorage() const;
+
 	StructDefinition const& m_struct;
 	/// Cache for the recursive() function.
 	mutable boost::optional<bool> m_recursive;
@@ -800,10 +803,7 @@ public:
 	virtual bool isValueType() const override { return true; }
 
 	virtual bool isExplicitlyConvertibleTo(Type const& _convertTo) const override;
-	virtual TypePointer encodingType() const override
-	{
-		return std::make_shared<IntegerType>(8 * int(storageBytes()));
-	}
+	virtual TypePointer encodingType() const override;
 	virtual TypePointer interfaceType(bool _inLibrary) const override
 	{
 		return _inLibrary ? shared_from_this() : encodingType();
@@ -1072,10 +1072,7 @@ public:
 	virtual std::string canonicalName() const override;
 	virtual bool canLiveOutsideStorage() const override { return false; }
 	virtual TypePointer binaryOperatorResult(Token::Value, TypePointer const&) const override { return TypePointer(); }
-	virtual TypePointer encodingType() const override
-	{
-		return std::make_shared<IntegerType>(256);
-	}
+	virtual TypePointer encodingType() const override;
 	virtual TypePointer interfaceType(bool _inLibrary) const override
 	{
 		return _inLibrary ? shared_from_this() : TypePointer();
@@ -1216,7 +1213,7 @@ public:
 	virtual bool isValueType() const override { return true; }
 	virtual unsigned sizeOnStack() const override { return 1; }
 	virtual std::string toString(bool) const override { return "inaccessible dynamic type"; }
-	virtual TypePointer decodingType() const override { return std::make_shared<IntegerType>(256); }
+	virtual TypePointer decodingType() const override;
 };
 
 }
@@ -24,6 +24,7 @@
 
 #include <libsolidity/ast/AST.h>
 #include <libsolidity/codegen/CompilerUtils.h>
+#include <libsolidity/inlineasm/AsmData.h>
 
 #include <libdevcore/Whiskers.h>
 
@@ -176,11 +177,28 @@ string ABIFunctions::tupleDecoder(TypePointers const& _types, bool _fromMemory)
 	});
 }
 
-string ABIFunctions::requestedFunctions()
+string ABIFunctions::requestedFunctions(shared_ptr<assembly::Block>* _code)
 {
 	string result;
 	for (auto const& f: m_requestedFunctions)
-		result += f.second;
+		result += f.second->code;
+	if (_code && m_routineStore && !m_requestedFunctions.empty())
+	{
+		// Give the definitions the source locations they have when "{" + result + "}" is parsed.
+		*_code = make_shared<assembly::Block>();
+		(*_code)->statements.reserve(m_requestedFunctions.size());
+		int offset = 1;
+		for (auto const& f: m_requestedFunctions)
+		{
+			(*_code)->statements.push_back(f.second->definitionAt(offset));
+			offset += f.second->code.size();
+		}
+		(*_code)->location = SourceLocation(
+			0,
+			offset + 1,
+			assembly::locationOf((*_code)->statements.front()).sourceName
+		);
+	}
 	m_requestedFunctions.clear();
 	return result;
 }
@@ -1632,15 +1650,44 @@ string ABIFunctions::allocationFunction()
 
 string ABIFunctions::createFunction(string const& _name, function<string ()> const& _creator)
 {
-	if (!m_requestedFunctions.count(_name))
+	if (!m_calledFunctions.empty())
+		m_calledFunctions.back().push_back(_name);
+	if (m_requestedFunctions.count(_name))
+		return _name;
+
+	shared_ptr<ABIRoutineStore::Routine const> routine;
+	if (m_routineStore)
+		routine = m_routineStore->find(_name);
+	if (routine)
+		requestStoredFunction(_name, move(routine));
+	else
 	{
+		m_calledFunctions.push_back({});
 		auto fun = _creator();
 		solAssert(!fun.empty(), "");
-		m_requestedFunctions[_name] = fun;
+		vector<string> calledFunctions = move(m_calledFunctions.back());
+		m_calledFunctions.pop_back();
+		if (m_routineStore)
+			routine = m_routineStore->add(_name, move(fun), move(calledFunctions));
+		else
+			routine = make_shared<ABIRoutineStore::Routine>(ABIRoutineStore::Routine{move(fun), {}, nullptr});
+		m_requestedFunctions[_name] = move(routine);
 	}
 	return _name;
 }
 
+void ABIFunctions::requestStoredFunction(string const& _name, shared_ptr<ABIRoutineStore::Routine const> _routine)
+{
+	auto const& routine = m_requestedFunctions[_name] = move(_routine);
+	for (string const& calledFunction: routine->dependencies)
+		if (!m_requestedFunctions.count(calledFunction))
+		{
+			auto calledRoutine = m_routineStore->find(calledFunction);
+			solAssert(calledRoutine, "Called ABI routine not stored.");
+			requestStoredFunction(calledFunction, move(calledRoutine));
+		}
+}
+
 size_t ABIFunctions::headSize(TypePointers const& _targetTypes)
 {
 	size_t headSize = 0;
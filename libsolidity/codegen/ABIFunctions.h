@@ -23,6 +23,8 @@
 #pragma once
 
 #include <libsolidity/ast/ASTForward.h>
+#include <libsolidity/codegen/ABIRoutineStore.h>
+#include <libsolidity/inlineasm/AsmDataForward.h>
 
 #include <vector>
 #include <functional>
@@ -45,9 +47,16 @@ using TypePointers = std::vector<TypePointer>;
 ///
 /// Make sure to include the result of ``requestedFunctions()`` to a block that
 /// is visible from the code that was generated here, or use named labels.
+///
+/// If a routine store is given, the functions are taken from it and stored in it,
+/// so that they are only generated once per store.
 class ABIFunctions
 {
 public:
+	explicit ABIFunctions(std::shared_ptr<ABIRoutineStore> _routineStore = nullptr):
+		m_routineStore(std::move(_routineStore))
+	{}
+
 	/// @returns name of an assembly function to ABI-encode values of @a _givenTypes
 	/// into memory, converting the types to @a _targetTypes on the fly.
 	/// Parameters are: <headStart> <value_n> ... <value_1>, i.e.
@@ -76,8 +85,12 @@ public:
 	/// stack slot, it takes exactly that number of values.
 	std::string tupleDecoder(TypePointers const& _types, bool _fromMemory = false);
 
-	/// @returns concatenation of all generated functions.
-	std::string requestedFunctions();
+	/// @returns concatenation of all generated functions and clears the list of requested functions.
+	/// If @a _code is given and a routine store is used, it is set to a block with the already
+	/// parsed definitions of the functions, located as if the concatenation was parsed as a block.
+	std::string requestedFunctions(std::shared_ptr<assembly::Block>* _code = nullptr);
+
+	std::shared_ptr<ABIRoutineStore> const& routineStore() const { return m_routineStore; }
 
 private:
 	/// @returns the name of the cleanup function for the given type and
@@ -217,14 +230,19 @@ private:
 
 	/// Helper function that uses @a _creator to create a function and add it to
 	/// @a m_requestedFunctions if it has not been created yet and returns @a _name in both
-	/// cases.
+	/// cases. If the routine store already contains the function, it is taken from there.
 	std::string createFunction(std::string const& _name, std::function<std::string()> const& _creator);
+	/// Adds a function from the routine store and the functions it calls to @a m_requestedFunctions.
+	void requestStoredFunction(std::string const& _name, std::shared_ptr<ABIRoutineStore::Routine const> _routine);
 
 	/// @returns the size of the static part of the encoding of the given types.
 	static size_t headSize(TypePointers const& _targetTypes);
 
 	/// Map from function name to code for a multi-use function.
-	std::map<std::string, std::string> m_requestedFunctions;
+	std::map<std::string, std::shared_ptr<ABIRoutineStore::Routine const>> m_requestedFunctions;
+	/// Names of the functions called by each of the functions that are being created.
+	std::vector<std::vector<std::string>> m_calledFunctions;
+	std::shared_ptr<ABIRoutineStore> m_routineStore;
 };
 
 }
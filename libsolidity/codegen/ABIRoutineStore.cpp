@@ -0,0 +1,206 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Store of the ABI coding routines generated during one compilation.
+ */
+
+#include <libsolidity/codegen/ABIRoutineStore.h>
+
+#include <libsolidity/inlineasm/AsmData.h>
+#include <libsolidity/inlineasm/AsmParser.h>
+#include <libsolidity/interface/ErrorReporter.h>
+#include <libsolidity/interface/Exceptions.h>
+#include <libsolidity/parsing/Scanner.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace
+{
+
+/**
+ * Shifts the source locations of inline assembly code by a fixed amount. Nodes the code only
+ * refers to through shared pointers are copied before they are modified.
+ */
+class LocationShifter: public boost::static_visitor<>
+{
+public:
+	explicit LocationShifter(int _shift): m_shift(_shift) {}
+
+	void operator()(assembly::Instruction& _instruction) const { shift(_instruction.location); }
+	void operator()(assembly::Literal& _literal) const { shift(_literal.location); }
+	void operator()(assembly::Identifier& _identifier) const { shift(_identifier.location); }
+	void operator()(assembly::Label& _label) const { shift(_label.location); }
+	void operator()(assembly::StackAssignment& _assignment) const
+	{
+		shift(_assignment.location);
+		(*this)(_assignment.variableName);
+	}
+	void operator()(assembly::Assignment& _assignment) const
+	{
+		shift(_assignment.location);
+		for (auto& variableName: _assignment.variableNames)
+			(*this)(variableName);
+		shift(_assignment.value);
+	}
+	void operator()(assembly::FunctionalInstruction& _instruction) const
+	{
+		shift(_instruction.location);
+		(*this)(_instruction.instruction);
+		shift(_instruction.arguments);
+	}
+	void operator()(assembly::FunctionCall& _call) const
+	{
+		shift(_call.location);
+		(*this)(_call.functionName);
+		shift(_call.arguments);
+	}
+	void operator()(assembly::VariableDeclaration& _declaration) const
+	{
+		shift(_declaration.location);
+		shift(_declaration.variables);
+		shift(_declaration.value);
+	}
+	void operator()(assembly::FunctionDefinition& _function) const
+	{
+		shift(_function.location);
+		shift(_function.arguments);
+		shift(_function.returns);
+		(*this)(_function.body);
+	}
+	void operator()(assembly::If& _if) const
+	{
+		shift(_if.location);
+		shift(_if.condition);
+		(*this)(_if.body);
+	}
+	void operator()(assembly::Switch& _switch) const
+	{
+		shift(_switch.location);
+		shift(_switch.expression);
+		for (auto& switchCase: _switch.cases)
+		{
+			shift(switchCase.location);
+			if (switchCase.value)
+			{
+				switchCase.value = make_shared<assembly::Literal>(*switchCase.value);
+				(*this)(*switchCase.value);
+			}
+			(*this)(switchCase.body);
+		}
+	}
+	void operator()(assembly::ForLoop& _loop) const
+	{
+		shift(_loop.location);
+		(*this)(_loop.pre);
+		shift(_loop.condition);
+		(*this)(_loop.post);
+		(*this)(_loop.body);
+	}
+	void operator()(assembly::Block& _block) const
+	{
+		shift(_block.location);
+		shift(_block.statements);
+	}
+
+private:
+	void shift(SourceLocation& _location) const
+	{
+		if (_location.isEmpty())
+			return;
+		_location.start += m_shift;
+		_location.end += m_shift;
+	}
+	void shift(assembly::TypedNameList& _names) const
+	{
+		for (auto& name: _names)
+			shift(name.location);
+	}
+	void shift(vector<assembly::Statement>& _statements) const
+	{
+		for (auto& statement: _statements)
+			boost::apply_visitor(*this, statement);
+	}
+	void shift(shared_ptr<assembly::Statement>& _statement) const
+	{
+		if (!_statement)
+			return;
+		_statement = make_shared<assembly::Statement>(*_statement);
+		boost::apply_visitor(*this, *_statement);
+	}
+
+	int m_shift;
+};
+
+}
+
+assembly::Statement ABIRoutineStore::Routine::definitionAt(int _offset) const
+{
+	solAssert(definition, "");
+	assembly::Statement copy = *definition;
+	boost::apply_visitor(LocationShifter(_offset - 1), copy);
+	return copy;
+}
+
+shared_ptr<ABIRoutineStore::Routine const> ABIRoutineStore::find(string const& _name)
+{
+	lock_guard<mutex> lock(m_mutex);
+	auto it = m_routines.find(_name);
+	if (it == m_routines.end())
+		return nullptr;
+	m_reuses++;
+	return it->second;
+}
+
+shared_ptr<ABIRoutineStore::Routine const> ABIRoutineStore::add(
+	string const& _name,
+	string _code,
+	vector<string> _dependencies
+)
+{
+	// Parse outside of the lock, the routine is not visible to other threads yet.
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	auto scanner = make_shared<Scanner>(CharStream("{" + _code + "}"), "--CODEGEN--");
+	shared_ptr<assembly::Block> block = assembly::Parser(errorReporter).parse(scanner);
+	solAssert(
+		block && errors.empty() && block->statements.size() == 1 && block->statements.front().type() == typeid(assembly::FunctionDefinition),
+		"Invalid ABI routine:\n" + _code
+	);
+
+	auto routine = make_shared<Routine>();
+	routine->code = move(_code);
+	routine->dependencies = move(_dependencies);
+	routine->definition = make_shared<assembly::Statement>(std::move(block->statements.front()));
+
+	lock_guard<mutex> lock(m_mutex);
+	auto inserted = m_routines.insert(make_pair(_name, move(routine)));
+	return inserted.first->second;
+}
+
+size_t ABIRoutineStore::routines() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_routines.size();
+}
+
+size_t ABIRoutineStore::reuses() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_reuses;
+}
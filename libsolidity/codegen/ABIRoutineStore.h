@@ -0,0 +1,85 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Store of the ABI coding routines generated during one compilation.
+ */
+
+#pragma once
+
+#include <libsolidity/inlineasm/AsmDataForward.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Keeps the routines ABIFunctions generates (tuple encoders and decoders and the functions
+ * they call) for all contracts of one compilation, so that a routine several contracts need
+ * is only generated and parsed once. Since the routines are placed among the code of each
+ * contract, they are still analyzed, assembled and optimised per contract.
+ * The store can be used by several threads at the same time.
+ */
+class ABIRoutineStore: private boost::noncopyable
+{
+public:
+	struct Routine
+	{
+		/// Source of the function definition.
+		std::string code;
+		/// Names of the routines the function calls.
+		std::vector<std::string> dependencies;
+		/// The parsed function definition. Its source locations start at offset one, it is parsed
+		/// as the only statement of a block.
+		std::shared_ptr<assembly::Statement const> definition;
+
+		/// @returns a copy of the definition with the source locations it has if the code of the
+		/// routine starts at @a _offset of the parsed block.
+		assembly::Statement definitionAt(int _offset) const;
+	};
+
+	/// @returns the routine with the given name, or nullptr if it has not been added yet.
+	std::shared_ptr<Routine const> find(std::string const& _name);
+	/// Parses a routine and adds it, unless another thread added it in the meantime.
+	/// @returns the routine in the store.
+	std::shared_ptr<Routine const> add(
+		std::string const& _name,
+		std::string _code,
+		std::vector<std::string> _dependencies
+	);
+
+	/// @returns the number of routines that were generated.
+	size_t routines() const;
+	/// @returns the number of requests for a routine that did not have to generate it.
+	size_t reuses() const;
+
+private:
+	mutable std::mutex m_mutex;
+	std::map<std::string, std::shared_ptr<Routine const>> m_routines;
+	size_t m_reuses = 0;
+};
+
+}
+}
@@ -0,0 +1,302 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Counted loops over memory and calldata arrays.
+ */
+
+#include <libsolidity/codegen/ArrayLoop.h>
+
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTUtils.h>
+
+#include <libdevcore/CommonData.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace
+{
+
+/// @returns the array whose length @a _expression reads.
+VariableDeclaration const* lengthOf(Expression const* _expression)
+{
+	auto memberAccess = dynamic_cast<MemberAccess const*>(_expression);
+	if (!memberAccess || memberAccess->memberName() != "length")
+		return nullptr;
+	return referencedVariable(&memberAccess->expression());
+}
+
+/// @returns the variable @a _expression uses as length if it allocates a new array.
+VariableDeclaration const* allocationLength(Expression const* _expression)
+{
+	auto call = dynamic_cast<FunctionCall const*>(_expression);
+	if (!call || !dynamic_cast<NewExpression const*>(&call->expression()) || call->arguments().size() != 1)
+		return nullptr;
+	return referencedVariable(call->arguments().front().get());
+}
+
+}
+
+ArrayLoopFinder::ArrayLoopFinder(
+	Block const& _body,
+	vector<ASTPointer<VariableDeclaration>> const& _parameters
+)
+{
+	for (ASTPointer<VariableDeclaration> const& parameter: _parameters)
+		m_parameters.insert(parameter.get());
+	_body.accept(*this);
+	if (m_containsAssembly)
+		return;
+
+	for (unique_ptr<Candidate> const& candidate: m_candidates)
+	{
+		if (candidate->containsPlaceholder || candidate->writtenInBody.count(candidate->counter))
+			continue;
+		vector<VariableDeclaration const*> arrays = countedArrays(*candidate);
+		if (arrays.empty())
+			continue;
+
+		map<VariableDeclaration const*, vector<IndexAccess const*>> accesses;
+		for (IndexAccess const* indexAccess: candidate->indexAccesses)
+			if (referencedVariable(indexAccess->indexExpression()) == candidate->counter)
+				accesses[referencedVariable(&indexAccess->baseExpression())].push_back(indexAccess);
+
+		ArrayLoop loop;
+		loop.counter = candidate->counter;
+		loop.lengthInCondition = candidate->lengthInCondition;
+		for (VariableDeclaration const* array: arrays)
+			if (!loop.array || accesses[array].size() > accesses[loop.array].size())
+				loop.array = array;
+		for (VariableDeclaration const* array: arrays)
+		{
+			vector<IndexAccess const*>& target = array == loop.array ? loop.accesses : loop.otherAccesses;
+			target += accesses[array];
+		}
+		if (loop.lengthInCondition || !loop.accesses.empty())
+			m_loops[candidate->loop] = move(loop);
+	}
+}
+
+bool ArrayLoopFinder::visit(Block const& _block)
+{
+	for (size_t i = 0; i < _block.statements().size(); ++i)
+	{
+		m_position.push_back(make_pair(&_block, i));
+		_block.statements()[i]->accept(*this);
+		m_position.pop_back();
+	}
+	return false;
+}
+
+bool ArrayLoopFinder::visit(ForStatement const& _forStatement)
+{
+	if (_forStatement.initializationExpression())
+		_forStatement.initializationExpression()->accept(*this);
+	if (_forStatement.condition())
+		_forStatement.condition()->accept(*this);
+
+	unique_ptr<Candidate> loop = candidate(_forStatement);
+	if (loop)
+	{
+		loop->position = m_position;
+		m_activeCandidates.push_back(loop.get());
+	}
+	_forStatement.body().accept(*this);
+	if (loop)
+	{
+		m_activeCandidates.pop_back();
+		m_candidates.push_back(move(loop));
+	}
+
+	// The loop expression runs after the body, the counter is not read in between.
+	if (_forStatement.loopExpression())
+		_forStatement.loopExpression()->accept(*this);
+	return false;
+}
+
+bool ArrayLoopFinder::visit(InlineAssembly const&)
+{
+	m_containsAssembly = true;
+	return false;
+}
+
+bool ArrayLoopFinder::visit(PlaceholderStatement const&)
+{
+	for (Candidate* candidate: m_activeCandidates)
+		candidate->containsPlaceholder = true;
+	return false;
+}
+
+bool ArrayLoopFinder::visit(VariableDeclarationStatement const& _statement)
+{
+	if (_statement.declarations().size() != 1 || !_statement.declarations().front())
+		return true;
+	VariableDeclaration const* variable = _statement.declarations().front().get();
+	// Only declarations that are statements of a block are known to precede later statements.
+	if (
+		m_position.empty() ||
+		m_position.back().first->statements()[m_position.back().second].get() != &_statement
+	)
+		return true;
+
+	m_declarations[variable] = m_position;
+	if (VariableDeclaration const* array = lengthOf(_statement.initialValue()))
+		m_lengthVariables[variable] = Initialisation{array, m_position};
+	else if (VariableDeclaration const* length = allocationLength(_statement.initialValue()))
+		m_allocatedArrays[variable] = Initialisation{length, m_position};
+	return true;
+}
+
+bool ArrayLoopFinder::visit(IndexAccess const& _indexAccess)
+{
+	if (
+		referencedVariable(&_indexAccess.baseExpression()) &&
+		referencedVariable(_indexAccess.indexExpression())
+	)
+		for (Candidate* candidate: m_activeCandidates)
+			candidate->indexAccesses.push_back(&_indexAccess);
+	return true;
+}
+
+bool ArrayLoopFinder::visit(FunctionCall const& _functionCall)
+{
+	auto functionType = dynamic_cast<FunctionType const*>(_functionCall.expression().annotation().type.get());
+	if (functionType && functionType->kind() == FunctionType::Kind::Internal)
+	{
+		m_containsInternalCall = true;
+		for (Candidate* candidate: m_activeCandidates)
+			candidate->containsInternalCall = true;
+	}
+	return true;
+}
+
+void ArrayLoopFinder::endVisit(Identifier const& _identifier)
+{
+	if (!_identifier.annotation().lValueRequested)
+		return;
+	Declaration const* declaration = _identifier.annotation().referencedDeclaration;
+	m_written.insert(declaration);
+	for (Candidate* candidate: m_activeCandidates)
+		candidate->writtenInBody.insert(declaration);
+}
+
+unique_ptr<ArrayLoopFinder::Candidate> ArrayLoopFinder::candidate(ForStatement const& _forStatement)
+{
+	auto condition = dynamic_cast<BinaryOperation const*>(_forStatement.condition());
+	if (!condition || condition->getOperator() != Token::LessThan || !_forStatement.loopExpression())
+		return nullptr;
+	VariableDeclaration const* counter = referencedVariable(&condition->leftExpression());
+	if (!counter || !counter->isLocalVariable() || *counter->annotation().type != IntegerType(256))
+		return nullptr;
+
+	// The loop expression has to be ``i++``, ``++i`` or ``i += 1``.
+	Expression const& increment = _forStatement.loopExpression()->expression();
+	if (auto operation = dynamic_cast<UnaryOperation const*>(&increment))
+	{
+		if (operation->getOperator() != Token::Inc || referencedVariable(&operation->subExpression()) != counter)
+			return nullptr;
+	}
+	else if (auto assignment = dynamic_cast<Assignment const*>(&increment))
+	{
+		auto step = dynamic_cast<RationalNumberType const*>(assignment->rightHandSide().annotation().type.get());
+		if (
+			assignment->assignmentOperator() != Token::AssignAdd ||
+			referencedVariable(&assignment->leftHandSide()) != counter ||
+			!step || step->isFractional() || step->literalValue(nullptr) != 1
+		)
+			return nullptr;
+	}
+	else
+		return nullptr;
+
+	unique_ptr<Candidate> loop(new Candidate);
+	loop->loop = &_forStatement;
+	loop->counter = counter;
+	if ((loop->bound = lengthOf(&condition->rightExpression())))
+		loop->lengthInCondition = true;
+	else if (!(loop->bound = referencedVariable(&condition->rightExpression())))
+		return nullptr;
+	return loop;
+}
+
+vector<VariableDeclaration const*> ArrayLoopFinder::countedArrays(Candidate const& _candidate) const
+{
+	vector<VariableDeclaration const*> arrays;
+	if (_candidate.lengthInCondition)
+		arrays.push_back(_candidate.bound);
+	else if (!m_written.count(_candidate.bound) && _candidate.bound != _candidate.counter)
+	{
+		auto lengthVariable = m_lengthVariables.find(_candidate.bound);
+		if (
+			lengthVariable != m_lengthVariables.end() &&
+			m_parameters.count(lengthVariable->second.variable) &&
+			!m_written.count(lengthVariable->second.variable)
+		)
+			arrays.push_back(lengthVariable->second.variable);
+
+		auto boundDeclaration = m_declarations.find(_candidate.bound);
+		for (auto const& allocation: m_allocatedArrays)
+			if (
+				allocation.second.variable == _candidate.bound &&
+				!m_written.count(allocation.first) &&
+				precedes(allocation.second.position, _candidate.position) &&
+				(
+					m_parameters.count(_candidate.bound) ||
+					(boundDeclaration != m_declarations.end() && precedes(boundDeclaration->second, allocation.second.position))
+				)
+			)
+				arrays.push_back(allocation.first);
+	}
+
+	vector<VariableDeclaration const*> suitable;
+	for (VariableDeclaration const* array: arrays)
+		if (suitableArray(*array, _candidate))
+			suitable.push_back(array);
+	return suitable;
+}
+
+bool ArrayLoopFinder::suitableArray(VariableDeclaration const& _variable, Candidate const& _candidate) const
+{
+	if (!_variable.isLocalVariable() || &_variable == _candidate.counter || _candidate.writtenInBody.count(&_variable))
+		return false;
+	auto arrayType = dynamic_cast<ArrayType const*>(_variable.annotation().type.get());
+	if (!arrayType || arrayType->isString())
+		return false;
+	switch (arrayType->location())
+	{
+	case DataLocation::Memory:
+		// The called function could change the length with inline assembly.
+		return !_candidate.containsInternalCall && (_candidate.lengthInCondition || !m_containsInternalCall);
+	case DataLocation::CallData:
+		// Elements of nested arrays in calldata cannot be accessed yet.
+		return arrayType->baseType()->isValueType();
+	default:
+		return false;
+	}
+}
+
+bool ArrayLoopFinder::precedes(Position const& _first, Position const& _second)
+{
+	if (_first.empty() || _first.size() > _second.size())
+		return false;
+	size_t last = _first.size() - 1;
+	for (size_t i = 0; i < last; ++i)
+		if (_first[i] != _second[i])
+			return false;
+	return _first[last].first == _second[last].first && _first[last].second < _second[last].second;
+}
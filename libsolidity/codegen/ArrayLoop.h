@@ -0,0 +1,149 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Counted loops over memory and calldata arrays.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTVisitor.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * A ``for`` loop that counts a ``uint256`` local variable ``i`` up by one while it is less than
+ * the length of a memory or calldata array ``a``. Neither the counter nor the array change in
+ * the body, so ``a[i]`` is always in range there and the address of the element advances by a
+ * fixed amount per iteration.
+ */
+struct ArrayLoop
+{
+	/// The loop counter.
+	VariableDeclaration const* counter = nullptr;
+	/// The array the counter runs over. If several arrays have the bound as length, the one
+	/// that is accessed most often.
+	VariableDeclaration const* array = nullptr;
+	/// True if the condition reads the length of the array, false if it compares with a
+	/// variable that holds it.
+	bool lengthInCondition = false;
+	/// Accesses ``array[counter]`` in the body.
+	std::vector<IndexAccess const*> accesses;
+	/// Accesses ``b[counter]`` in the body of other arrays ``b`` with the same length.
+	std::vector<IndexAccess const*> otherAccesses;
+};
+
+/**
+ * Finds the counted loops over arrays in the body of a function or modifier.
+ *
+ * The condition of such a loop is ``i < a.length`` or ``i < n``, where ``n`` is not written to
+ * and holds the length of ``a`` whenever the condition is evaluated, because
+ *  - ``n`` is declared as ``uint n = a.length`` and ``a`` is a parameter that is not assigned
+ *    to (before its declaration, ``n`` is zero), or
+ *  - ``a`` is declared as ``T[] memory a = new T[](n)``, is not assigned to, and its declaration
+ *    precedes the loop in an enclosing block. ``n`` is a parameter or its declaration precedes
+ *    the one of ``a`` in the same way.
+ * The counter must not be written to in the body and the array must not be assigned to there.
+ * Only inline assembly can change the length of a memory array, so an internal function called
+ * in the body or, if the bound is a variable, anywhere in the function could shrink it. Memory
+ * arrays are not considered in that case. Functions and modifiers that contain inline assembly
+ * and loops that contain the placeholder ``_`` are not considered, since they can change
+ * variables the analysis cannot see.
+ */
+class ArrayLoopFinder: private ASTConstVisitor
+{
+public:
+	ArrayLoopFinder(Block const& _body, std::vector<ASTPointer<VariableDeclaration>> const& _parameters);
+
+	std::map<ForStatement const*, ArrayLoop> const& loops() const { return m_loops; }
+
+private:
+	/// Position of a statement as the indices of it and its enclosing statements in their blocks.
+	using Position = std::vector<std::pair<Block const*, size_t>>;
+
+	/// State of a loop whose header has the form of a counted loop.
+	struct Candidate
+	{
+		ForStatement const* loop = nullptr;
+		Position position;
+		VariableDeclaration const* counter = nullptr;
+		/// The array if the condition reads its length, otherwise the bound variable.
+		VariableDeclaration const* bound = nullptr;
+		bool lengthInCondition = false;
+		std::set<Declaration const*> writtenInBody;
+		/// Index accesses in the body with identifiers as base and index.
+		std::vector<IndexAccess const*> indexAccesses;
+		bool containsPlaceholder = false;
+		bool containsInternalCall = false;
+	};
+	/// Declaration of a local variable with an initial value that can be used to prove a length.
+	struct Initialisation
+	{
+		/// The array whose length a variable is initialised with, or the length a new array is
+		/// allocated with.
+		VariableDeclaration const* variable;
+		Position position;
+	};
+
+	virtual bool visit(Block const& _block) override;
+	virtual bool visit(ForStatement const& _forStatement) override;
+	virtual bool visit(InlineAssembly const&) override;
+	virtual bool visit(PlaceholderStatement const&) override;
+	virtual bool visit(VariableDeclarationStatement const& _statement) override;
+	virtual bool visit(IndexAccess const& _indexAccess) override;
+	virtual bool visit(FunctionCall const& _functionCall) override;
+	virtual void endVisit(Identifier const& _identifier) override;
+
+	/// @returns the candidate for @a _forStatement if its header has the form of a counted loop.
+	static std::unique_ptr<Candidate> candidate(ForStatement const& _forStatement);
+	/// @returns the arrays whose length is the bound of @a _candidate.
+	std::vector<VariableDeclaration const*> countedArrays(Candidate const& _candidate) const;
+	/// @returns true if @a _variable is a local memory or calldata array that is not assigned to
+	/// in the body of @a _candidate and can be accessed with a loop counter.
+	bool suitableArray(VariableDeclaration const& _variable, Candidate const& _candidate) const;
+	/// @returns true if the statement at @a _first is always executed before the one at @a _second.
+	static bool precedes(Position const& _first, Position const& _second);
+
+	std::set<VariableDeclaration const*> m_parameters;
+	/// Variables that are written to anywhere.
+	std::set<Declaration const*> m_written;
+	/// Variables declared as the length of an array.
+	std::map<VariableDeclaration const*, Initialisation> m_lengthVariables;
+	/// Arrays declared as new arrays with a variable as length.
+	std::map<VariableDeclaration const*, Initialisation> m_allocatedArrays;
+	/// Declarations of local variables that are statements of a block.
+	std::map<VariableDeclaration const*, Position> m_declarations;
+	bool m_containsAssembly = false;
+	bool m_containsInternalCall = false;
+	/// Position of the statement that is visited.
+	Position m_position;
+	/// Candidates whose body is being visited, innermost last.
+	std::vector<Candidate*> m_activeCandidates;
+	std::vector<std::unique_ptr<Candidate>> m_candidates;
+
+	std::map<ForStatement const*, ArrayLoop> m_loops;
+};
+
+}
+}
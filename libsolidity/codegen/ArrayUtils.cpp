@@ -25,13 +25,79 @@
 #include <libsolidity/codegen/CompilerContext.h>
 #include <libsolidity/codegen/CompilerUtils.h>
 #include <libsolidity/ast/Types.h>
+#include <libsolidity/ast/TypeProvider.h>
 #include <libsolidity/interface/Exceptions.h>
 #include <libsolidity/codegen/LValue.h>
+#include <libdevcore/CommonData.h>
 
 using namespace std;
 using namespace dev;
 using namespace solidity;
 
+namespace
+{
+
+/// Copies and clears of statically-sized arrays are unrolled if they touch few enough storage
+/// slots, array elements or memory words. Each of them costs around this many bytes of code
+/// when unrolled, which is about as much as the code around a loop.
+unsigned const bytesPerUnrolledWord = 10;
+/// Clearing an element of a non-value type takes more code than clearing a slot, so statically-sized
+/// arrays of them are cleared without a loop only if they have at most this many elements.
+unsigned const maxUnrolledNonValueElements = 4;
+/// Memory areas of at least this many words are copied using the identity precompile. The call
+/// costs 700 gas plus 15 gas and 3 gas per word for the precompile, while the copy loop needs
+/// more than 60 gas per word.
+unsigned const minPrecompileCopyWords = 16;
+
+/// @returns true if arrays of @a _type can be copied between storage and memory or calldata
+/// by assembling or splitting whole storage slots.
+bool isWordwiseCopyable(Type const& _type)
+{
+	switch (_type.category())
+	{
+	case Type::Category::Integer:
+	case Type::Category::Bool:
+	case Type::Category::FixedBytes:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/// @returns an assembly expression that converts @a _value, a memory or calldata word holding
+/// a value of @a _type, to the cleaned-up right-aligned representation of the value in storage.
+string storageRepresentation(Type const& _type, string const& _value)
+{
+	unsigned bits = 8 * _type.storageBytes();
+	if (_type.category() == Type::Category::Bool)
+		return "iszero(iszero(" + _value + "))";
+	else if (bits == 256)
+		return _value;
+	else if (_type.category() == Type::Category::FixedBytes)
+		return "div(" + _value + ", " + toCompactHexWithPrefix(u256(1) << (256 - bits)) + ")";
+	else
+		return "and(" + _value + ", " + toCompactHexWithPrefix((u256(1) << bits) - 1) + ")";
+}
+
+/// @returns an assembly expression that extracts the value of @a _type stored in the lowest-order
+/// bytes of @a _slot and converts it to its cleaned-up representation in memory.
+string memoryRepresentation(Type const& _type, string const& _slot)
+{
+	unsigned bytes = _type.storageBytes();
+	solAssert(bytes < 32, "");
+	string value = "and(" + _slot + ", " + toCompactHexWithPrefix((u256(1) << (8 * bytes)) - 1) + ")";
+	if (_type.category() == Type::Category::Bool)
+		return "iszero(iszero(" + value + "))";
+	else if (_type.category() == Type::Category::FixedBytes)
+		return "mul(" + _slot + ", " + toCompactHexWithPrefix(u256(1) << (256 - 8 * bytes)) + ")";
+	else if (dynamic_cast<IntegerType const&>(_type).isSigned())
+		return "signextend(" + to_string(bytes - 1) + ", " + _slot + ")";
+	else
+		return value;
+}
+
+}
+
 void ArrayUtils::copyArrayToStorage(ArrayType const& _targetType, ArrayType const& _sourceType) const
 {
 	// this copies source to target and also clears target if it was larger
@@ -40,15 +106,30 @@ void ArrayUtils::copyArrayToStorage(ArrayType const& _targetType, ArrayType cons
 	// stack layout: [source_ref] [source length] target_ref (top)
 	solAssert(_targetType.location() == DataLocation::Storage, "");
 
-	TypePointer uint256 = make_shared<IntegerType>(256);
+	TypePointer uint256 = TypeProvider::uint256();
 	TypePointer targetBaseType = _targetType.isByteArray() ? uint256 : _targetType.baseType();
 	TypePointer sourceBaseType = _sourceType.isByteArray() ? uint256 : _sourceType.baseType();
 
-	// TODO unroll loop for small sizes
-
 	bool sourceIsStorage = _sourceType.location() == DataLocation::Storage;
 	bool fromCalldata = _sourceType.location() == DataLocation::CallData;
 	bool directCopy = sourceIsStorage && sourceBaseType->isValueType() && *sourceBaseType == *targetBaseType;
+	// Small statically-sized arrays are copied slot by slot without a loop.
+	bool unrolledDirectCopy =
+		directCopy &&
+		!_sourceType.isDynamicallySized() &&
+		_sourceType.storageSize() <= maxUnrolledWords();
+	// Packed value types are read from memory or calldata and stored a whole slot at a time,
+	// small statically-sized arrays without a loop.
+	bool wordwiseCopy =
+		!sourceIsStorage &&
+		!_sourceType.isByteArray() &&
+		!_targetType.isByteArray() &&
+		*sourceBaseType == *targetBaseType &&
+		isWordwiseCopyable(*targetBaseType) &&
+		(
+			targetBaseType->storageBytes() <= 16 ||
+			(!_sourceType.isDynamicallySized() && _sourceType.length() <= maxUnrolledWords())
+		);
 	bool haveByteOffsetSource = !directCopy && sourceIsStorage && sourceBaseType->storageBytes() <= 16;
 	bool haveByteOffsetTarget = !directCopy && targetBaseType->storageBytes() <= 16;
 	unsigned byteOffsetSize = (haveByteOffsetSource ? 1 : 0) + (haveByteOffsetTarget ? 1 : 0);
@@ -158,118 +239,126 @@ void ArrayUtils::copyArrayToStorage(ArrayType const& _targetType, ArrayType cons
 			if (_sourceType.location() == DataLocation::Storage && _sourceType.isDynamicallySized())
 				CompilerUtils(_context).computeHashStatic();
 			// stack: target_ref target_data_end source_length target_data_pos source_data_pos
-			_context << Instruction::SWAP2;
-			utils.convertLengthToSize(_sourceType);
-			_context << Instruction::DUP3 << Instruction::ADD;
-			// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end
-			if (haveByteOffsetTarget)
-				_context << u256(0);
-			if (haveByteOffsetSource)
-				_context << u256(0);
-			// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
-			eth::AssemblyItem copyLoopStart = _context.newTag();
-			_context << copyLoopStart;
-			// check for loop condition
-			_context
-				<< dupInstruction(3 + byteOffsetSize) << dupInstruction(2 + byteOffsetSize)
-				<< Instruction::GT << Instruction::ISZERO;
-			eth::AssemblyItem copyLoopEnd = _context.appendConditionalJump();
-			// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
-			// copy
-			if (sourceBaseType->category() == Type::Category::Array)
-			{
-				solAssert(byteOffsetSize == 0, "Byte offset for array as base type.");
-				auto const& sourceBaseArrayType = dynamic_cast<ArrayType const&>(*sourceBaseType);
-				_context << Instruction::DUP3;
-				if (sourceBaseArrayType.location() == DataLocation::Memory)
-					_context << Instruction::MLOAD;
-				_context << Instruction::DUP3;
-				utils.copyArrayToStorage(dynamic_cast<ArrayType const&>(*targetBaseType), sourceBaseArrayType);
-				_context << Instruction::POP;
-			}
-			else if (directCopy)
-			{
-				solAssert(byteOffsetSize == 0, "Byte offset for direct copy.");
-				_context
-					<< Instruction::DUP3 << Instruction::SLOAD
-					<< Instruction::DUP3 << Instruction::SSTORE;
-			}
+			if (wordwiseCopy)
+				utils.copyValuesToStorage(_sourceType, *targetBaseType);
+			else if (unrolledDirectCopy)
+				utils.copyStorageSlots(unsigned(_sourceType.storageSize()));
 			else
 			{
-				// Note that we have to copy each element on its own in case conversion is involved.
-				// We might copy too much if there is padding at the last element, but this way end
-				// checking is easier.
+				// stack: target_ref target_data_end source_length target_data_pos source_data_pos
+				_context << Instruction::SWAP2;
+				utils.convertLengthToSize(_sourceType);
+				_context << Instruction::DUP3 << Instruction::ADD;
+				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end
+				if (haveByteOffsetTarget)
+					_context << u256(0);
+				if (haveByteOffsetSource)
+					_context << u256(0);
 				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
-				_context << dupInstruction(3 + byteOffsetSize);
-				if (_sourceType.location() == DataLocation::Storage)
+				eth::AssemblyItem copyLoopStart = _context.newTag();
+				_context << copyLoopStart;
+				// check for loop condition
+				_context
+					<< dupInstruction(3 + byteOffsetSize) << dupInstruction(2 + byteOffsetSize)
+					<< Instruction::GT << Instruction::ISZERO;
+				eth::AssemblyItem copyLoopEnd = _context.appendConditionalJump();
+				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
+				// copy
+				if (sourceBaseType->category() == Type::Category::Array)
+				{
+					solAssert(byteOffsetSize == 0, "Byte offset for array as base type.");
+					auto const& sourceBaseArrayType = dynamic_cast<ArrayType const&>(*sourceBaseType);
+					_context << Instruction::DUP3;
+					if (sourceBaseArrayType.location() == DataLocation::Memory)
+						_context << Instruction::MLOAD;
+					_context << Instruction::DUP3;
+					utils.copyArrayToStorage(dynamic_cast<ArrayType const&>(*targetBaseType), sourceBaseArrayType);
+					_context << Instruction::POP;
+				}
+				else if (directCopy)
 				{
-					if (haveByteOffsetSource)
-						_context << Instruction::DUP2;
+					solAssert(byteOffsetSize == 0, "Byte offset for direct copy.");
+					_context
+						<< Instruction::DUP3 << Instruction::SLOAD
+						<< Instruction::DUP3 << Instruction::SSTORE;
+				}
+				else
+				{
+					// Note that we have to copy each element on its own in case conversion is involved.
+					// We might copy too much if there is padding at the last element, but this way end
+					// checking is easier.
+					// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
+					_context << dupInstruction(3 + byteOffsetSize);
+					if (_sourceType.location() == DataLocation::Storage)
+					{
+						if (haveByteOffsetSource)
+							_context << Instruction::DUP2;
+						else
+							_context << u256(0);
+						StorageItem(_context, *sourceBaseType).retrieveValue(SourceLocation(), true);
+					}
+					else if (sourceBaseType->isValueType())
+						CompilerUtils(_context).loadFromMemoryDynamic(*sourceBaseType, fromCalldata, true, false);
+					else
+						solUnimplemented("Copying of type " + _sourceType.toString(false) + " to storage not yet supported.");
+					// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset] <source_value>...
+					solAssert(
+						2 + byteOffsetSize + sourceBaseType->sizeOnStack() <= 16,
+						"Stack too deep, try removing local variables."
+					);
+					// fetch target storage reference
+					_context << dupInstruction(2 + byteOffsetSize + sourceBaseType->sizeOnStack());
+					if (haveByteOffsetTarget)
+						_context << dupInstruction(1 + byteOffsetSize + sourceBaseType->sizeOnStack());
 					else
 						_context << u256(0);
-					StorageItem(_context, *sourceBaseType).retrieveValue(SourceLocation(), true);
+					StorageItem(_context, *targetBaseType).storeValue(*sourceBaseType, SourceLocation(), true);
 				}
-				else if (sourceBaseType->isValueType())
-					CompilerUtils(_context).loadFromMemoryDynamic(*sourceBaseType, fromCalldata, true, false);
+				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
+				// increment source
+				if (haveByteOffsetSource)
+					utils.incrementByteOffset(sourceBaseType->storageBytes(), 1, haveByteOffsetTarget ? 5 : 4);
 				else
-					solUnimplemented("Copying of type " + _sourceType.toString(false) + " to storage not yet supported.");
-				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset] <source_value>...
-				solAssert(
-					2 + byteOffsetSize + sourceBaseType->sizeOnStack() <= 16,
-					"Stack too deep, try removing local variables."
-				);
-				// fetch target storage reference
-				_context << dupInstruction(2 + byteOffsetSize + sourceBaseType->sizeOnStack());
+				{
+					_context << swapInstruction(2 + byteOffsetSize);
+					if (sourceIsStorage)
+						_context << sourceBaseType->storageSize();
+					else if (_sourceType.location() == DataLocation::Memory)
+						_context << sourceBaseType->memoryHeadSize();
+					else
+						_context << sourceBaseType->calldataEncodedSize(true);
+					_context
+						<< Instruction::ADD
+						<< swapInstruction(2 + byteOffsetSize);
+				}
+				// increment target
 				if (haveByteOffsetTarget)
-					_context << dupInstruction(1 + byteOffsetSize + sourceBaseType->sizeOnStack());
-				else
-					_context << u256(0);
-				StorageItem(_context, *targetBaseType).storeValue(*sourceBaseType, SourceLocation(), true);
-			}
-			// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end [target_byte_offset] [source_byte_offset]
-			// increment source
-			if (haveByteOffsetSource)
-				utils.incrementByteOffset(sourceBaseType->storageBytes(), 1, haveByteOffsetTarget ? 5 : 4);
-			else
-			{
-				_context << swapInstruction(2 + byteOffsetSize);
-				if (sourceIsStorage)
-					_context << sourceBaseType->storageSize();
-				else if (_sourceType.location() == DataLocation::Memory)
-					_context << sourceBaseType->memoryHeadSize();
+					utils.incrementByteOffset(targetBaseType->storageBytes(), byteOffsetSize, byteOffsetSize + 2);
 				else
-					_context << sourceBaseType->calldataEncodedSize(true);
-				_context
-					<< Instruction::ADD
-					<< swapInstruction(2 + byteOffsetSize);
-			}
-			// increment target
-			if (haveByteOffsetTarget)
-				utils.incrementByteOffset(targetBaseType->storageBytes(), byteOffsetSize, byteOffsetSize + 2);
-			else
-				_context
-					<< swapInstruction(1 + byteOffsetSize)
-					<< targetBaseType->storageSize()
-					<< Instruction::ADD
-					<< swapInstruction(1 + byteOffsetSize);
-			_context.appendJumpTo(copyLoopStart);
-			_context << copyLoopEnd;
-			if (haveByteOffsetTarget)
-			{
-				// clear elements that might be left over in the current slot in target
-				// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end target_byte_offset [source_byte_offset]
-				_context << dupInstruction(byteOffsetSize) << Instruction::ISZERO;
-				eth::AssemblyItem copyCleanupLoopEnd = _context.appendConditionalJump();
-				_context << dupInstruction(2 + byteOffsetSize) << dupInstruction(1 + byteOffsetSize);
-				StorageItem(_context, *targetBaseType).setToZero(SourceLocation(), true);
-				utils.incrementByteOffset(targetBaseType->storageBytes(), byteOffsetSize, byteOffsetSize + 2);
-				_context.appendJumpTo(copyLoopEnd);
-
-				_context << copyCleanupLoopEnd;
-				_context << Instruction::POP; // might pop the source, but then target is popped next
+					_context
+						<< swapInstruction(1 + byteOffsetSize)
+						<< targetBaseType->storageSize()
+						<< Instruction::ADD
+						<< swapInstruction(1 + byteOffsetSize);
+				_context.appendJumpTo(copyLoopStart);
+				_context << copyLoopEnd;
+				if (haveByteOffsetTarget)
+				{
+					// clear elements that might be left over in the current slot in target
+					// stack: target_ref target_data_end source_data_pos target_data_pos source_data_end target_byte_offset [source_byte_offset]
+					_context << dupInstruction(byteOffsetSize) << Instruction::ISZERO;
+					eth::AssemblyItem copyCleanupLoopEnd = _context.appendConditionalJump();
+					_context << dupInstruction(2 + byteOffsetSize) << dupInstruction(1 + byteOffsetSize);
+					StorageItem(_context, *targetBaseType).setToZero(SourceLocation(), true);
+					utils.incrementByteOffset(targetBaseType->storageBytes(), byteOffsetSize, byteOffsetSize + 2);
+					_context.appendJumpTo(copyLoopEnd);
+
+					_context << copyCleanupLoopEnd;
+					_context << Instruction::POP; // might pop the source, but then target is popped next
+				}
+				if (haveByteOffsetSource)
+					_context << Instruction::POP;
 			}
-			if (haveByteOffsetSource)
-				_context << Instruction::POP;
 			_context << copyLoopEndWithoutByteOffset;
 
 			// zero-out leftovers in target
@@ -356,10 +445,10 @@ void ArrayUtils::copyArrayToMemory(ArrayType const& _sourceType, bool _padToWord
 		// We can resort to copying full 32 bytes only if
 		// - the length is known to be a multiple of 32 or
 		// - we will pad to full 32 bytes later anyway.
-		if (((baseSize % 32) == 0) || _padToWordBoundaries)
-			utils.memoryCopy32();
-		else
-			utils.memoryCopy();
+		copyMemoryArea(
+			((baseSize % 32) == 0) || _padToWordBoundaries,
+			_sourceType.isDynamicallySized() ? u256(0) : _sourceType.length() * baseSize
+		);
 
 		m_context << Instruction::SWAP1 << Instruction::POP;
 		// stack: <target> <size>
@@ -460,61 +549,67 @@ void ArrayUtils::copyArrayToMemory(ArrayType const& _sourceType, bool _padToWord
 
 		// stack here: memory_end_offset storage_data_offset memory_offset
 		bool haveByteOffset = !_sourceType.isByteArray() && storageBytes <= 16;
-		if (haveByteOffset)
-			m_context << u256(0) << Instruction::SWAP1;
-		// stack here: memory_end_offset storage_data_offset [storage_byte_offset] memory_offset
-		eth::AssemblyItem loopStart = m_context.newTag();
-		m_context << loopStart;
-		// load and store
-		if (_sourceType.isByteArray())
-		{
-			// Packed both in storage and memory.
-			m_context << Instruction::DUP2 << Instruction::SLOAD;
-			m_context << Instruction::DUP2 << Instruction::MSTORE;
-			// increment storage_data_offset by 1
-			m_context << Instruction::SWAP1 << u256(1) << Instruction::ADD;
-			// increment memory offset by 32
-			m_context << Instruction::SWAP1 << u256(32) << Instruction::ADD;
-		}
+		if (haveByteOffset && isWordwiseCopyable(*_sourceType.baseType()))
+			// Elements sharing a slot are extracted from a single SLOAD.
+			copyPackedStorageToMemory(*_sourceType.baseType());
 		else
 		{
-			// stack here: memory_end_offset storage_data_offset [storage_byte_offset] memory_offset
 			if (haveByteOffset)
-				m_context << Instruction::DUP3 << Instruction::DUP3;
-			else
-				m_context << Instruction::DUP2 << u256(0);
-			StorageItem(m_context, *_sourceType.baseType()).retrieveValue(SourceLocation(), true);
-			if (auto baseArray = dynamic_cast<ArrayType const*>(_sourceType.baseType().get()))
-				copyArrayToMemory(*baseArray, _padToWordBoundaries);
+				m_context << u256(0) << Instruction::SWAP1;
+			// stack here: memory_end_offset storage_data_offset [storage_byte_offset] memory_offset
+			eth::AssemblyItem loopStart = m_context.newTag();
+			m_context << loopStart;
+			// load and store
+			if (_sourceType.isByteArray())
+			{
+				// Packed both in storage and memory.
+				m_context << Instruction::DUP2 << Instruction::SLOAD;
+				m_context << Instruction::DUP2 << Instruction::MSTORE;
+				// increment storage_data_offset by 1
+				m_context << Instruction::SWAP1 << u256(1) << Instruction::ADD;
+				// increment memory offset by 32
+				m_context << Instruction::SWAP1 << u256(32) << Instruction::ADD;
+			}
 			else
-				utils.storeInMemoryDynamic(*_sourceType.baseType());
-			// increment storage_data_offset and byte offset
+			{
+				// stack here: memory_end_offset storage_data_offset [storage_byte_offset] memory_offset
+				if (haveByteOffset)
+					m_context << Instruction::DUP3 << Instruction::DUP3;
+				else
+					m_context << Instruction::DUP2 << u256(0);
+				StorageItem(m_context, *_sourceType.baseType()).retrieveValue(SourceLocation(), true);
+				if (auto baseArray = dynamic_cast<ArrayType const*>(_sourceType.baseType().get()))
+					copyArrayToMemory(*baseArray, _padToWordBoundaries);
+				else
+					utils.storeInMemoryDynamic(*_sourceType.baseType());
+				// increment storage_data_offset and byte offset
+				if (haveByteOffset)
+					incrementByteOffset(storageBytes, 2, 3);
+				else
+				{
+					m_context << Instruction::SWAP1;
+					m_context << storageSize << Instruction::ADD;
+					m_context << Instruction::SWAP1;
+				}
+			}
+			// check for loop condition
+			m_context << Instruction::DUP1 << dupInstruction(haveByteOffset ? 5 : 4);
+			m_context << Instruction::GT;
+			m_context.appendConditionalJumpTo(loopStart);
+			// stack here: memory_end_offset storage_data_offset [storage_byte_offset] memory_offset
 			if (haveByteOffset)
-				incrementByteOffset(storageBytes, 2, 3);
-			else
+				m_context << Instruction::SWAP1 << Instruction::POP;
+			if (_padToWordBoundaries && baseSize % 32 != 0)
 			{
-				m_context << Instruction::SWAP1;
-				m_context << storageSize << Instruction::ADD;
-				m_context << Instruction::SWAP1;
+				// memory_end_offset - start is the actual length (we want to compute the ceil of).
+				// memory_offset - start is its next multiple of 32, but it might be off by 32.
+				// so we compute: memory_end_offset += (memory_offset - memory_end_offest) & 31
+				m_context << Instruction::DUP3 << Instruction::SWAP1 << Instruction::SUB;
+				m_context << u256(31) << Instruction::AND;
+				m_context << Instruction::DUP3 << Instruction::ADD;
+				m_context << Instruction::SWAP2;
 			}
 		}
-		// check for loop condition
-		m_context << Instruction::DUP1 << dupInstruction(haveByteOffset ? 5 : 4);
-		m_context << Instruction::GT;
-		m_context.appendConditionalJumpTo(loopStart);
-		// stack here: memory_end_offset storage_data_offset [storage_byte_offset] memory_offset
-		if (haveByteOffset)
-			m_context << Instruction::SWAP1 << Instruction::POP;
-		if (_padToWordBoundaries && baseSize % 32 != 0)
-		{
-			// memory_end_offset - start is the actual length (we want to compute the ceil of).
-			// memory_offset - start is its next multiple of 32, but it might be off by 32.
-			// so we compute: memory_end_offset += (memory_offset - memory_end_offest) & 31
-			m_context << Instruction::DUP3 << Instruction::SWAP1 << Instruction::SUB;
-			m_context << u256(31) << Instruction::AND;
-			m_context << Instruction::DUP3 << Instruction::ADD;
-			m_context << Instruction::SWAP2;
-		}
 		m_context << loopEnd << Instruction::POP << Instruction::POP;
 	}
 }
@@ -544,9 +639,9 @@ void ArrayUtils::clearArray(ArrayType const& _typeIn) const
 				ArrayUtils(_context).clearDynamicArray(_type);
 			else if (_type.length() == 0 || _type.baseType()->category() == Type::Category::Mapping)
 				_context << Instruction::POP;
-			else if (_type.baseType()->isValueType() && _type.storageSize() <= 5)
+			else if (_type.baseType()->isValueType() && _type.storageSize() <= ArrayUtils(_context).maxUnrolledWords())
 			{
-				// unroll loop for small arrays @todo choose a good value
+				// unroll loop for small arrays
 				// Note that we loop over storage slots here, not elements.
 				for (unsigned i = 1; i < _type.storageSize(); ++i)
 					_context
@@ -554,9 +649,9 @@ void ArrayUtils::clearArray(ArrayType const& _typeIn) const
 						<< u256(1) << Instruction::ADD;
 				_context << u256(0) << Instruction::SWAP1 << Instruction::SSTORE;
 			}
-			else if (!_type.baseType()->isValueType() && _type.length() <= 4)
+			else if (!_type.baseType()->isValueType() && _type.length() <= ArrayUtils(_context).maxUnrolledElements(*_type.baseType()))
 			{
-				// unroll loop for small arrays @todo choose a good value
+				// unroll loop for small arrays, clearing an element takes more code than clearing a slot
 				solAssert(_type.baseType()->storageBytes() >= 32, "Invalid storage size.");
 				for (unsigned i = 1; i < _type.length(); ++i)
 				{
@@ -575,7 +670,7 @@ void ArrayUtils::clearArray(ArrayType const& _typeIn) const
 				ArrayUtils(_context).convertLengthToSize(_type);
 				_context << Instruction::ADD << Instruction::SWAP1;
 				if (_type.baseType()->storageBytes() < 32)
-					ArrayUtils(_context).clearStorageLoop(make_shared<IntegerType>(256));
+					ArrayUtils(_context).clearStorageLoop(TypeProvider::uint256());
 				else
 					ArrayUtils(_context).clearStorageLoop(_type.baseType());
 				_context << Instruction::POP;
@@ -616,7 +711,7 @@ void ArrayUtils::clearDynamicArray(ArrayType const& _type) const
 		<< Instruction::SWAP1;
 	// stack: data_pos_end data_pos
 	if (_type.isByteArray() || _type.baseType()->storageBytes() < 32)
-		clearStorageLoop(make_shared<IntegerType>(256));
+		clearStorageLoop(TypeProvider::uint256());
 	else
 		clearStorageLoop(_type.baseType());
 	// cleanup
@@ -723,7 +818,7 @@ void ArrayUtils::resizeDynamicArray(ArrayType const& _typeIn) const
 				ArrayUtils(_context).convertLengthToSize(_type);
 				_context << Instruction::DUP2 << Instruction::ADD << Instruction::SWAP1;
 				// stack: ref new_length current_length first_word data_location_end data_location
-				ArrayUtils(_context).clearStorageLoop(make_shared<IntegerType>(256));
+				ArrayUtils(_context).clearStorageLoop(TypeProvider::uint256());
 				_context << Instruction::POP;
 				// stack: ref new_length current_length first_word
 				solAssert(_context.stackHeight() - stackHeightStart == 4 - 2, "3");
@@ -762,7 +857,7 @@ void ArrayUtils::resizeDynamicArray(ArrayType const& _typeIn) const
 			_context << Instruction::SWAP2 << Instruction::ADD;
 			// stack: ref new_length delete_end delete_start
 			if (_type.isByteArray() || _type.baseType()->storageBytes() < 32)
-				ArrayUtils(_context).clearStorageLoop(make_shared<IntegerType>(256));
+				ArrayUtils(_context).clearStorageLoop(TypeProvider::uint256());
 			else
 				ArrayUtils(_context).clearStorageLoop(_type.baseType());
 
@@ -980,6 +1075,159 @@ void ArrayUtils::accessIndex(ArrayType const& _arrayType, bool _doBoundsCheck) c
 	}
 }
 
+unsigned ArrayUtils::maxUnrolledWords() const
+{
+	return m_context.maxUnrolledIterations(bytesPerUnrolledWord);
+}
+
+unsigned ArrayUtils::maxUnrolledElements(Type const& _baseType) const
+{
+	// Clearing an element takes about as much code per storage slot as clearing a slot, plus the
+	// code that moves on to the next element. Elements of 64 slots are never unrolled beyond the
+	// first one, so larger ones do not need to be told apart.
+	size_t slots = size_t(min(_baseType.storageSize(), u256(64)));
+	size_t limit = m_context.maxUnrolledIterations(bytesPerUnrolledWord * (slots + 1));
+	return min<size_t>(limit, maxUnrolledNonValueElements);
+}
+
+void ArrayUtils::copyValuesToStorage(ArrayType const& _sourceType, Type const& _baseType) const
+{
+	solAssert(isWordwiseCopyable(_baseType), "");
+	solAssert(_sourceType.location() != DataLocation::Storage, "");
+	unsigned elementsPerSlot = 32 / _baseType.storageBytes();
+	string load = _sourceType.location() == DataLocation::CallData ? "calldataload" : "mload";
+
+	// stack: length target_data_pos source_data_pos
+	string code;
+	if (!_sourceType.isDynamicallySized() && _sourceType.length() <= maxUnrolledWords())
+	{
+		unsigned length = unsigned(_sourceType.length());
+		unsigned slots = (length + elementsPerSlot - 1) / elementsPerSlot;
+		for (unsigned slot = 0; slot < slots; ++slot)
+		{
+			string word;
+			for (unsigned i = slot * elementsPerSlot; i < min(length, (slot + 1) * elementsPerSlot); ++i)
+			{
+				string value = storageRepresentation(_baseType, load + "(add(src, " + to_string(32 * i) + "))");
+				unsigned byteOffset = _baseType.storageBytes() * (i % elementsPerSlot);
+				if (byteOffset > 0)
+					value = "mul(" + value + ", " + toCompactHexWithPrefix(u256(1) << (8 * byteOffset)) + ")";
+				word = word.empty() ? value : "or(" + word + ", " + value + ")";
+			}
+			code += "sstore(add(slot, " + to_string(slot) + "), " + word + ")\n";
+		}
+		code += "slot := add(slot, " + to_string(slots) + ")\n";
+		code += "src := add(src, " + to_string(32 * length) + ")\n";
+		code += "len := 0\n";
+	}
+	else
+	{
+		solAssert(elementsPerSlot > 1, "");
+		code = R"(
+			for { } len { slot := add(slot, 1) }
+			{
+				let count := )" + to_string(elementsPerSlot) + R"(
+				if lt(len, count) { count := len }
+				len := sub(len, count)
+				let word := 0
+				let factor := 1
+				for { } count { count := sub(count, 1) }
+				{
+					word := or(word, mul()" + storageRepresentation(_baseType, load + "(src)") + R"(, factor))
+					factor := mul(factor, )" + toCompactHexWithPrefix(u256(1) << (8 * _baseType.storageBytes())) + R"()
+					src := add(src, 32)
+				}
+				sstore(slot, word)
+			}
+		)";
+	}
+	m_context.appendInlineAssembly("{" + code + "}", {"len", "slot", "src"});
+	// stack: 0 target_data_pos_updated source_data_end
+}
+
+void ArrayUtils::copyStorageSlots(unsigned _slots) const
+{
+	solAssert(_slots <= maxUnrolledWords(), "");
+	// stack: length target_data_pos source_data_pos
+	string code = "{\n";
+	for (unsigned i = 0; i < _slots; ++i)
+		code += "sstore(add(slot, " + to_string(i) + "), sload(add(src, " + to_string(i) + ")))\n";
+	code += "slot := add(slot, " + to_string(_slots) + ")\n";
+	code += "src := add(src, " + to_string(_slots) + ")\n";
+	code += "}";
+	m_context.appendInlineAssembly(code, {"len", "slot", "src"});
+	// stack: length target_data_pos_updated source_data_end
+}
+
+void ArrayUtils::copyPackedStorageToMemory(Type const& _baseType) const
+{
+	solAssert(isWordwiseCopyable(_baseType), "");
+	unsigned elementsPerSlot = 32 / _baseType.storageBytes();
+	solAssert(elementsPerSlot > 1, "");
+	// stack: memory_end_offset storage_data_offset memory_offset
+	m_context.appendInlineAssembly(R"({
+		for { } lt(dst, end) { slot := add(slot, 1) }
+		{
+			let word := sload(slot)
+			let count := div(sub(end, dst), 32)
+			if gt(count, )" + to_string(elementsPerSlot) + R"() { count := )" + to_string(elementsPerSlot) + R"( }
+			for { } count { count := sub(count, 1) }
+			{
+				mstore(dst, )" + memoryRepresentation(_baseType, "word") + R"()
+				word := div(word, )" + toCompactHexWithPrefix(u256(1) << (8 * _baseType.storageBytes())) + R"()
+				dst := add(dst, 32)
+			}
+		}
+	})", {"end", "slot", "dst"});
+	// stack: memory_end_offset storage_data_offset_updated memory_end_offset
+}
+
+void ArrayUtils::copyMemoryArea(bool _wholeWords, u256 const& _staticSize) const
+{
+	CompilerUtils utils(m_context);
+	// stack: size target source
+	if (_wholeWords && _staticSize > 0 && _staticSize <= maxUnrolledWords() * 32)
+	{
+		string code = "{\n";
+		for (unsigned offset = 0; offset < _staticSize; offset += 32)
+			code += "mstore(add(dst, " + to_string(offset) + "), mload(add(src, " + to_string(offset) + ")))\n";
+		code += "}";
+		m_context.appendInlineAssembly(code, {"len", "dst", "src"});
+		utils.popStackSlots(3);
+	}
+	else if (_staticSize >= minPrecompileCopyWords * 32)
+		utils.memoryCopyPrecompile();
+	else if (_staticSize > 0)
+	{
+		if (_wholeWords)
+			utils.memoryCopy32();
+		else
+			utils.memoryCopy();
+	}
+	else
+		// The size is only known at runtime, the routine choosing the strategy is shared.
+		m_context.callLowLevelFunction(
+			_wholeWords ? "$copyMemoryAreaWords" : "$copyMemoryArea",
+			3,
+			0,
+			[_wholeWords](CompilerContext& _context)
+			{
+				CompilerUtils utils(_context);
+				_context << u256(minPrecompileCopyWords * 32) << Instruction::DUP4 << Instruction::LT;
+				eth::AssemblyItem smallCopy = _context.appendConditionalJump();
+				utils.memoryCopyPrecompile();
+				eth::AssemblyItem copyEnd = _context.appendJumpToNew();
+				_context.adjustStackOffset(3); // needed because of jump
+				_context << smallCopy;
+				if (_wholeWords)
+					utils.memoryCopy32();
+				else
+					utils.memoryCopy();
+				_context << copyEnd;
+			}
+		);
+}
+
 void ArrayUtils::incrementByteOffset(unsigned _byteSize, unsigned _byteOffsetPosition, unsigned _storageOffsetPosition) const
 {
 	solAssert(_byteSize < 32, "");
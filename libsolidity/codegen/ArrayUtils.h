@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <libdevcore/Common.h>
+
 #include <memory>
 
 namespace dev
@@ -93,6 +95,35 @@ public:
 	void accessIndex(ArrayType const& _arrayType, bool _doBoundsCheck = true) const;
 
 private:
+	/// @returns the largest number of storage slots, array elements or memory words that copies
+	/// and clears of statically-sized arrays touch without a loop.
+	unsigned maxUnrolledWords() const;
+	/// @returns the largest number of elements of type @a _baseType, which is not a value type,
+	/// that clears of statically-sized arrays touch without a loop.
+	unsigned maxUnrolledElements(Type const& _baseType) const;
+	/// Copies the elements of a memory or calldata array of value types to storage. All elements
+	/// that share a slot are combined on the stack and stored at once. The base type has to be
+	/// packed in storage or the array has to be small and statically-sized.
+	/// Stack pre: length target_data_pos source_data_pos
+	/// Stack post: 0 target_data_pos_updated source_data_end
+	void copyValuesToStorage(ArrayType const& _sourceType, Type const& _baseType) const;
+	/// Copies @a _slots storage slots without a loop.
+	/// Stack pre: length target_data_pos source_data_pos
+	/// Stack post: length target_data_pos_updated source_data_end
+	void copyStorageSlots(unsigned _slots) const;
+	/// Copies the elements of a storage array of value types that share slots to memory, loading
+	/// every slot only once.
+	/// Stack pre: memory_end_offset storage_data_offset memory_offset
+	/// Stack post: memory_end_offset storage_data_offset_updated memory_end_offset
+	void copyPackedStorageToMemory(Type const& _baseType) const;
+	/// Copies a memory area without a loop if it is small and its size is known at compile
+	/// time, using the identity precompile if it is large and a loop otherwise.
+	/// @param _wholeWords if true, the area can be copied in words of 32 bytes even if its size
+	/// is not a multiple of 32.
+	/// @param _staticSize the size of the area if it is known at compile time, zero otherwise.
+	/// Stack pre: size target source
+	/// Stack post:
+	void copyMemoryArea(bool _wholeWords, u256 const& _staticSize) const;
 	/// Adds the given number of bytes to a storage byte offset counter and also increments
 	/// the storage offset if adding this number again would increase the counter over 32.
 	/// @param byteOffsetPosition the stack offset of the storage byte offset
@@ -24,6 +24,11 @@
 #include <libevmasm/Assembly.h>
 #include <libsolidity/codegen/ContractCompiler.h>
 
+#include <libdevcore/CommonData.h>
+
+#include <set>
+#include <sstream>
+
 using namespace std;
 using namespace dev;
 using namespace dev::solidity;
@@ -34,13 +39,13 @@ void Compiler::compileContract(
 	bytes const& _metadata
 )
 {
-	ContractCompiler runtimeCompiler(nullptr, m_runtimeContext, m_optimize);
+	ContractCompiler runtimeCompiler(nullptr, m_runtimeContext, m_optimize, m_optimizeRuns);
 	runtimeCompiler.compileContract(_contract, _contracts);
 	m_runtimeContext.appendAuxiliaryData(_metadata);
 
 	// This might modify m_runtimeContext because it can access runtime functions at
 	// creation time.
-	ContractCompiler creationCompiler(&runtimeCompiler, m_context, m_optimize);
+	ContractCompiler creationCompiler(&runtimeCompiler, m_context, m_optimize, m_optimizeRuns);
 	m_runtimeSub = creationCompiler.compileConstructor(_contract, _contracts);
 
 	m_context.optimise(m_optimize, m_optimizeRuns);
@@ -51,13 +56,44 @@ void Compiler::compileClone(
 	map<ContractDefinition const*, eth::Assembly const*> const& _contracts
 )
 {
-	ContractCompiler runtimeCompiler(nullptr, m_runtimeContext, m_optimize);
-	ContractCompiler cloneCompiler(&runtimeCompiler, m_context, m_optimize);
+	ContractCompiler runtimeCompiler(nullptr, m_runtimeContext, m_optimize, m_optimizeRuns);
+	ContractCompiler cloneCompiler(&runtimeCompiler, m_context, m_optimize, m_optimizeRuns);
 	m_runtimeSub = cloneCompiler.compileClone(_contract, _contracts);
 
 	m_context.optimise(m_optimize, m_optimizeRuns);
 }
 
+string Compiler::optimiserReport() const
+{
+	// Code of functions called from the constructor is generated in both contexts.
+	set<pair<SourceLocation, u256>> folded;
+	map<SourceLocation, pair<u256, bool>> loops;
+	for (CompilerContext const* context: {&m_context, &m_runtimeContext})
+	{
+		for (auto const& expression: context->constantFolder().foldedExpressions())
+			folded.insert(expression);
+		loops.insert(context->loopUnrollings().begin(), context->loopUnrollings().end());
+	}
+
+	ostringstream out;
+	out << m_context.optimiserReport();
+	if (!folded.empty())
+	{
+		out << "constant expressions folded:" << endl;
+		for (auto const& expression: folded)
+			out << "    " << expression.first << ": " << formatNumber(expression.second) << endl;
+	}
+	if (!loops.empty())
+	{
+		out << "loops with a known number of iterations:" << endl;
+		for (auto const& loop: loops)
+			out <<
+				"    " << loop.first << ": " << loop.second.first << " iterations, " <<
+				(loop.second.second ? "unrolled" : "not unrolled") << endl;
+	}
+	return out.str();
+}
+
 eth::AssemblyItem Compiler::functionEntryLabel(FunctionDefinition const& _function) const
 {
 	return m_runtimeContext.functionEntryLabelIfExists(_function);
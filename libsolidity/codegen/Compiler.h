@@ -33,11 +33,16 @@ namespace solidity {
 class Compiler
 {
 public:
-	explicit Compiler(bool _optimize = false, unsigned _runs = 200):
+	explicit Compiler(
+		bool _optimize = false,
+		unsigned _runs = 200,
+		std::shared_ptr<InlineAssemblyCache> const& _inlineAssemblyCache = nullptr,
+		std::shared_ptr<ABIRoutineStore> const& _abiRoutineStore = nullptr
+	):
 		m_optimize(_optimize),
 		m_optimizeRuns(_runs),
-		m_runtimeContext(),
-		m_context(&m_runtimeContext)
+		m_runtimeContext(nullptr, _inlineAssemblyCache, _abiRoutineStore),
+		m_context(&m_runtimeContext, _inlineAssemblyCache, _abiRoutineStore)
 	{ }
 
 	/// Compiles a contract.
@@ -64,6 +69,9 @@ public:
 	{
 		return m_context.assemblyString(_sourceCodes);
 	}
+	/// @returns a report of the optimiser statistics of the creation and runtime assemblies and
+	/// of the expressions the code generator computed at compile time.
+	std::string optimiserReport() const;
 	/// @arg _sourceCodes is the map of input files to source code strings
 	Json::Value assemblyJSON(StringMap const& _sourceCodes = StringMap()) const
 	{
@@ -33,6 +33,8 @@
 #include <libsolidity/inlineasm/AsmAnalysis.h>
 #include <libsolidity/inlineasm/AsmAnalysisInfo.h>
 
+#include <libevmasm/GasMeter.h>
+
 #include <boost/algorithm/string/replace.hpp>
 
 #include <utility>
@@ -47,6 +49,21 @@
 
 using namespace std;
 
+namespace
+{
+
+/// Without optimisation, only loops of at most this many iterations are unrolled.
+size_t const c_maxUnrolledIterationsWithoutOptimisation = 5;
+/// Upper limit for the number of iterations of unrolled loops, which keeps the code size bounded
+/// if many runs are expected.
+size_t const c_maxUnrolledIterations = 16;
+/// Gas spent per iteration of a loop on checking the condition and jumping back, and the size of
+/// the code for this.
+unsigned const c_loopGasPerIteration = 40;
+unsigned const c_loopBytes = 20;
+
+}
+
 namespace dev
 {
 namespace solidity
@@ -193,6 +210,22 @@ Declaration const* CompilerContext::nextFunctionToCompile() const
 	return m_functionCompilationQueue.nextFunctionToCompile();
 }
 
+size_t CompilerContext::maxUnrolledIterations(size_t _bytesPerIteration) const
+{
+	if (!m_optimiseRuns)
+		return c_maxUnrolledIterationsWithoutOptimisation;
+	// Unrolling n iterations saves the loop overhead of each of them on every run and costs
+	// n - 1 additional copies of the iteration, but not the code of the loop itself:
+	//   runs * loopGas * n >= createDataGas * (bytesPerIteration * (n - 1) - loopBytes)
+	// <=> n * (createDataGas * bytesPerIteration - runs * loopGas) <= createDataGas * (bytesPerIteration + loopBytes)
+	bigint codeCost = bigint(eth::GasCosts::createDataGas) * _bytesPerIteration;
+	bigint gasSaving = bigint(*m_optimiseRuns) * c_loopGasPerIteration;
+	if (codeCost <= gasSaving)
+		return c_maxUnrolledIterations;
+	bigint limit = bigint(eth::GasCosts::createDataGas) * (_bytesPerIteration + c_loopBytes) / (codeCost - gasSaving);
+	return size_t(min(limit, bigint(c_maxUnrolledIterations)));
+}
+
 ModifierDefinition const& CompilerContext::functionModifier(string const& _name) const
 {
 	solAssert(!m_inheritanceHierarchy.empty(), "No inheritance hierarchy set.");
@@ -274,7 +307,8 @@ void CompilerContext::resetVisitedNodes(ASTNode const* _node)
 void CompilerContext::appendInlineAssembly(
 	string const& _assembly,
 	vector<string> const& _localVariables,
-	bool _system
+	bool _system,
+	shared_ptr<assembly::Block> _code
 )
 {
 	int startStackHeight = stackHeight();
@@ -316,18 +350,41 @@ void CompilerContext::appendInlineAssembly(
 		}
 	};
 
+	shared_ptr<InlineAssemblyCache::Routine const> routine;
+	if (m_inlineAssemblyCache)
+		routine = m_inlineAssemblyCache->find(_assembly, _localVariables);
+	if (!routine)
+	{
+		routine = parseInlineAssembly(_assembly, identifierAccess, move(_code));
+		if (m_inlineAssemblyCache)
+			m_inlineAssemblyCache->add(_assembly, _localVariables, routine);
+	}
+	assembly::CodeGenerator::assemble(*routine->code, routine->analysisInfo, *m_asm, identifierAccess, _system);
+}
+
+shared_ptr<InlineAssemblyCache::Routine const> CompilerContext::parseInlineAssembly(
+	string const& _assembly,
+	julia::ExternalIdentifierAccess const& _identifierAccess,
+	shared_ptr<assembly::Block> _code
+)
+{
+	auto routine = make_shared<InlineAssemblyCache::Routine>();
 	ErrorList errors;
 	ErrorReporter errorReporter(errors);
 	auto scanner = make_shared<Scanner>(CharStream(_assembly), "--CODEGEN--");
-	auto parserResult = assembly::Parser(errorReporter).parse(scanner);
+	routine->code = _code ? move(_code) : assembly::Parser(errorReporter).parse(scanner);
 #ifdef SOL_OUTPUT_ASM
-	cout << assembly::AsmPrinter()(*parserResult) << endl;
+	cout << assembly::AsmPrinter()(*routine->code) << endl;
 #endif
-	assembly::AsmAnalysisInfo analysisInfo;
 	bool analyzerResult = false;
-	if (parserResult)
-		analyzerResult = assembly::AsmAnalyzer(analysisInfo, errorReporter, false, identifierAccess.resolve).analyze(*parserResult);
-	if (!parserResult || !errorReporter.errors().empty() || !analyzerResult)
+	if (routine->code)
+		analyzerResult = assembly::AsmAnalyzer(
+			routine->analysisInfo,
+			errorReporter,
+			false,
+			_identifierAccess.resolve
+		).analyze(*routine->code);
+	if (!routine->code || !errorReporter.errors().empty() || !analyzerResult)
 	{
 		string message =
 			"Error parsing/analyzing inline assembly block:\n"
@@ -346,7 +403,7 @@ void CompilerContext::appendInlineAssembly(
 	}
 
 	solAssert(errorReporter.errors().empty(), "Failed to analyze inline assembly block.");
-	assembly::CodeGenerator::assemble(*parserResult, analysisInfo, *m_asm, identifierAccess, _system);
+	return routine;
 }
 
 FunctionDefinition const& CompilerContext::resolveVirtualFunction(
@@ -23,6 +23,8 @@
 #pragma once
 
 #include <libsolidity/codegen/ABIFunctions.h>
+#include <libsolidity/codegen/ConstantFolder.h>
+#include <libsolidity/codegen/InlineAssemblyCache.h>
 
 #include <libsolidity/ast/ASTForward.h>
 #include <libsolidity/ast/Types.h>
@@ -33,6 +35,8 @@
 
 #include <libdevcore/Common.h>
 
+#include <boost/optional.hpp>
+
 #include <ostream>
 #include <stack>
 #include <queue>
@@ -40,8 +44,13 @@
 #include <functional>
 
 namespace dev {
+namespace julia
+{
+struct ExternalIdentifierAccess;
+}
 namespace solidity {
 
+class StorageCache;
 
 /**
  * Context to be shared by all units that compile the same contract.
@@ -50,9 +59,15 @@ namespace solidity {
 class CompilerContext
 {
 public:
-	explicit CompilerContext(CompilerContext* _runtimeContext = nullptr):
+	explicit CompilerContext(
+		CompilerContext* _runtimeContext = nullptr,
+		std::shared_ptr<InlineAssemblyCache> _inlineAssemblyCache = nullptr,
+		std::shared_ptr<ABIRoutineStore> _abiRoutineStore = nullptr
+	):
 		m_asm(std::make_shared<eth::Assembly>()),
-		m_runtimeContext(_runtimeContext)
+		m_runtimeContext(_runtimeContext),
+		m_abiFunctions(std::move(_abiRoutineStore)),
+		m_inlineAssemblyCache(std::move(_inlineAssemblyCache))
 	{
 		if (m_runtimeContext)
 			m_runtimeSub = size_t(m_asm->newSub(m_runtimeContext->m_asm).data());
@@ -124,6 +139,46 @@ public:
 	/// Generates the code for missing low-level functions, i.e. calls the generators passed above.
 	void appendMissingLowLevelFunctions();
 	ABIFunctions& abiFunctions() { return m_abiFunctions; }
+	/// @returns the cache of parsed inline assembly routines, can be null.
+	std::shared_ptr<InlineAssemblyCache> const& inlineAssemblyCache() const { return m_inlineAssemblyCache; }
+
+	/// @returns the evaluator for expressions whose values are known at compile time.
+	ConstantFolder& constantFolder() { return m_constantFolder; }
+	ConstantFolder const& constantFolder() const { return m_constantFolder; }
+
+	/// Sets the storage slots the function that is compiled keeps in memory, can be null.
+	void setStorageCache(StorageCache const* _storageCache) { m_storageCache = _storageCache; }
+	/// @returns the storage slots the function that is compiled keeps in memory, can be null.
+	StorageCache const* storageCache() const { return m_storageCache; }
+
+	/// Marks @a _indexAccess as always in range. If set, @a _elementAddress is the base stack offset
+	/// of a slot that holds the address of the accessed element.
+	void addInRangeIndexAccess(IndexAccess const& _indexAccess, boost::optional<unsigned> _elementAddress)
+	{
+		m_inRangeIndexAccesses[&_indexAccess] = _elementAddress;
+	}
+	void removeInRangeIndexAccess(IndexAccess const& _indexAccess) { m_inRangeIndexAccesses.erase(&_indexAccess); }
+	/// @returns the index accesses that are always in range, with the base stack offsets of the
+	/// addresses of their elements if these are kept on the stack.
+	std::map<IndexAccess const*, boost::optional<unsigned>> const& inRangeIndexAccesses() const
+	{
+		return m_inRangeIndexAccesses;
+	}
+
+	/// Sets the number of executions per deployment the optimised code is expected to see, which
+	/// decides how far loops with a known number of iterations are unrolled.
+	void setOptimiseRuns(size_t _runs) { m_optimiseRuns = _runs; }
+	/// @returns the largest number of iterations of a loop that is unrolled if each iteration takes
+	/// @a _bytesPerIteration bytes of code. Without optimisation, this is a small fixed number.
+	size_t maxUnrolledIterations(size_t _bytesPerIteration) const;
+	/// Records whether the loop at @a _location, which has @a _iterations iterations, is unrolled.
+	void addLoopUnrolling(SourceLocation const& _location, u256 const& _iterations, bool _unrolled)
+	{
+		m_loopUnrollings[_location] = std::make_pair(_iterations, _unrolled);
+	}
+	/// @returns the loops with a known number of iterations that were compiled, with their
+	/// number of iterations and whether they were unrolled.
+	std::map<SourceLocation, std::pair<u256, bool>> const& loopUnrollings() const { return m_loopUnrollings; }
 
 	ModifierDefinition const& functionModifier(std::string const& _name) const;
 	/// Returns the distance of the given local variable from the bottom of the stack (of the current function).
@@ -191,10 +246,13 @@ public:
 	/// prior to parsing the inline assembly.
 	/// @param _localVariables assigns stack positions to variables with the last one being the stack top
 	/// @param _system if true, this is a "system-level" assembly where all functions use named labels.
+	/// The parsed and analyzed assembly is reused from the inline assembly cache if there is one.
+	/// @param _code if given, the already parsed @a _assembly, which then only has to be analyzed.
 	void appendInlineAssembly(
 		std::string const& _assembly,
 		std::vector<std::string> const& _localVariables = std::vector<std::string>(),
-		bool _system = false
+		bool _system = false,
+		std::shared_ptr<assembly::Block> _code = nullptr
 	);
 
 	/// Appends arbitrary data to the end of the bytecode.
@@ -220,6 +278,9 @@ public:
 		return m_asm->assemblyString(_sourceCodes);
 	}
 
+	/// @returns a report of the optimiser statistics of the assembly and its sub-assemblies.
+	std::string optimiserReport() const { return m_asm->optimiserReport(); }
+
 	/// @arg _sourceCodes is the map of input files to source code strings
 	Json::Value assemblyJSON(StringMap const& _sourceCodes = StringMap()) const
 	{
@@ -240,6 +301,12 @@ public:
 	};
 
 private:
+	/// Parses (unless @a _code is given) and analyzes an inline assembly block generated by the compiler.
+	std::shared_ptr<InlineAssemblyCache::Routine const> parseInlineAssembly(
+		std::string const& _assembly,
+		julia::ExternalIdentifierAccess const& _identifierAccess,
+		std::shared_ptr<assembly::Block> _code
+	);
 	/// Searches the inheritance hierarchy towards the base starting from @a _searchStart and returns
 	/// the first function definition that is overwritten by _function.
 	FunctionDefinition const& resolveVirtualFunction(
@@ -309,6 +376,18 @@ private:
 	ABIFunctions m_abiFunctions;
 	/// The queue of low-level functions to generate.
 	std::queue<std::tuple<std::string, unsigned, unsigned, std::function<void(CompilerContext&)>>> m_lowLevelFunctionGenerationQueue;
+	/// Parsed inline assembly routines shared between the contexts of one compilation, can be null.
+	std::shared_ptr<InlineAssemblyCache> m_inlineAssemblyCache;
+	/// Values of the expressions that are computed at compile time.
+	ConstantFolder m_constantFolder;
+	/// Storage slots the function that is compiled keeps in memory, can be null.
+	StorageCache const* m_storageCache = nullptr;
+	/// Index accesses the loops around the code that is compiled keep in range.
+	std::map<IndexAccess const*, boost::optional<unsigned>> m_inRangeIndexAccesses;
+	/// Expected number of executions per deployment if the code is optimised.
+	boost::optional<size_t> m_optimiseRuns;
+	/// Loops with a known number of iterations, see loopUnrollings().
+	std::map<SourceLocation, std::pair<u256, bool>> m_loopUnrollings;
 };
 
 }
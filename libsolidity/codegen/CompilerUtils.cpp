@@ -38,9 +38,9 @@ const unsigned CompilerUtils::dataStartOffset = 4;
 const size_t CompilerUtils::freeMemoryPointer = 64;
 const unsigned CompilerUtils::identityContractAddress = 4;
 
-void CompilerUtils::initialiseFreeMemoryPointer()
+void CompilerUtils::initialiseFreeMemoryPointer(size_t _reservedMemory)
 {
-	m_context << u256(freeMemoryPointer + 32);
+	m_context << u256(freeMemoryPointer + 32 + _reservedMemory);
 	storeFreeMemoryPointer();
 }
 
@@ -394,6 +394,22 @@ void CompilerUtils::memoryCopy()
 	m_context << Instruction::POP << Instruction::POP << Instruction::POP;
 }
 
+void CompilerUtils::memoryCopyPrecompile()
+{
+	// Stack here: size target source
+
+	m_context.appendInlineAssembly(R"(
+		{
+			let words := div(add(len, 31), 32)
+			let cost := add(15, mul(3, words))
+			if iszero(call(cost, )" + to_string(identityContractAddress) + R"(, 0, src, len, dst, len)) { invalid() }
+		}
+	)",
+		{ "len", "dst", "src" }
+	);
+	m_context << Instruction::POP << Instruction::POP << Instruction::POP;
+}
+
 void CompilerUtils::splitExternalFunctionType(bool _leftAligned)
 {
 	// We have to split the left-aligned <address><function identifier> into two stack slots:
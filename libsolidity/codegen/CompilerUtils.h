@@ -35,8 +35,9 @@ class CompilerUtils
 public:
 	explicit CompilerUtils(CompilerContext& _context): m_context(_context) {}
 
-	/// Stores the initial value of the free-memory-pointer at its position;
-	void initialiseFreeMemoryPointer();
+	/// Stores the initial value of the free-memory-pointer at its position, leaving
+	/// @a _reservedMemory bytes before it.
+	void initialiseFreeMemoryPointer(size_t _reservedMemory = 0);
 	/// Copies the free memory pointer to the stack.
 	/// Stack pre:
 	/// Stack post: <mem_start>
@@ -169,6 +170,10 @@ public:
 	/// Stack pre: <size> <target> <source>
 	/// Stack post:
 	void memoryCopy();
+	/// Copies data from one memory location to another using the identity precompile.
+	/// Stack pre: <size> <target> <source>
+	/// Stack post:
+	void memoryCopyPrecompile();
 
 	/// Converts the combined and left-aligned (right-aligned if @a _rightAligned is true)
 	/// external function type <address><function identifier> into two stack slots:
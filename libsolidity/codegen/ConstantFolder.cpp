@@ -0,0 +1,735 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Evaluation of value type expressions, hashes and mapping slots at compile time.
+ */
+
+#include <libsolidity/codegen/ConstantFolder.h>
+
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/codegen/CompilerContext.h>
+#include <libsolidity/codegen/ExpressionCompiler.h>
+
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/SHA3.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace
+{
+
+/// Thrown if an expression cannot be evaluated at compile time.
+struct NotConstant: virtual Exception {};
+
+/// Maximal number of expressions and statements evaluated for one folded expression.
+size_t const c_maxSteps = 10000;
+/// Maximal depth of nested function calls.
+size_t const c_maxCallDepth = 32;
+
+/// @returns @a _value with the higher order bits cleaned up for @a _type, like
+/// CompilerUtils::cleanHigherOrderBits.
+u256 cleanHigherOrderBits(u256 const& _value, IntegerType const& _type)
+{
+	if (_type.numBits() == 256)
+		return _value;
+	u256 mask = (u256(1) << _type.numBits()) - 1;
+	if (_type.isSigned() && boost::multiprecision::bit_test(_value, _type.numBits() - 1))
+		return _value | ~mask;
+	return _value & mask;
+}
+
+/// @returns the constant variable @a _expression refers to as ``x`` or ``C.x``.
+VariableDeclaration const* referencedConstant(Expression const& _expression)
+{
+	Declaration const* declaration = nullptr;
+	if (auto identifier = dynamic_cast<Identifier const*>(&_expression))
+		declaration = identifier->annotation().referencedDeclaration;
+	else if (auto memberAccess = dynamic_cast<MemberAccess const*>(&_expression))
+		if (dynamic_cast<TypeType const*>(memberAccess->expression().annotation().type.get()))
+			declaration = memberAccess->annotation().referencedDeclaration;
+	auto variable = dynamic_cast<VariableDeclaration const*>(declaration);
+	return variable && variable->isConstant() ? variable : nullptr;
+}
+
+/// @returns the result of SDIV.
+u256 signedDivision(u256 const& _left, u256 const& _right)
+{
+	if (_right == 0)
+		return 0;
+	return s2u(u2s(_left) / u2s(_right));
+}
+
+/// @returns the result of SMOD.
+u256 signedModulo(u256 const& _left, u256 const& _right)
+{
+	if (_right == 0)
+		return 0;
+	return s2u(u2s(_left) % u2s(_right));
+}
+
+}
+
+boost::optional<u256> ConstantFolder::value(Expression const& _expression, CompilerContext& _context)
+{
+	auto cached = m_values.find(&_expression);
+	if (cached != m_values.end())
+		return cached->second;
+
+	boost::optional<u256> result;
+	TypePointer const& type = _expression.annotation().type;
+	if (type && type->category() != Type::Category::RationalNumber && supported(*type))
+	{
+		result = tryEvaluate(_context, [&]() { return evaluate(_expression); });
+		// Literals and constants are pushed as they are anyway.
+		if (m_operations == 0)
+			result = boost::none;
+	}
+	if (result)
+		m_folded[&_expression] = *result;
+	m_values[&_expression] = result;
+	return result;
+}
+
+boost::optional<u256> ConstantFolder::mappingSlot(IndexAccess const& _indexAccess, CompilerContext& _context)
+{
+	auto cached = m_slots.find(&_indexAccess);
+	if (cached != m_slots.end())
+		return cached->second;
+
+	boost::optional<u256> result = tryEvaluate(_context, [&]() { return evaluateMappingSlot(_indexAccess); });
+	if (result)
+		m_folded[&_indexAccess] = *result;
+	m_slots[&_indexAccess] = result;
+	return result;
+}
+
+boost::optional<u256> ConstantFolder::valueAs(Expression const& _expression, Type const& _type, CompilerContext& _context)
+{
+	if (!supported(_type))
+		return boost::none;
+	return tryEvaluate(_context, [&]() { return evaluateAs(_expression, _type, true); });
+}
+
+vector<pair<SourceLocation, u256>> ConstantFolder::foldedExpressions() const
+{
+	vector<pair<SourceLocation, u256>> folded;
+	for (auto const& expression: m_folded)
+		folded.push_back(make_pair(expression.first->location(), expression.second));
+	sort(folded.begin(), folded.end());
+	return folded;
+}
+
+boost::optional<u256> ConstantFolder::tryEvaluate(CompilerContext& _context, function<u256()> const& _evaluation)
+{
+	boost::optional<u256> result;
+	m_context = &_context;
+	m_steps = 0;
+	m_operations = 0;
+	try
+	{
+		result = _evaluation();
+	}
+	catch (NotConstant const&)
+	{
+	}
+	m_frames.clear();
+	m_context = nullptr;
+	return result;
+}
+
+u256 ConstantFolder::evaluate(Expression const& _expression)
+{
+	step();
+	Type const& type = *_expression.annotation().type;
+	if (auto rationalType = dynamic_cast<RationalNumberType const*>(&type))
+	{
+		if (rationalType->isFractional())
+			throw NotConstant();
+		return type.literalValue(nullptr);
+	}
+
+	if (auto literal = dynamic_cast<Literal const*>(&_expression))
+	{
+		if (type.category() != Type::Category::Bool)
+			throw NotConstant();
+		return type.literalValue(literal);
+	}
+	else if (VariableDeclaration const* variable = referencedConstant(_expression))
+		return evaluateVariable(*variable);
+	else if (dynamic_cast<Identifier const*>(&_expression))
+		return localVariable(_expression);
+	else if (auto tuple = dynamic_cast<TupleExpression const*>(&_expression))
+	{
+		if (tuple->isInlineArray() || tuple->components().size() != 1 || !tuple->components().front())
+			throw NotConstant();
+		return evaluate(*tuple->components().front());
+	}
+	else if (auto conditional = dynamic_cast<Conditional const*>(&_expression))
+	{
+		if (!supported(type))
+			throw NotConstant();
+		m_operations++;
+		Expression const& branch = evaluate(conditional->condition()) != 0 ?
+			conditional->trueExpression() :
+			conditional->falseExpression();
+		return evaluateAs(branch, type);
+	}
+	else if (auto operation = dynamic_cast<UnaryOperation const*>(&_expression))
+		return evaluateUnaryOperation(*operation);
+	else if (auto operation = dynamic_cast<BinaryOperation const*>(&_expression))
+		return evaluateBinaryOperation(*operation);
+	else if (auto assignment = dynamic_cast<Assignment const*>(&_expression))
+		return evaluateAssignment(*assignment);
+	else if (auto functionCall = dynamic_cast<FunctionCall const*>(&_expression))
+		return evaluateFunctionCall(*functionCall);
+	throw NotConstant();
+}
+
+u256 ConstantFolder::evaluateAs(Expression const& _expression, Type const& _type, bool _cleanup)
+{
+	Type const& type = *_expression.annotation().type;
+	if (auto literalType = dynamic_cast<StringLiteralType const*>(&type))
+	{
+		step();
+		if (_type.category() != Type::Category::FixedBytes || literalType->value().size() > 32)
+			throw NotConstant();
+		return h256(bytesConstRef(literalType->value()), h256::AlignLeft);
+	}
+	return convert(evaluate(_expression), type, _type, _cleanup);
+}
+
+u256 ConstantFolder::evaluateBinaryOperation(BinaryOperation const& _operation)
+{
+	Token::Value const op = _operation.getOperator();
+	Expression const& leftExpression = _operation.leftExpression();
+	Expression const& rightExpression = _operation.rightExpression();
+	if (op == Token::And || op == Token::Or)
+	{
+		m_operations++;
+		u256 left = evaluate(leftExpression);
+		// The left value is kept if it decides the result.
+		if ((op == Token::And) == (left == 0))
+			return left;
+		return evaluate(rightExpression);
+	}
+
+	TypePointer const& commonType = _operation.annotation().commonType;
+	solAssert(!!commonType, "");
+	if (commonType->category() == Type::Category::RationalNumber)
+		return commonType->literalValue(nullptr);
+	if (!supported(*commonType))
+		throw NotConstant();
+
+	bool cleanupNeeded = ExpressionCompiler::cleanupNeededForOp(commonType->category(), op);
+	TypePointer rightTargetType = Token::isShiftOp(op) ? rightExpression.annotation().type->mobileType() : commonType;
+	if (!rightTargetType)
+		throw NotConstant();
+	m_operations++;
+	// The code generator evaluates the right operand first unless it is a literal.
+	u256 right = evaluateAs(rightExpression, *rightTargetType, cleanupNeeded);
+	u256 left = evaluateAs(leftExpression, *commonType, cleanupNeeded);
+	return applyOperator(op, *commonType, *rightTargetType, left, right);
+}
+
+u256 ConstantFolder::evaluateUnaryOperation(UnaryOperation const& _operation)
+{
+	Expression const& subExpression = _operation.subExpression();
+	switch (_operation.getOperator())
+	{
+	case Token::Delete:
+		m_operations++;
+		localVariable(subExpression) = 0;
+		return 0;
+	case Token::Inc:
+	case Token::Dec:
+	{
+		m_operations++;
+		u256& variable = localVariable(subExpression);
+		u256 previous = variable;
+		variable = _operation.getOperator() == Token::Inc ? previous + 1 : previous - 1;
+		return _operation.isPrefixOperation() ? variable : previous;
+	}
+	case Token::Not:
+		m_operations++;
+		return evaluate(subExpression) == 0 ? 1 : 0;
+	case Token::BitNot:
+		m_operations++;
+		return ~evaluate(subExpression);
+	case Token::Add:
+		return evaluate(subExpression);
+	case Token::Sub:
+		m_operations++;
+		return u256(0) - evaluate(subExpression);
+	default:
+		throw NotConstant();
+	}
+}
+
+u256 ConstantFolder::evaluateAssignment(Assignment const& _assignment)
+{
+	Token::Value const op = _assignment.assignmentOperator();
+	Token::Value const binOp = op == Token::Assign ? op : Token::AssignmentToBinaryOp(op);
+	Expression const& rightHandSide = _assignment.rightHandSide();
+	Type const& leftType = *_assignment.leftHandSide().annotation().type;
+	if (!supported(leftType))
+		throw NotConstant();
+
+	bool cleanupNeeded = op != Token::Assign && ExpressionCompiler::cleanupNeededForOp(leftType.category(), binOp);
+	TypePointer rightIntermediateType;
+	if (op != Token::Assign && Token::isShiftOp(binOp))
+		rightIntermediateType = rightHandSide.annotation().type->mobileType();
+	else
+		rightIntermediateType = rightHandSide.annotation().type->closestTemporaryType(
+			_assignment.leftHandSide().annotation().type
+		);
+	if (!rightIntermediateType)
+		throw NotConstant();
+	m_operations++;
+	u256 right = evaluateAs(rightHandSide, *rightIntermediateType, cleanupNeeded);
+
+	u256& variable = localVariable(_assignment.leftHandSide());
+	if (op == Token::Assign)
+		variable = right;
+	else
+		variable = applyOperator(
+			binOp,
+			leftType,
+			*rightIntermediateType,
+			convert(variable, leftType, leftType, cleanupNeeded),
+			right
+		);
+	return variable;
+}
+
+u256 ConstantFolder::evaluateFunctionCall(FunctionCall const& _functionCall)
+{
+	vector<ASTPointer<Expression const>> const& arguments = _functionCall.arguments();
+	if (_functionCall.annotation().kind == FunctionCallKind::TypeConversion)
+		return evaluateAs(*arguments.front(), *_functionCall.annotation().type);
+	if (_functionCall.annotation().kind != FunctionCallKind::FunctionCall || !_functionCall.names().empty())
+		throw NotConstant();
+
+	FunctionType const& function = dynamic_cast<FunctionType const&>(*_functionCall.expression().annotation().type);
+	switch (function.kind())
+	{
+	case FunctionType::Kind::Assert:
+	case FunctionType::Kind::Require:
+	{
+		m_operations++;
+		if (evaluateAs(*arguments.front(), *function.parameterTypes().front()) == 0)
+			throw NotConstant();
+		return 0;
+	}
+	case FunctionType::Kind::SHA3:
+	{
+		bytes data;
+		for (ASTPointer<Expression const> const& argument: arguments)
+			data += packedEncoding(*argument);
+		m_operations++;
+		return u256(keccak256(data));
+	}
+	case FunctionType::Kind::Internal:
+	{
+		if (function.bound())
+			throw NotConstant();
+		// Resolve the function the same way the code generator does: identifiers refer to the
+		// most derived override, ``C.f`` to the function of ``C``.
+		FunctionDefinition const* definition = nullptr;
+		Expression const& callee = _functionCall.expression();
+		if (auto identifier = dynamic_cast<Identifier const*>(&callee))
+		{
+			if (auto declaration = dynamic_cast<FunctionDefinition const*>(identifier->annotation().referencedDeclaration))
+				definition = &m_context->resolveVirtualFunction(*declaration);
+		}
+		else if (auto memberAccess = dynamic_cast<MemberAccess const*>(&callee))
+			if (dynamic_cast<TypeType const*>(memberAccess->expression().annotation().type.get()))
+				definition = dynamic_cast<FunctionDefinition const*>(memberAccess->annotation().referencedDeclaration);
+		if (!definition)
+			throw NotConstant();
+
+		vector<u256> values;
+		for (size_t i = 0; i < arguments.size(); ++i)
+			values.push_back(evaluateAs(*arguments[i], *function.parameterTypes()[i]));
+		m_operations++;
+		return call(*definition, values);
+	}
+	default:
+		throw NotConstant();
+	}
+}
+
+u256 ConstantFolder::evaluateVariable(VariableDeclaration const& _variable)
+{
+	if (!_variable.value() || !supported(*_variable.annotation().type))
+		throw NotConstant();
+	return evaluateAs(*_variable.value(), *_variable.annotation().type);
+}
+
+u256 ConstantFolder::evaluateMappingSlot(IndexAccess const& _indexAccess)
+{
+	step();
+	Expression const& base = _indexAccess.baseExpression();
+	auto mappingType = dynamic_cast<MappingType const*>(base.annotation().type.get());
+	if (!mappingType || !_indexAccess.indexExpression())
+		throw NotConstant();
+
+	u256 slot;
+	if (auto baseAccess = dynamic_cast<IndexAccess const*>(&base))
+		slot = evaluateMappingSlot(*baseAccess);
+	else
+	{
+		auto identifier = dynamic_cast<Identifier const*>(&base);
+		Declaration const* variable = identifier ? identifier->annotation().referencedDeclaration : nullptr;
+		if (!variable || !m_context->isStateVariable(variable))
+			throw NotConstant();
+		slot = m_context->storageLocationOfVariable(*variable).first;
+	}
+
+	// The slot is the hash of the key, padded to a word unless it is dynamically sized, and
+	// the slot of the mapping.
+	Expression const& key = *_indexAccess.indexExpression();
+	TypePointer const& keyType = mappingType->keyType();
+	bytes data;
+	if (keyType->isDynamicallySized())
+		data = packedEncoding(key);
+	else if (supported(*keyType))
+		data = toBigEndian(evaluateAs(key, *keyType, true));
+	else
+		throw NotConstant();
+	data += toBigEndian(slot);
+	m_operations++;
+	return u256(keccak256(data));
+}
+
+bytes ConstantFolder::packedEncoding(Expression const& _expression)
+{
+	step();
+	Type const& type = *_expression.annotation().type;
+	if (auto literalType = dynamic_cast<StringLiteralType const*>(&type))
+		return asBytes(literalType->value());
+	if (auto arrayType = dynamic_cast<ArrayType const*>(&type))
+	{
+		// Constant strings are string literals copied to memory.
+		VariableDeclaration const* variable = referencedConstant(_expression);
+		if (!arrayType->isByteArray() || !variable || !variable->value())
+			throw NotConstant();
+		return packedEncoding(*variable->value());
+	}
+
+	TypePointer encodingType = type.mobileType();
+	if (encodingType)
+		encodingType = encodingType->interfaceType(false);
+	if (encodingType)
+		encodingType = encodingType->encodingType();
+	if (!encodingType || !supported(*encodingType))
+		throw NotConstant();
+	// Values take as many bytes as they have, fixed bytes are left-aligned in their word.
+	bytes word = toBigEndian(evaluateAs(_expression, *encodingType, true));
+	size_t size = encodingType->calldataEncodedSize(false);
+	if (encodingType->category() == Type::Category::FixedBytes)
+		return bytes(word.begin(), word.begin() + size);
+	return bytes(word.end() - size, word.end());
+}
+
+u256 ConstantFolder::call(FunctionDefinition const& _function, vector<u256> const& _arguments)
+{
+	if (
+		m_frames.size() >= c_maxCallDepth ||
+		!_function.isImplemented() ||
+		_function.isConstructor() ||
+		!_function.modifiers().empty() ||
+		_function.returnParameters().size() > 1
+	)
+		throw NotConstant();
+
+	// Like in the generated code, return parameters and local variables start as zero.
+	Frame frame;
+	solAssert(_function.parameters().size() == _arguments.size(), "");
+	for (size_t i = 0; i < _arguments.size(); ++i)
+		frame[_function.parameters()[i].get()] = _arguments[i];
+	for (ASTPointer<VariableDeclaration> const& variable: _function.returnParameters())
+		frame[variable.get()] = 0;
+	for (VariableDeclaration const* variable: _function.localVariables())
+		frame[variable] = 0;
+	for (auto const& variable: frame)
+		if (!supported(*variable.first->annotation().type))
+			throw NotConstant();
+
+	m_frames.push_back(move(frame));
+	execute(_function.body());
+	u256 result = _function.returnParameters().empty() ? 0 : m_frames.back().at(_function.returnParameters().front().get());
+	m_frames.pop_back();
+	return result;
+}
+
+ConstantFolder::Flow ConstantFolder::execute(Statement const& _statement)
+{
+	step();
+	if (auto block = dynamic_cast<Block const*>(&_statement))
+	{
+		for (ASTPointer<Statement> const& statement: block->statements())
+		{
+			Flow flow = execute(*statement);
+			if (flow != Flow::Next)
+				return flow;
+		}
+	}
+	else if (auto declaration = dynamic_cast<VariableDeclarationStatement const*>(&_statement))
+	{
+		// Without initial value, the variable keeps its value.
+		if (Expression const* initialValue = declaration->initialValue())
+		{
+			vector<VariableDeclaration const*> const& assignments = declaration->annotation().assignments;
+			if (assignments.size() != 1)
+				throw NotConstant();
+			if (VariableDeclaration const* variable = assignments.front())
+				m_frames.back().at(variable) = evaluateAs(*initialValue, *variable->annotation().type);
+			else
+				evaluate(*initialValue);
+		}
+	}
+	else if (auto expressionStatement = dynamic_cast<ExpressionStatement const*>(&_statement))
+		evaluate(expressionStatement->expression());
+	else if (auto ifStatement = dynamic_cast<IfStatement const*>(&_statement))
+	{
+		if (evaluate(ifStatement->condition()) != 0)
+			return execute(ifStatement->trueStatement());
+		else if (ifStatement->falseStatement())
+			return execute(*ifStatement->falseStatement());
+	}
+	else if (auto whileStatement = dynamic_cast<WhileStatement const*>(&_statement))
+		// ``continue`` jumps to the start of the loop, which is the body for do-while loops.
+		while (whileStatement->isDoWhile() || evaluate(whileStatement->condition()) != 0)
+		{
+			Flow flow = execute(whileStatement->body());
+			if (flow == Flow::Break)
+				break;
+			else if (flow == Flow::Return)
+				return flow;
+			else if (
+				flow == Flow::Next &&
+				whileStatement->isDoWhile() &&
+				evaluate(whileStatement->condition()) == 0
+			)
+				break;
+		}
+	else if (auto forStatement = dynamic_cast<ForStatement const*>(&_statement))
+	{
+		if (forStatement->initializationExpression())
+			execute(*forStatement->initializationExpression());
+		while (!forStatement->condition() || evaluate(*forStatement->condition()) != 0)
+		{
+			Flow flow = execute(forStatement->body());
+			if (flow == Flow::Break)
+				break;
+			else if (flow == Flow::Return)
+				return flow;
+			if (forStatement->loopExpression())
+				execute(*forStatement->loopExpression());
+		}
+	}
+	else if (dynamic_cast<Continue const*>(&_statement))
+		return Flow::Continue;
+	else if (dynamic_cast<Break const*>(&_statement))
+		return Flow::Break;
+	else if (auto returnStatement = dynamic_cast<Return const*>(&_statement))
+	{
+		if (Expression const* expression = returnStatement->expression())
+		{
+			vector<ASTPointer<VariableDeclaration>> const& returnParameters =
+				returnStatement->annotation().functionReturnParameters->parameters();
+			if (returnParameters.size() != 1)
+				throw NotConstant();
+			VariableDeclaration const& variable = *returnParameters.front();
+			m_frames.back().at(&variable) = evaluateAs(*expression, *variable.annotation().type);
+		}
+		return Flow::Return;
+	}
+	else
+		throw NotConstant();
+	return Flow::Next;
+}
+
+u256& ConstantFolder::localVariable(Expression const& _expression)
+{
+	auto identifier = dynamic_cast<Identifier const*>(&_expression);
+	if (!identifier || m_frames.empty())
+		throw NotConstant();
+	auto variable = m_frames.back().find(
+		dynamic_cast<VariableDeclaration const*>(identifier->annotation().referencedDeclaration)
+	);
+	if (variable == m_frames.back().end())
+		throw NotConstant();
+	return variable->second;
+}
+
+void ConstantFolder::step()
+{
+	if (++m_steps > c_maxSteps)
+		throw NotConstant();
+}
+
+u256 ConstantFolder::applyOperator(
+	Token::Value _operator,
+	Type const& _type,
+	Type const& _rightType,
+	u256 const& _left,
+	u256 const& _right
+)
+{
+	bool isSigned = false;
+	if (auto integerType = dynamic_cast<IntegerType const*>(&_type))
+		isSigned = integerType->isSigned();
+
+	switch (_operator)
+	{
+	case Token::Equal:
+		return _left == _right ? 1 : 0;
+	case Token::NotEqual:
+		return _left != _right ? 1 : 0;
+	case Token::LessThan:
+		return (isSigned ? u2s(_left) < u2s(_right) : _left < _right) ? 1 : 0;
+	case Token::GreaterThan:
+		return (isSigned ? u2s(_left) > u2s(_right) : _left > _right) ? 1 : 0;
+	case Token::LessThanOrEqual:
+		return (isSigned ? u2s(_left) <= u2s(_right) : _left <= _right) ? 1 : 0;
+	case Token::GreaterThanOrEqual:
+		return (isSigned ? u2s(_left) >= u2s(_right) : _left >= _right) ? 1 : 0;
+	case Token::Add:
+		return _left + _right;
+	case Token::Sub:
+		return _left - _right;
+	case Token::Mul:
+		return _left * _right;
+	case Token::Div:
+	case Token::Mod:
+		// The generated code reverts.
+		if (_right == 0)
+			throw NotConstant();
+		if (_operator == Token::Div)
+			return isSigned ? signedDivision(_left, _right) : _left / _right;
+		else
+			return isSigned ? signedModulo(_left, _right) : _left % _right;
+	case Token::Exp:
+		return u256(boost::multiprecision::powm(bigint(_left), bigint(_right), bigint(1) << 256));
+	case Token::BitOr:
+		return _left | _right;
+	case Token::BitAnd:
+		return _left & _right;
+	case Token::BitXor:
+		return _left ^ _right;
+	case Token::SHL:
+	case Token::SAR:
+	{
+		auto amountType = dynamic_cast<IntegerType const*>(&_rightType);
+		// The generated code reverts for negative shift amounts.
+		if (amountType && amountType->isSigned() && u2s(_right) < 0)
+			throw NotConstant();
+		// Shifts are multiplications and divisions by 2**amount, which is zero for large amounts.
+		u256 factor = _right < 256 ? u256(1) << unsigned(_right) : u256(0);
+		if (_operator == Token::SHL)
+			return _left * factor;
+		else if (factor == 0)
+			return 0;
+		else
+			return isSigned ? signedDivision(_left, factor) : _left / factor;
+	}
+	default:
+		throw NotConstant();
+	}
+}
+
+u256 ConstantFolder::convert(u256 const& _value, Type const& _from, Type const& _to, bool _cleanup)
+{
+	if (!supported(_from) || !supported(_to))
+		throw NotConstant();
+	if (_from == _to && !_cleanup)
+		return _value;
+
+	if (_to.category() == Type::Category::Bool && _from.category() == Type::Category::Bool)
+		return _cleanup ? (_value != 0 ? 1 : 0) : _value;
+	if (auto sourceType = dynamic_cast<FixedBytesType const*>(&_from))
+	{
+		int sourceBits = sourceType->numBytes() * 8;
+		if (auto targetType = dynamic_cast<FixedBytesType const*>(&_to))
+		{
+			// The bytes after the value are cleared for longer types.
+			if (targetType->numBytes() > sourceType->numBytes() || _cleanup)
+				return _value & ~((u256(1) << (256 - sourceBits)) - 1);
+			return _value;
+		}
+		else if (_to.category() != Type::Category::Integer)
+			throw NotConstant();
+		u256 value = _value >> (256 - sourceBits);
+		if (dynamic_cast<IntegerType const&>(_to).numBits() < sourceBits)
+			return convert(value, IntegerType(sourceBits), _to, _cleanup);
+		return value;
+	}
+	else if (auto targetType = dynamic_cast<FixedBytesType const*>(&_to))
+	{
+		// Integers are right-aligned, fixed bytes left-aligned.
+		u256 value = _value;
+		if (auto sourceType = dynamic_cast<IntegerType const*>(&_from))
+		{
+			if (targetType->numBytes() * 8 > sourceType->numBits())
+				value = cleanHigherOrderBits(value, *sourceType);
+		}
+		else if (_from.category() != Type::Category::RationalNumber)
+			throw NotConstant();
+		return value << (256 - targetType->numBytes() * 8);
+	}
+	auto targetType = dynamic_cast<IntegerType const*>(&_to);
+	if (!targetType)
+		throw NotConstant();
+	if (auto rationalType = dynamic_cast<RationalNumberType const*>(&_from))
+	{
+		// The literal is clean, it is only cleaned up for narrowing conversions that request it.
+		shared_ptr<IntegerType const> literalType = rationalType->integerType();
+		if (!literalType)
+			throw NotConstant();
+		if (targetType->numBits() < literalType->numBits() && _cleanup)
+			return cleanHigherOrderBits(_value, *targetType);
+		return _value;
+	}
+	auto sourceType = dynamic_cast<IntegerType const*>(&_from);
+	if (!sourceType)
+		throw NotConstant();
+	if (targetType->numBits() > sourceType->numBits())
+		return cleanHigherOrderBits(_value, *sourceType);
+	else if (_cleanup)
+		return cleanHigherOrderBits(_value, *targetType);
+	return _value;
+}
+
+bool ConstantFolder::supported(Type const& _type)
+{
+	switch (_type.category())
+	{
+	case Type::Category::Integer:
+	case Type::Category::Bool:
+	case Type::Category::FixedBytes:
+		return true;
+	case Type::Category::RationalNumber:
+		return !dynamic_cast<RationalNumberType const&>(_type).isFractional();
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,129 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Evaluation of value type expressions, hashes and mapping slots at compile time.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTForward.h>
+#include <libsolidity/parsing/Token.h>
+
+#include <libevmasm/SourceLocation.h>
+
+#include <libdevcore/Common.h>
+
+#include <boost/optional.hpp>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+class CompilerContext;
+class Type;
+
+/**
+ * Evaluates expressions of integer, boolean and fixed bytes type whose value does not depend on
+ * anything but literals and constants, so that the code generator can push the value instead of
+ * computing it. Apart from operators, conversions and constant state variables, this covers
+ * ``keccak256`` of such values and of string literals, and calls to internal functions (resolved
+ * like the code generator resolves them) whose bodies only compute with local variables of these
+ * types, as pure functions do. The storage slots of mapping elements with constant keys are
+ * computed in the same way.
+ *
+ * The result is the value the generated code would leave on the stack, including higher order
+ * bits that are not cleaned up yet. Expressions that would revert (division by zero, failing
+ * ``require``), that do not finish within a fixed number of steps or that contain anything
+ * else are left to the generated code.
+ */
+class ConstantFolder
+{
+public:
+	/// @returns the value of @a _expression if it can be computed at compile time and doing so
+	/// saves at least one operation, and records the expression as folded in that case.
+	/// Internal functions are resolved in the inheritance hierarchy of @a _context.
+	boost::optional<u256> value(Expression const& _expression, CompilerContext& _context);
+	/// @returns the storage slot of the mapping element @a _indexAccess if the mapping is a state
+	/// variable or an element of such a mapping and all keys are constant, and records the access
+	/// as folded in that case.
+	boost::optional<u256> mappingSlot(IndexAccess const& _indexAccess, CompilerContext& _context);
+	/// @returns the value of @a _expression converted to @a _type if it can be computed at compile
+	/// time, even if it is a literal. Nothing is recorded as folded.
+	boost::optional<u256> valueAs(Expression const& _expression, Type const& _type, CompilerContext& _context);
+
+	/// @returns the locations and values of the expressions that were folded, in source order.
+	std::vector<std::pair<SourceLocation, u256>> foldedExpressions() const;
+
+private:
+	/// Values of the local variables of the functions that are evaluated, innermost last.
+	using Frame = std::map<VariableDeclaration const*, u256>;
+	/// Outcome of executing a statement.
+	enum class Flow { Next, Break, Continue, Return };
+
+	/// @returns the result of @a _evaluation unless it gives up.
+	boost::optional<u256> tryEvaluate(CompilerContext& _context, std::function<u256()> const& _evaluation);
+
+	u256 evaluate(Expression const& _expression);
+	/// @returns the value of @a _expression converted to @a _type. Unlike evaluate, this also
+	/// accepts string literals that are converted to fixed bytes.
+	u256 evaluateAs(Expression const& _expression, Type const& _type, bool _cleanup = false);
+	u256 evaluateBinaryOperation(BinaryOperation const& _operation);
+	u256 evaluateUnaryOperation(UnaryOperation const& _operation);
+	u256 evaluateAssignment(Assignment const& _assignment);
+	u256 evaluateFunctionCall(FunctionCall const& _functionCall);
+	u256 evaluateVariable(VariableDeclaration const& _variable);
+	u256 evaluateMappingSlot(IndexAccess const& _indexAccess);
+	/// @returns the bytes the code generator writes to memory for @a _expression as argument
+	/// of ``keccak256``.
+	bytes packedEncoding(Expression const& _expression);
+	/// Runs the body of @a _function with @a _arguments and @returns the value of its return
+	/// parameter (zero if it has none).
+	u256 call(FunctionDefinition const& _function, std::vector<u256> const& _arguments);
+	Flow execute(Statement const& _statement);
+
+	/// @returns the value of a variable of the innermost function, which has to be local.
+	u256& localVariable(Expression const& _expression);
+	/// Counts one evaluation step and gives up if there were too many.
+	void step();
+
+	/// @returns the result of the operator @a _operator as the code generator applies it to
+	/// values of type @a _type, the shift amount being of type @a _rightType.
+	static u256 applyOperator(Token::Value _operator, Type const& _type, Type const& _rightType, u256 const& _left, u256 const& _right);
+	/// @returns the value that converting @a _value from @a _from to @a _to leaves on the stack.
+	static u256 convert(u256 const& _value, Type const& _from, Type const& _to, bool _cleanup = false);
+	/// @returns true if values of @a _type can be evaluated.
+	static bool supported(Type const& _type);
+
+	/// The context of the expression that is evaluated.
+	CompilerContext* m_context = nullptr;
+	std::vector<Frame> m_frames;
+	size_t m_steps = 0;
+	/// Number of operations the evaluation of the current expression replaced.
+	size_t m_operations = 0;
+	/// Results for expressions outside of functions being evaluated.
+	std::map<Expression const*, boost::optional<u256>> m_values;
+	std::map<IndexAccess const*, boost::optional<u256>> m_slots;
+	std::map<Expression const*, u256> m_folded;
+};
+
+}
+}
@@ -42,6 +42,10 @@ using namespace dev::solidity;
 namespace
 {
 
+/// Maximum stack height at the start of a counted loop over an array, including the slots the
+/// loop keeps on the stack. This leaves room for the expressions in the body.
+unsigned const c_maxStackHeightForArrayLoop = 10;
+
 /**
  * Simple helper class to ensure that the stack height is the same at certain places in the code.
  */
@@ -108,8 +112,41 @@ void ContractCompiler::initializeContext(
 	m_context.setExperimentalFeatures(_contract.sourceUnit().annotation().experimentalFeatures);
 	m_context.setCompiledContracts(_compiledContracts);
 	m_context.setInheritanceHierarchy(_contract.annotation().linearizedBaseContracts);
-	CompilerUtils(m_context).initialiseFreeMemoryPointer();
 	registerStateVariables(_contract);
+	size_t storageCacheSize = 0;
+	if (m_optimise)
+	{
+		m_context.setOptimiseRuns(m_optimiseRuns);
+		for (ContractDefinition const* contract: _contract.annotation().linearizedBaseContracts)
+		{
+			for (FunctionDefinition const* function: contract->definedFunctions())
+			{
+				if (function->isImplemented())
+				{
+					ArrayLoopFinder arrayLoops(function->body(), function->parameters());
+					m_arrayLoops.insert(arrayLoops.loops().begin(), arrayLoops.loops().end());
+					UnrollableLoopFinder unrollableLoops(function->body(), m_context);
+					m_unrollableLoops.insert(unrollableLoops.loops().begin(), unrollableLoops.loops().end());
+				}
+				// Overridden functions are only reached through "super", do not reserve memory for them.
+				if (!function->isConstructor() && &m_context.resolveVirtualFunction(*function) != function)
+					continue;
+				unique_ptr<StorageCache const> cache(new StorageCache(*function, m_context));
+				if (cache->empty())
+					continue;
+				storageCacheSize = max(storageCacheSize, cache->memorySize());
+				m_storageCaches[function] = move(cache);
+			}
+			for (ModifierDefinition const* modifier: contract->functionModifiers())
+			{
+				ArrayLoopFinder arrayLoops(modifier->body(), modifier->parameters());
+				m_arrayLoops.insert(arrayLoops.loops().begin(), arrayLoops.loops().end());
+				UnrollableLoopFinder unrollableLoops(modifier->body(), m_context);
+				m_unrollableLoops.insert(unrollableLoops.loops().begin(), unrollableLoops.loops().end());
+			}
+		}
+	}
+	CompilerUtils(m_context).initialiseFreeMemoryPointer(storageCacheSize);
 	m_context.resetVisitedNodes(&_contract);
 }
 
@@ -244,6 +281,59 @@ void ContractCompiler::appendConstructor(FunctionDefinition const& _constructor)
 	_constructor.accept(*this);
 }
 
+void ContractCompiler::appendInternalSelector(
+	map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+	vector<FixedHash<4>> const& _selectors,
+	eth::AssemblyItem const& _notFound
+)
+{
+	// Selecting from n functions by comparing with each of them takes
+	//   n times: dup1, push4 <selector>, eq, push <tag>, jumpi
+	//   push <notFound>, jump
+	// which costs 22 gas per comparison, i.e. 11 * n on average.
+	// Splitting around a pivot adds
+	//   dup1, push4 <pivot>, gt, push <tag_less>, jumpi
+	// and a second jump to <notFound>, about 17 bytes, but halves the comparisons:
+	//   22 + 11 * n / 2
+	// So we split if
+	//   runs * 11 * n > runs * (22 + 11 * n / 2) + 17 * createDataGas
+	// <=> runs * 11 * (n - 4) > 34 * createDataGas
+	// which never pays off for four or fewer functions. Unoptimised code always compares with
+	// each of them in turn.
+	bool split = false;
+	if (m_optimise && _selectors.size() > 4)
+		split = bigint(m_optimiseRuns) * 11 * (_selectors.size() - 4) > 34 * eth::GasCosts::createDataGas;
+
+	if (!split)
+	{
+		for (auto const& selector: _selectors)
+		{
+			m_context << dupInstruction(1) << u256(FixedHash<4>::Arith(selector)) << Instruction::EQ;
+			m_context.appendConditionalJumpTo(_entryPoints.at(selector));
+		}
+		m_context.appendJumpTo(_notFound);
+		return;
+	}
+
+	size_t pivotIndex = _selectors.size() / 2;
+	FixedHash<4> const& pivot = _selectors[pivotIndex];
+	m_context << dupInstruction(1) << u256(FixedHash<4>::Arith(pivot)) << Instruction::GT;
+	eth::AssemblyItem lessTag = m_context.appendConditionalJump();
+	// stack: <funhash> with <funhash> >= <pivot>
+	appendInternalSelector(
+		_entryPoints,
+		vector<FixedHash<4>>(_selectors.begin() + pivotIndex, _selectors.end()),
+		_notFound
+	);
+	m_context << lessTag;
+	// stack: <funhash> with <funhash> < <pivot>
+	appendInternalSelector(
+		_entryPoints,
+		vector<FixedHash<4>>(_selectors.begin(), _selectors.begin() + pivotIndex),
+		_notFound
+	);
+}
+
 void ContractCompiler::appendFunctionSelector(ContractDefinition const& _contract)
 {
 	map<FixedHash<4>, FunctionTypePointer> interfaceFunctions = _contract.interfaceFunctions();
@@ -261,13 +351,13 @@ void ContractCompiler::appendFunctionSelector(ContractDefinition const& _contrac
 		CompilerUtils(m_context).loadFromMemory(0, IntegerType(CompilerUtils::dataStartOffset * 8), true);
 
 	// stack now is: 1 0 <funhash>
+	vector<FixedHash<4>> selectors;
 	for (auto const& it: interfaceFunctions)
 	{
 		callDataUnpackerEntryPoints.insert(std::make_pair(it.first, m_context.newTag()));
-		m_context << dupInstruction(1) << u256(FixedHash<4>::Arith(it.first)) << Instruction::EQ;
-		m_context.appendConditionalJumpTo(callDataUnpackerEntryPoints.at(it.first));
+		selectors.push_back(it.first);
 	}
-	m_context.appendJumpTo(notFound);
+	appendInternalSelector(callDataUnpackerEntryPoints, selectors, notFound);
 
 	m_context << notFound;
 	if (fallback)
@@ -498,10 +588,23 @@ bool ContractCompiler::visit(FunctionDefinition const& _function)
 	m_currentFunction = &_function;
 	m_modifierDepth = -1;
 
+	auto storageCache = m_storageCaches.find(&_function);
+	if (storageCache != m_storageCaches.end())
+	{
+		storageCache->second->appendLoad(m_context);
+		m_context.setStorageCache(storageCache->second.get());
+	}
+
 	appendModifierOrFunctionCode();
 
 	solAssert(m_returnTags.empty(), "");
 
+	if (storageCache != m_storageCaches.end())
+	{
+		m_context.setStorageCache(nullptr);
+		storageCache->second->appendWriteBack(m_context);
+	}
+
 	// Now we need to re-shuffle the stack. For this we keep a record of the stack layout
 	// that shows the target positions of the elements, where "-1" denotes that this element needs
 	// to be removed from the stack.
@@ -748,6 +851,18 @@ bool ContractCompiler::visit(ForStatement const& _forStatement)
 {
 	StackHeightChecker checker(m_context);
 	CompilerContext::LocationSetter locationSetter(m_context, _forStatement);
+	auto unrollableLoop = m_unrollableLoops.find(&_forStatement);
+	if (unrollableLoop != m_unrollableLoops.end())
+	{
+		m_context.addLoopUnrolling(_forStatement.location(), unrollableLoop->second.iterations, unrollableLoop->second.unroll);
+		if (unrollableLoop->second.unroll)
+		{
+			appendUnrolledLoop(_forStatement, size_t(unrollableLoop->second.iterations));
+			checker.check();
+			return false;
+		}
+	}
+
 	eth::AssemblyItem loopStart = m_context.newTag();
 	eth::AssemblyItem loopEnd = m_context.newTag();
 	eth::AssemblyItem loopNext = m_context.newTag();
@@ -757,12 +872,55 @@ bool ContractCompiler::visit(ForStatement const& _forStatement)
 	if (_forStatement.initializationExpression())
 		_forStatement.initializationExpression()->accept(*this);
 
+	// Counted loops over an array keep the length of the array and the address of the current
+	// element on the stack, if there is room for them, and skip the bounds checks in the body.
+	auto arrayLoop = m_arrayLoops.find(&_forStatement);
+	bool hoistLength = false;
+	bool elementAddress = false;
+	if (arrayLoop != m_arrayLoops.end())
+	{
+		ArrayType const& arrayType = dynamic_cast<ArrayType const&>(*arrayLoop->second.array->annotation().type);
+		bool wantsLength =
+			arrayLoop->second.lengthInCondition &&
+			arrayType.location() == DataLocation::Memory &&
+			arrayType.isDynamicallySized();
+		bool wantsElementAddress = !arrayLoop->second.accesses.empty();
+		if (m_context.stackHeight() + unsigned(wantsLength) + unsigned(wantsElementAddress) <= c_maxStackHeightForArrayLoop)
+		{
+			hoistLength = wantsLength;
+			elementAddress = wantsElementAddress;
+		}
+	}
+	unsigned const hoistedSlots = unsigned(hoistLength) + unsigned(elementAddress);
+	if (hoistLength)
+		compileExpression(dynamic_cast<BinaryOperation const&>(*_forStatement.condition()).rightExpression());
+	if (elementAddress)
+		appendArrayLoopElementAddress(arrayLoop->second);
+	if (arrayLoop != m_arrayLoops.end())
+	{
+		for (IndexAccess const* access: arrayLoop->second.accesses)
+			m_context.addInRangeIndexAccess(
+				*access,
+				elementAddress ? boost::make_optional(m_context.currentToBaseStackOffset(0)) : boost::none
+			);
+		for (IndexAccess const* access: arrayLoop->second.otherAccesses)
+			m_context.addInRangeIndexAccess(*access, boost::none);
+	}
+	m_stackCleanupForReturn += hoistedSlots;
+
 	m_context << loopStart;
 
 	// if there is no terminating condition in for, default is to always be true
 	if (_forStatement.condition())
 	{
-		compileExpression(*_forStatement.condition());
+		if (hoistLength)
+		{
+			// stack: <length> [<element_address>] <counter>
+			compileExpression(dynamic_cast<BinaryOperation const&>(*_forStatement.condition()).leftExpression());
+			m_context << dupInstruction(hoistedSlots + 1) << Instruction::GT;
+		}
+		else
+			compileExpression(*_forStatement.condition());
 		m_context << Instruction::ISZERO;
 		m_context.appendConditionalJumpTo(loopEnd);
 	}
@@ -774,10 +932,18 @@ bool ContractCompiler::visit(ForStatement const& _forStatement)
 	// for's loop expression if existing
 	if (_forStatement.loopExpression())
 		_forStatement.loopExpression()->accept(*this);
+	if (elementAddress)
+		m_context << arrayLoopElementStride(arrayLoop->second) << Instruction::ADD;
 
 	m_context.appendJumpTo(loopStart);
 	m_context << loopEnd;
 
+	CompilerUtils(m_context).popStackSlots(hoistedSlots);
+	m_stackCleanupForReturn -= hoistedSlots;
+	if (arrayLoop != m_arrayLoops.end())
+		for (IndexAccess const* access: arrayLoop->second.accesses + arrayLoop->second.otherAccesses)
+			m_context.removeInRangeIndexAccess(*access);
+
 	m_continueTags.pop_back();
 	m_breakTags.pop_back();
 
@@ -785,6 +951,69 @@ bool ContractCompiler::visit(ForStatement const& _forStatement)
 	return false;
 }
 
+void ContractCompiler::appendUnrolledLoop(ForStatement const& _forStatement, size_t _iterations)
+{
+	eth::AssemblyItem loopEnd = m_context.newTag();
+	m_breakTags.push_back(loopEnd);
+
+	_forStatement.initializationExpression()->accept(*this);
+
+	// The counter stays within the bounds of the array, so the accesses need no bounds checks.
+	auto arrayLoop = m_arrayLoops.find(&_forStatement);
+	if (arrayLoop != m_arrayLoops.end())
+		for (IndexAccess const* access: arrayLoop->second.accesses + arrayLoop->second.otherAccesses)
+			m_context.addInRangeIndexAccess(*access, boost::none);
+
+	for (size_t i = 0; i < _iterations; ++i)
+	{
+		eth::AssemblyItem loopNext = m_context.newTag();
+		m_continueTags.push_back(loopNext);
+		_forStatement.body().accept(*this);
+		m_continueTags.pop_back();
+		m_context << loopNext;
+		_forStatement.loopExpression()->accept(*this);
+	}
+	m_context << loopEnd;
+
+	if (arrayLoop != m_arrayLoops.end())
+		for (IndexAccess const* access: arrayLoop->second.accesses + arrayLoop->second.otherAccesses)
+			m_context.removeInRangeIndexAccess(*access);
+	m_breakTags.pop_back();
+}
+
+void ContractCompiler::appendArrayLoopElementAddress(ArrayLoop const& _loop)
+{
+	ArrayType const& arrayType = dynamic_cast<ArrayType const&>(*_loop.array->annotation().type);
+	// Same computation as in ArrayUtils::accessIndex.
+	CompilerUtils(m_context).copyToStackTop(
+		m_context.baseToCurrentStackOffset(m_context.baseStackOffsetOfVariable(*_loop.array)) + 1,
+		arrayType.sizeOnStack()
+	);
+	if (arrayType.location() == DataLocation::CallData && arrayType.isDynamicallySized())
+		// remove length
+		m_context << Instruction::POP;
+	if (arrayType.location() == DataLocation::Memory && arrayType.isDynamicallySized())
+		m_context << u256(32) << Instruction::ADD;
+	CompilerUtils(m_context).copyToStackTop(
+		m_context.baseToCurrentStackOffset(m_context.baseStackOffsetOfVariable(*_loop.counter)) + 1,
+		1
+	);
+	u256 stride = arrayLoopElementStride(_loop);
+	if (stride != 1)
+		m_context << stride << Instruction::MUL;
+	m_context << Instruction::ADD;
+}
+
+u256 ContractCompiler::arrayLoopElementStride(ArrayLoop const& _loop)
+{
+	ArrayType const& arrayType = dynamic_cast<ArrayType const&>(*_loop.array->annotation().type);
+	if (arrayType.isByteArray())
+		return 1;
+	if (arrayType.location() == DataLocation::CallData)
+		return arrayType.baseType()->calldataEncodedSize();
+	return arrayType.memoryHeadSize();
+}
+
 bool ContractCompiler::visit(Continue const& _continueStatement)
 {
 	CompilerContext::LocationSetter locationSetter(m_context, _continueStatement);
@@ -900,9 +1129,10 @@ void ContractCompiler::appendMissingFunctions()
 		solAssert(m_context.nextFunctionToCompile() != function, "Compiled the wrong function?");
 	}
 	m_context.appendMissingLowLevelFunctions();
-	string abiFunctions = m_context.abiFunctions().requestedFunctions();
+	shared_ptr<assembly::Block> abiFunctionsCode;
+	string abiFunctions = m_context.abiFunctions().requestedFunctions(&abiFunctionsCode);
 	if (!abiFunctions.empty())
-		m_context.appendInlineAssembly("{" + move(abiFunctions) + "}", {}, true);
+		m_context.appendInlineAssembly("{" + move(abiFunctions) + "}", {}, true, move(abiFunctionsCode));
 }
 
 void ContractCompiler::appendModifierOrFunctionCode()
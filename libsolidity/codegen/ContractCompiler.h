@@ -26,6 +26,9 @@
 #include <functional>
 #include <libsolidity/ast/ASTVisitor.h>
 #include <libsolidity/codegen/CompilerContext.h>
+#include <libsolidity/codegen/StorageCache.h>
+#include <libsolidity/codegen/ArrayLoop.h>
+#include <libsolidity/codegen/UnrollableLoop.h>
 #include <libevmasm/Assembly.h>
 
 namespace dev {
@@ -38,12 +41,22 @@ namespace solidity {
 class ContractCompiler: private ASTConstVisitor
 {
 public:
-	explicit ContractCompiler(ContractCompiler* _runtimeCompiler, CompilerContext& _context, bool _optimise):
+	explicit ContractCompiler(
+		ContractCompiler* _runtimeCompiler,
+		CompilerContext& _context,
+		bool _optimise,
+		size_t _optimiseRuns = 200
+	):
 		m_optimise(_optimise),
+		m_optimiseRuns(_optimiseRuns),
 		m_runtimeCompiler(_runtimeCompiler),
 		m_context(_context)
 	{
-		m_context = CompilerContext(_runtimeCompiler ? &_runtimeCompiler->m_context : nullptr);
+		m_context = CompilerContext(
+			_runtimeCompiler ? &_runtimeCompiler->m_context : nullptr,
+			m_context.inlineAssemblyCache(),
+			m_context.abiFunctions().routineStore()
+		);
 	}
 
 	void compileContract(
@@ -80,6 +93,15 @@ private:
 	void appendBaseConstructor(FunctionDefinition const& _constructor);
 	void appendConstructor(FunctionDefinition const& _constructor);
 	void appendFunctionSelector(ContractDefinition const& _contract);
+	/// Appends code that jumps to the entry point of the function whose selector is on the
+	/// stack if it is one of the (sorted) @a _selectors and to @a _notFound otherwise.
+	/// If optimising, splits the selectors around a pivot if a binary search is cheaper for the
+	/// expected number of runs than comparing with each of them in turn.
+	void appendInternalSelector(
+		std::map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+		std::vector<FixedHash<4>> const& _selectors,
+		eth::AssemblyItem const& _notFound
+	);
 	void appendCallValueCheck();
 	/// Creates code that unpacks the arguments for the given function represented by a vector of TypePointers.
 	/// From memory if @a _fromMemory is true, otherwise from call data.
@@ -112,12 +134,22 @@ private:
 	void appendModifierOrFunctionCode();
 
 	void appendStackVariableInitialisation(VariableDeclaration const& _variable);
+	/// Appends code that computes the address of the element of the array @a _loop runs over
+	/// at the current value of the counter.
+	void appendArrayLoopElementAddress(ArrayLoop const& _loop);
+	/// @returns the distance between the elements of the array @a _loop runs over.
+	static u256 arrayLoopElementStride(ArrayLoop const& _loop);
+	/// Appends the code of a ``for`` loop with @a _iterations iterations by repeating its body and
+	/// loop expression without checking the condition.
+	void appendUnrolledLoop(ForStatement const& _forStatement, size_t _iterations);
 	void compileExpression(Expression const& _expression, TypePointer const& _targetType = TypePointer());
 
 	/// @returns the runtime assembly for clone contracts.
 	static eth::AssemblyPointer cloneRuntime();
 
 	bool const m_optimise;
+	/// Expected number of executions per deployment, used to weigh code size against runtime gas.
+	size_t const m_optimiseRuns;
 	/// Pointer to the runtime compiler in case this is a creation compiler.
 	ContractCompiler* m_runtimeCompiler = nullptr;
 	CompilerContext& m_context;
@@ -130,6 +162,12 @@ private:
 	unsigned m_stackCleanupForReturn = 0; ///< this number of stack elements need to be removed before jump to m_returnTag
 	// arguments for base constructors, filled in derived-to-base order
 	std::map<FunctionDefinition const*, std::vector<ASTPointer<Expression>> const*> m_baseArguments;
+	/// Storage slots the functions keep in memory, only filled if optimising.
+	std::map<FunctionDefinition const*, std::unique_ptr<StorageCache const>> m_storageCaches;
+	/// Counted loops over arrays in the functions and modifiers, only filled if optimising.
+	std::map<ForStatement const*, ArrayLoop> m_arrayLoops;
+	/// Loops with a known number of iterations in the functions and modifiers, only filled if optimising.
+	std::map<ForStatement const*, UnrollableLoop> m_unrollableLoops;
 };
 
 }
@@ -27,10 +27,12 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/SHA3.h>
 #include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/TypeProvider.h>
 #include <libsolidity/codegen/ExpressionCompiler.h>
 #include <libsolidity/codegen/CompilerContext.h>
 #include <libsolidity/codegen/CompilerUtils.h>
 #include <libsolidity/codegen/LValue.h>
+#include <libsolidity/codegen/StorageCache.h>
 #include <libevmasm/GasMeter.h>
 
 using namespace std;
@@ -187,6 +189,8 @@ void ExpressionCompiler::appendStateVariableAccessor(VariableDeclaration const&
 bool ExpressionCompiler::visit(Conditional const& _condition)
 {
 	CompilerContext::LocationSetter locationSetter(m_context, _condition);
+	if (appendConstantValue(_condition))
+		return false;
 	_condition.condition().accept(*this);
 	eth::AssemblyItem trueTag = m_context.appendConditionalJump();
 	_condition.falseExpression().accept(*this);
@@ -328,6 +332,8 @@ bool ExpressionCompiler::visit(UnaryOperation const& _unaryOperation)
 		m_context << _unaryOperation.annotation().type->literalValue(nullptr);
 		return false;
 	}
+	if (appendConstantValue(_unaryOperation))
+		return false;
 
 	_unaryOperation.subExpression().accept(*this);
 
@@ -392,10 +398,12 @@ bool ExpressionCompiler::visit(BinaryOperation const& _binaryOperation)
 	TypePointer const& commonType = _binaryOperation.annotation().commonType;
 	Token::Value const c_op = _binaryOperation.getOperator();
 
-	if (c_op == Token::And || c_op == Token::Or) // special case: short-circuiting
-		appendAndOrOperatorCode(_binaryOperation);
-	else if (commonType->category() == Type::Category::RationalNumber)
+	if (commonType->category() == Type::Category::RationalNumber)
 		m_context << commonType->literalValue(nullptr);
+	else if (appendConstantValue(_binaryOperation))
+		return false;
+	else if (c_op == Token::And || c_op == Token::Or) // special case: short-circuiting
+		appendAndOrOperatorCode(_binaryOperation);
 	else
 	{
 		bool cleanupNeeded = cleanupNeededForOp(commonType->category(), c_op);
@@ -440,6 +448,8 @@ bool ExpressionCompiler::visit(BinaryOperation const& _binaryOperation)
 bool ExpressionCompiler::visit(FunctionCall const& _functionCall)
 {
 	CompilerContext::LocationSetter locationSetter(m_context, _functionCall);
+	if (appendConstantValue(_functionCall))
+		return false;
 	if (_functionCall.annotation().kind == FunctionCallKind::TypeConversion)
 	{
 		solAssert(_functionCall.arguments().size() == 1, "");
@@ -797,10 +807,10 @@ bool ExpressionCompiler::visit(FunctionCall const& _functionCall)
 			solAssert(function.parameterTypes().size() == 1, "");
 			solAssert(!!function.parameterTypes()[0], "");
 			TypePointer paramType = function.parameterTypes()[0];
-			shared_ptr<ArrayType> arrayType =
+			shared_ptr<ArrayType const> arrayType =
 				function.kind() == FunctionType::Kind::ArrayPush ?
-				make_shared<ArrayType>(DataLocation::Storage, paramType) :
-				make_shared<ArrayType>(DataLocation::Storage);
+				TypeProvider::array(DataLocation::Storage, paramType) :
+				TypeProvider::byteArray(DataLocation::Storage);
 			// get the current length
 			ArrayUtils(m_context).retrieveLength(*arrayType);
 			m_context << Instruction::DUP1;
@@ -947,6 +957,19 @@ bool ExpressionCompiler::visit(MemberAccess const& _memberAccess)
 			return false;
 		}
 
+	// Members of struct state variables in storage slots the function keeps in memory.
+	pair<u256, unsigned> location;
+	if (
+		m_context.storageCache() &&
+		_memberAccess.expression().annotation().type->category() == Type::Category::Struct &&
+		StorageCache::directStorageLocation(_memberAccess, m_context, location) &&
+		m_context.storageCache()->contains(location.first)
+	)
+	{
+		setLValue<CachedStorageItem>(_memberAccess, *_memberAccess.annotation().type, location);
+		return false;
+	}
+
 	// Special processing for TypeType because we do not want to visit the library itself
 	// for internal functions, or enum/struct definitions.
 	if (TypeType const* type = dynamic_cast<TypeType const*>(_memberAccess.expression().annotation().type.get()))
@@ -1202,9 +1225,23 @@ bool ExpressionCompiler::visit(MemberAccess const& _memberAccess)
 bool ExpressionCompiler::visit(IndexAccess const& _indexAccess)
 {
 	CompilerContext::LocationSetter locationSetter(m_context, _indexAccess);
-	_indexAccess.baseExpression().accept(*this);
-
 	Type const& baseType = *_indexAccess.baseExpression().annotation().type;
+	// Elements of mappings in state variables with constant keys have a slot known at compile time.
+	if (m_optimize && baseType.category() == Type::Category::Mapping)
+		if (boost::optional<u256> slot = m_context.constantFolder().mappingSlot(_indexAccess, m_context))
+		{
+			m_context << *slot << u256(0);
+			setLValueToStorageItem(_indexAccess);
+			return false;
+		}
+
+	// Accesses in counted loops over arrays are always in range, and the loop can keep the
+	// address of the element on the stack.
+	auto inRange = m_context.inRangeIndexAccesses().find(&_indexAccess);
+	bool const inRangeAccess = inRange != m_context.inRangeIndexAccesses().end();
+	unsigned const* elementAddress = inRangeAccess ? inRange->second.get_ptr() : nullptr;
+	if (!elementAddress)
+		_indexAccess.baseExpression().accept(*this);
 
 	if (baseType.category() == Type::Category::Mapping)
 	{
@@ -1243,10 +1280,24 @@ bool ExpressionCompiler::visit(IndexAccess const& _indexAccess)
 		ArrayType const& arrayType = dynamic_cast<ArrayType const&>(baseType);
 		solAssert(_indexAccess.indexExpression(), "Index expression expected.");
 
-		_indexAccess.indexExpression()->accept(*this);
-		utils().convertType(*_indexAccess.indexExpression()->annotation().type, IntegerType(256), true);
-		// stack layout: <base_ref> [<length>] <index>
-		ArrayUtils(m_context).accessIndex(arrayType);
+		if (elementAddress)
+		{
+			unsigned stackPos = m_context.baseToCurrentStackOffset(*elementAddress);
+			if (stackPos >= 16)
+				BOOST_THROW_EXCEPTION(
+					CompilerError() <<
+					errinfo_sourceLocation(_indexAccess.location()) <<
+					errinfo_comment("Stack too deep, try removing local variables.")
+				);
+			m_context << dupInstruction(stackPos + 1);
+		}
+		else
+		{
+			_indexAccess.indexExpression()->accept(*this);
+			utils().convertType(*_indexAccess.indexExpression()->annotation().type, IntegerType(256), true);
+			// stack layout: <base_ref> [<length>] <index>
+			ArrayUtils(m_context).accessIndex(arrayType, !inRangeAccess);
+		}
 		switch (arrayType.location())
 		{
 		case DataLocation::Storage:
@@ -1803,6 +1854,17 @@ void ExpressionCompiler::appendExpressionCopyToMemory(Type const& _expectedType,
 	utils().storeInMemoryDynamic(_expectedType);
 }
 
+bool ExpressionCompiler::appendConstantValue(Expression const& _expression)
+{
+	if (!m_optimize)
+		return false;
+	boost::optional<u256> value = m_context.constantFolder().value(_expression, m_context);
+	if (!value)
+		return false;
+	m_context << *value;
+	return true;
+}
+
 void ExpressionCompiler::appendVariable(VariableDeclaration const& _variable, Expression const& _expression)
 {
 	if (!_variable.isConstant())
@@ -1819,7 +1881,17 @@ void ExpressionCompiler::setLValueFromDeclaration(Declaration const& _declaratio
 	if (m_context.isLocalVariable(&_declaration))
 		setLValue<StackVariable>(_expression, dynamic_cast<VariableDeclaration const&>(_declaration));
 	else if (m_context.isStateVariable(&_declaration))
-		setLValue<StorageItem>(_expression, dynamic_cast<VariableDeclaration const&>(_declaration));
+	{
+		pair<u256, unsigned> location;
+		if (
+			m_context.storageCache() &&
+			StorageCache::directStorageLocation(_expression, m_context, location) &&
+			m_context.storageCache()->contains(location.first)
+		)
+			setLValue<CachedStorageItem>(_expression, *_expression.annotation().type, location);
+		else
+			setLValue<StorageItem>(_expression, dynamic_cast<VariableDeclaration const&>(_declaration));
+	}
 	else
 		BOOST_THROW_EXCEPTION(InternalCompilerError()
 			<< errinfo_sourceLocation(_expression.location())
@@ -70,6 +70,10 @@ public:
 	/// Appends code for a Constant State Variable accessor function
 	void appendConstStateVariableAccessor(const VariableDeclaration& _varDecl);
 
+	/// @returns true if the operator applied to the given type requires a cleanup prior to the
+	/// operation.
+	static bool cleanupNeededForOp(Type::Category _type, Token::Value _op);
+
 private:
 	virtual bool visit(Conditional const& _condition) override;
 	virtual bool visit(Assignment const& _assignment) override;
@@ -103,6 +107,10 @@ private:
 	/// expected to be on the stack and is updated by this call.
 	void appendExpressionCopyToMemory(Type const& _expectedType, Expression const& _expression);
 
+	/// Pushes the value of @a _expression if optimising and it can be computed at compile time.
+	/// @returns true if it did so.
+	bool appendConstantValue(Expression const& _expression);
+
 	/// Appends code for a variable that might be a constant or not
 	void appendVariable(VariableDeclaration const& _variable, Expression const& _expression);
 	/// Sets the current LValue to a new one (of the appropriate type) from the given declaration.
@@ -117,10 +125,6 @@ private:
 	template <class _LValueType, class... _Arguments>
 	void setLValue(Expression const& _expression, _Arguments const&... _arguments);
 
-	/// @returns true if the operator applied to the given type requires a cleanup prior to the
-	/// operation.
-	static bool cleanupNeededForOp(Type::Category _type, Token::Value _op);
-
 	/// @returns the CompilerUtils object containing the current context.
 	CompilerUtils utils();
 
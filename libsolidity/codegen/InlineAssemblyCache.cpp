@@ -0,0 +1,55 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Cache of the parsed and analyzed inline assembly routines generated by the compiler.
+ */
+
+#include <libsolidity/codegen/InlineAssemblyCache.h>
+
+#include <libsolidity/inlineasm/AsmData.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+shared_ptr<InlineAssemblyCache::Routine const> InlineAssemblyCache::find(
+	string const& _source,
+	vector<string> const& _externalIdentifiers
+)
+{
+	auto withSource = m_routines.find(_source);
+	if (withSource == m_routines.end())
+		return nullptr;
+	auto it = withSource->second.find(_externalIdentifiers);
+	if (it == withSource->second.end())
+		return nullptr;
+	m_reuses++;
+	m_charactersReused += _source.size();
+	return it->second;
+}
+
+void InlineAssemblyCache::add(
+	string const& _source,
+	vector<string> const& _externalIdentifiers,
+	shared_ptr<Routine const> _routine
+)
+{
+	auto& routine = m_routines[_source][_externalIdentifiers];
+	if (!routine)
+		m_routineCount++;
+	routine = move(_routine);
+}
@@ -0,0 +1,83 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Cache of the parsed and analyzed inline assembly routines generated by the compiler.
+ */
+
+#pragma once
+
+#include <libsolidity/inlineasm/AsmAnalysisInfo.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Keeps the inline assembly routines the code generator produces (ABI coders, memory copy
+ * loops, ...) in parsed and analyzed form, so that routines that are appended for several
+ * contracts or for both creation and runtime code are only scanned, parsed and analyzed once
+ * per compilation. Code is still generated for each use, since it depends on the stack layout
+ * around the routine.
+ */
+class InlineAssemblyCache: private boost::noncopyable
+{
+public:
+	struct Routine
+	{
+		std::shared_ptr<assembly::Block> code;
+		assembly::AsmAnalysisInfo analysisInfo;
+	};
+
+	/// @returns the routine with the given source text that refers to the given external
+	/// identifiers, or nullptr if it has not been added yet.
+	std::shared_ptr<Routine const> find(
+		std::string const& _source,
+		std::vector<std::string> const& _externalIdentifiers
+	);
+	/// Adds the parsed and analyzed form of a routine.
+	void add(
+		std::string const& _source,
+		std::vector<std::string> const& _externalIdentifiers,
+		std::shared_ptr<Routine const> _routine
+	);
+
+	/// @returns the number of routines that were parsed and analyzed.
+	size_t routines() const { return m_routineCount; }
+	/// @returns the number of uses of a routine that did not have to parse it.
+	size_t reuses() const { return m_reuses; }
+	/// @returns the number of characters that did not have to be parsed.
+	size_t charactersReused() const { return m_charactersReused; }
+
+private:
+	/// Routines by source text and external identifiers. The analysis depends on which
+	/// identifiers refer to the surrounding code, so they are part of the key.
+	std::map<std::string, std::map<std::vector<std::string>, std::shared_ptr<Routine const>>> m_routines;
+	size_t m_routineCount = 0;
+	size_t m_reuses = 0;
+	size_t m_charactersReused = 0;
+};
+
+}
+}
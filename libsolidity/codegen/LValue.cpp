@@ -25,6 +25,7 @@
 #include <libsolidity/ast/Types.h>
 #include <libsolidity/ast/AST.h>
 #include <libsolidity/codegen/CompilerUtils.h>
+#include <libsolidity/codegen/StorageCache.h>
 
 using namespace std;
 using namespace dev;
@@ -149,7 +150,13 @@ StorageItem::StorageItem(CompilerContext& _compilerContext, VariableDeclaration
 }
 
 StorageItem::StorageItem(CompilerContext& _compilerContext, Type const& _type):
-	LValue(_compilerContext, &_type)
+	StorageItem(_compilerContext, _type, false)
+{
+}
+
+StorageItem::StorageItem(CompilerContext& _compilerContext, Type const& _type, bool _inMemory):
+	LValue(_compilerContext, &_type),
+	m_inMemory(_inMemory)
 {
 	if (m_dataType->isValueType())
 	{
@@ -157,10 +164,13 @@ StorageItem::StorageItem(CompilerContext& _compilerContext, Type const& _type):
 			solAssert(m_dataType->storageSize() == m_dataType->sizeOnStack(), "");
 		solAssert(m_dataType->storageSize() == 1, "Invalid storage size.");
 	}
+	else
+		solAssert(!m_inMemory, "Only value types can be kept in memory.");
 }
 
 void StorageItem::retrieveValue(SourceLocation const&, bool _remove) const
 {
+	Instruction const loadInstruction = m_inMemory ? Instruction::MLOAD : Instruction::SLOAD;
 	// stack: storage_key storage_offset
 	if (!m_dataType->isValueType())
 	{
@@ -174,12 +184,12 @@ void StorageItem::retrieveValue(SourceLocation const&, bool _remove) const
 	if (!_remove)
 		CompilerUtils(m_context).copyToStackTop(sizeOnStack(), sizeOnStack());
 	if (m_dataType->storageBytes() == 32)
-		m_context << Instruction::POP << Instruction::SLOAD;
+		m_context << Instruction::POP << loadInstruction;
 	else
 	{
 		bool cleaned = false;
 		m_context
-			<< Instruction::SWAP1 << Instruction::SLOAD << Instruction::SWAP1
+			<< Instruction::SWAP1 << loadInstruction << Instruction::SWAP1
 			<< u256(0x100) << Instruction::EXP << Instruction::SWAP1 << Instruction::DIV;
 		if (m_dataType->category() == Type::Category::FixedPoint)
 			// implementation should be very similar to the integer case.
@@ -215,6 +225,8 @@ void StorageItem::retrieveValue(SourceLocation const&, bool _remove) const
 
 void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _location, bool _move) const
 {
+	Instruction const loadInstruction = m_inMemory ? Instruction::MLOAD : Instruction::SLOAD;
+	Instruction const storeInstruction = m_inMemory ? Instruction::MSTORE : Instruction::SSTORE;
 	CompilerUtils utils(m_context);
 	solAssert(m_dataType, "");
 
@@ -235,7 +247,7 @@ void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _loc
 			utils.convertType(_sourceType, *m_dataType, true);
 			m_context << Instruction::SWAP1;
 
-			m_context << Instruction::SSTORE;
+			m_context << storeInstruction;
 		}
 		else
 		{
@@ -243,7 +255,7 @@ void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _loc
 			m_context << u256(0x100) << Instruction::EXP;
 			// stack: value storage_ref multiplier
 			// fetch old value
-			m_context << Instruction::DUP2 << Instruction::SLOAD;
+			m_context << Instruction::DUP2 << loadInstruction;
 			// stack: value storege_ref multiplier old_full_value
 			// clear bytes in old value
 			m_context
@@ -277,7 +289,7 @@ void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _loc
 			}
 			m_context  << Instruction::MUL << Instruction::OR;
 			// stack: value storage_ref updated_value
-			m_context << Instruction::SWAP1 << Instruction::SSTORE;
+			m_context << Instruction::SWAP1 << storeInstruction;
 			if (_move)
 				utils.popStackElement(*m_dataType);
 		}
@@ -360,6 +372,8 @@ void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _loc
 
 void StorageItem::setToZero(SourceLocation const&, bool _removeReference) const
 {
+	Instruction const loadInstruction = m_inMemory ? Instruction::MLOAD : Instruction::SLOAD;
+	Instruction const storeInstruction = m_inMemory ? Instruction::MSTORE : Instruction::SSTORE;
 	if (m_dataType->category() == Type::Category::Array)
 	{
 		if (!_removeReference)
@@ -397,14 +411,14 @@ void StorageItem::setToZero(SourceLocation const&, bool _removeReference) const
 			// offset should be zero
 			m_context
 				<< Instruction::POP << u256(0)
-				<< Instruction::SWAP1 << Instruction::SSTORE;
+				<< Instruction::SWAP1 << storeInstruction;
 		}
 		else
 		{
 			m_context << u256(0x100) << Instruction::EXP;
 			// stack: storage_ref multiplier
 			// fetch old value
-			m_context << Instruction::DUP2 << Instruction::SLOAD;
+			m_context << Instruction::DUP2 << loadInstruction;
 			// stack: storege_ref multiplier old_full_value
 			// clear bytes in old value
 			m_context
@@ -412,11 +426,22 @@ void StorageItem::setToZero(SourceLocation const&, bool _removeReference) const
 				<< Instruction::MUL;
 			m_context << Instruction::NOT << Instruction::AND;
 			// stack: storage_ref cleared_value
-			m_context << Instruction::SWAP1 << Instruction::SSTORE;
+			m_context << Instruction::SWAP1 << storeInstruction;
 		}
 	}
 }
 
+CachedStorageItem::CachedStorageItem(
+	CompilerContext& _compilerContext,
+	Type const& _type,
+	pair<u256, unsigned> const& _location
+):
+	StorageItem(_compilerContext, _type, true)
+{
+	solAssert(m_context.storageCache(), "");
+	m_context << m_context.storageCache()->address(_location.first) << u256(_location.second);
+}
+
 /// Used in StorageByteArrayElement
 static FixedBytesType byteType(1);
 
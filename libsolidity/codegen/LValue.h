@@ -146,6 +146,32 @@ public:
 		SourceLocation const& _location = SourceLocation(),
 		bool _removeReference = true
 	) const override;
+
+protected:
+	/// Constructs the LValue for a value-type variable whose slot is kept in memory if
+	/// @a _inMemory is true.
+	StorageItem(CompilerContext& _compilerContext, Type const& _type, bool _inMemory);
+
+private:
+	/// If true, the storage key on the stack is the memory address of a copy of the slot.
+	bool m_inMemory = false;
+};
+
+/**
+ * Reference to a value-type variable in a storage slot that the function that is compiled keeps
+ * in memory (@see StorageCache). On the stack this is <memory address of the copy of the slot>
+ * <offset_inside_value>, the value is stored inside the slot as with StorageItem.
+ */
+class CachedStorageItem: public StorageItem
+{
+public:
+	/// Constructs the LValue and pushes the location of the copy of the slot, where @a _location
+	/// is the storage slot and byte offset of the variable.
+	CachedStorageItem(
+		CompilerContext& _compilerContext,
+		Type const& _type,
+		std::pair<u256, unsigned> const& _location
+	);
 };
 
 /**
@@ -0,0 +1,320 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Copies of storage slots that a function keeps in memory while it runs.
+ */
+
+#include <libsolidity/codegen/StorageCache.h>
+
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/codegen/CompilerContext.h>
+#include <libsolidity/codegen/CompilerUtils.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+u256 const StorageCache::memoryStart = CompilerUtils::freeMemoryPointer + 32;
+
+StorageCache::StorageCache(FunctionDefinition const& _function, CompilerContext const& _context):
+	m_context(_context)
+{
+	// Constructors run only once and call the base constructors.
+	if (_function.isConstructor() || !_function.isImplemented())
+		return;
+	for (ASTPointer<VariableDeclaration> const& parameter: _function.parameters())
+		recordDeclaration(*parameter);
+	for (ASTPointer<VariableDeclaration> const& parameter: _function.returnParameters())
+		recordDeclaration(*parameter);
+	for (ASTPointer<ModifierInvocation> const& invocation: _function.modifiers())
+	{
+		for (ASTPointer<Expression> const& argument: invocation->arguments())
+			argument->accept(*this);
+		ModifierDefinition const& modifier = m_context.functionModifier(invocation->name()->name());
+		for (ASTPointer<VariableDeclaration> const& parameter: modifier.parameters())
+			recordDeclaration(*parameter);
+		modifier.body().accept(*this);
+	}
+	_function.body().accept(*this);
+	if (!m_cacheable)
+		return;
+
+	for (VariableDeclaration const* variable: m_usedAsWhole)
+	{
+		u256 slot = m_context.storageLocationOfVariable(*variable).first;
+		m_usage.erase(
+			m_usage.lower_bound(slot),
+			m_usage.lower_bound(slot + variable->annotation().type->storageSize())
+		);
+	}
+	for (auto const& usage: m_usage)
+		if (usage.second.accessedInLoop || usage.second.accessedInSeveralSegments)
+		{
+			m_slots[usage.first] = m_cachedSlots.size();
+			m_cachedSlots.push_back(CachedSlot{usage.first, usage.second.written});
+		}
+}
+
+u256 StorageCache::address(u256 const& _slot) const
+{
+	solAssert(contains(_slot), "Storage slot not cached.");
+	return memoryStart + 32 * m_slots.at(_slot);
+}
+
+size_t StorageCache::memorySize() const
+{
+	size_t words = m_cachedSlots.size();
+	for (CachedSlot const& cached: m_cachedSlots)
+		if (cached.written)
+			words++;
+	return 32 * words;
+}
+
+void StorageCache::appendLoad(CompilerContext& _context) const
+{
+	u256 original = memoryStart + 32 * m_cachedSlots.size();
+	for (CachedSlot const& cached: m_cachedSlots)
+	{
+		_context << cached.slot << Instruction::SLOAD;
+		if (cached.written)
+		{
+			_context << Instruction::DUP1 << original << Instruction::MSTORE;
+			original += 32;
+		}
+		_context << address(cached.slot) << Instruction::MSTORE;
+	}
+}
+
+void StorageCache::appendWriteBack(CompilerContext& _context) const
+{
+	u256 original = memoryStart + 32 * m_cachedSlots.size();
+	for (CachedSlot const& cached: m_cachedSlots)
+		if (cached.written)
+		{
+			_context << address(cached.slot) << Instruction::MLOAD;
+			_context << Instruction::DUP1 << original << Instruction::MLOAD << Instruction::EQ;
+			eth::AssemblyItem unchanged = _context.appendConditionalJump();
+			_context << Instruction::DUP1 << cached.slot << Instruction::SSTORE;
+			_context << unchanged << Instruction::POP;
+			original += 32;
+		}
+}
+
+bool StorageCache::directStorageLocation(
+	Expression const& _expression,
+	CompilerContext const& _context,
+	pair<u256, unsigned>& _location
+)
+{
+	if (!_expression.annotation().type || !_expression.annotation().type->isValueType())
+		return false;
+	Declaration const* declaration = nullptr;
+	if (auto identifier = dynamic_cast<Identifier const*>(&_expression))
+		declaration = identifier->annotation().referencedDeclaration;
+	else if (auto memberAccess = dynamic_cast<MemberAccess const*>(&_expression))
+	{
+		Expression const& base = memberAccess->expression();
+		if (dynamic_cast<TypeType const*>(base.annotation().type.get()))
+			declaration = memberAccess->annotation().referencedDeclaration;
+		else if (auto structType = dynamic_cast<StructType const*>(base.annotation().type.get()))
+		{
+			auto identifier = dynamic_cast<Identifier const*>(&base);
+			if (
+				!identifier ||
+				structType->location() != DataLocation::Storage ||
+				!dynamic_cast<VariableDeclaration const*>(memberAccess->annotation().referencedDeclaration)
+			)
+				return false;
+			auto variable = dynamic_cast<VariableDeclaration const*>(identifier->annotation().referencedDeclaration);
+			if (!variable || !_context.isStateVariable(variable))
+				return false;
+			pair<u256, unsigned> const& offsets = structType->storageOffsetsOfMember(memberAccess->memberName());
+			_location = make_pair(_context.storageLocationOfVariable(*variable).first + offsets.first, offsets.second);
+			return true;
+		}
+	}
+	auto variable = dynamic_cast<VariableDeclaration const*>(declaration);
+	if (!variable || variable->isConstant() || !_context.isStateVariable(variable))
+		return false;
+	_location = _context.storageLocationOfVariable(*variable);
+	return true;
+}
+
+bool StorageCache::visit(IfStatement const& _ifStatement)
+{
+	_ifStatement.condition().accept(*this);
+	m_segment++;
+	_ifStatement.trueStatement().accept(*this);
+	m_segment++;
+	if (_ifStatement.falseStatement())
+	{
+		_ifStatement.falseStatement()->accept(*this);
+		m_segment++;
+	}
+	return false;
+}
+
+bool StorageCache::visit(WhileStatement const& _whileStatement)
+{
+	m_loopDepth++;
+	_whileStatement.condition().accept(*this);
+	_whileStatement.body().accept(*this);
+	m_loopDepth--;
+	m_segment++;
+	return false;
+}
+
+bool StorageCache::visit(ForStatement const& _forStatement)
+{
+	if (_forStatement.initializationExpression())
+		_forStatement.initializationExpression()->accept(*this);
+	m_segment++;
+	m_loopDepth++;
+	if (_forStatement.condition())
+		_forStatement.condition()->accept(*this);
+	_forStatement.body().accept(*this);
+	if (_forStatement.loopExpression())
+		_forStatement.loopExpression()->accept(*this);
+	m_loopDepth--;
+	m_segment++;
+	return false;
+}
+
+bool StorageCache::visit(InlineAssembly const&)
+{
+	m_cacheable = false;
+	return false;
+}
+
+bool StorageCache::visit(Conditional const& _conditional)
+{
+	_conditional.condition().accept(*this);
+	m_segment++;
+	_conditional.trueExpression().accept(*this);
+	m_segment++;
+	_conditional.falseExpression().accept(*this);
+	m_segment++;
+	return false;
+}
+
+bool StorageCache::visit(BinaryOperation const& _operation)
+{
+	if (_operation.getOperator() != Token::And && _operation.getOperator() != Token::Or)
+		return true;
+	_operation.leftExpression().accept(*this);
+	m_segment++;
+	_operation.rightExpression().accept(*this);
+	m_segment++;
+	return false;
+}
+
+void StorageCache::endVisit(FunctionCall const& _functionCall)
+{
+	if (_functionCall.annotation().kind != FunctionCallKind::FunctionCall)
+		return;
+	FunctionType const& function = dynamic_cast<FunctionType const&>(*_functionCall.expression().annotation().type);
+	switch (function.kind())
+	{
+	case FunctionType::Kind::Event:
+	case FunctionType::Kind::Log0:
+	case FunctionType::Kind::Log1:
+	case FunctionType::Kind::Log2:
+	case FunctionType::Kind::Log3:
+	case FunctionType::Kind::Log4:
+	case FunctionType::Kind::SHA3:
+	case FunctionType::Kind::BlockHash:
+	case FunctionType::Kind::AddMod:
+	case FunctionType::Kind::MulMod:
+		break;
+	case FunctionType::Kind::ECRecover:
+	case FunctionType::Kind::SHA256:
+	case FunctionType::Kind::RIPEMD160:
+	case FunctionType::Kind::ArrayPush:
+	case FunctionType::Kind::ByteArrayPush:
+	case FunctionType::Kind::ObjectCreation:
+	case FunctionType::Kind::Assert:
+	case FunctionType::Kind::Require:
+	case FunctionType::Kind::Revert:
+		// Calls to precompiled contracts, loops and conditional jumps end the basic block.
+		m_segment++;
+		break;
+	default:
+		// Other code could access the cached slots.
+		m_cacheable = false;
+		break;
+	}
+}
+
+void StorageCache::endVisit(VariableDeclaration const& _variable)
+{
+	recordDeclaration(_variable);
+}
+
+bool StorageCache::visit(MemberAccess const& _memberAccess)
+{
+	if (recordAccess(_memberAccess))
+		return false;
+	recordOtherUse(_memberAccess);
+	return true;
+}
+
+void StorageCache::endVisit(Identifier const& _identifier)
+{
+	if (!recordAccess(_identifier))
+		recordOtherUse(_identifier);
+}
+
+bool StorageCache::recordAccess(Expression const& _expression)
+{
+	pair<u256, unsigned> location;
+	if (!directStorageLocation(_expression, m_context, location))
+		return false;
+	auto usage = m_usage.find(location.first);
+	if (usage == m_usage.end())
+	{
+		usage = m_usage.insert(make_pair(location.first, SlotUsage())).first;
+		usage->second.firstSegment = m_segment;
+	}
+	else if (usage->second.firstSegment != m_segment)
+		usage->second.accessedInSeveralSegments = true;
+	if (m_loopDepth > 0)
+		usage->second.accessedInLoop = true;
+	if (_expression.annotation().lValueRequested)
+		usage->second.written = true;
+	return true;
+}
+
+void StorageCache::recordDeclaration(VariableDeclaration const& _variable)
+{
+	// Storage pointers can point to cached slots, even uninitialised ones (they point to slot zero),
+	// and writes through them would bypass the copies in memory.
+	TypePointer const& type = _variable.annotation().type;
+	if (!_variable.isStateVariable() && type && type->dataStoredIn(DataLocation::Storage))
+		m_cacheable = false;
+}
+
+void StorageCache::recordOtherUse(Expression const& _expression)
+{
+	Declaration const* declaration = nullptr;
+	if (auto identifier = dynamic_cast<Identifier const*>(&_expression))
+		declaration = identifier->annotation().referencedDeclaration;
+	else if (auto memberAccess = dynamic_cast<MemberAccess const*>(&_expression))
+		declaration = memberAccess->annotation().referencedDeclaration;
+	auto variable = dynamic_cast<VariableDeclaration const*>(declaration);
+	if (variable && m_context.isStateVariable(variable))
+		m_usedAsWhole.insert(variable);
+}
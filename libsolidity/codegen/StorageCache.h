@@ -0,0 +1,151 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Copies of storage slots that a function keeps in memory while it runs.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTVisitor.h>
+
+#include <libdevcore/Common.h>
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+class CompilerContext;
+
+/**
+ * Decides which storage slots a function keeps in memory and generates the code that loads
+ * them when the function is entered and writes them back when it returns.
+ *
+ * Only slots of value-type state variables (``x``, ``C.x``) and of value-type members of struct
+ * state variables that are accessed through the variable (``s.x``) are considered, and only in
+ * functions whose code (including modifiers) neither contains inline assembly nor calls anything
+ * but built-in functions that cannot run other code, and which do not declare storage pointers
+ * (parameters or local variables). Nothing else can then access these slots while the function
+ * runs. Struct variables that are also used as a whole are not cached at all,
+ * since a storage pointer to them could alias the members.
+ *
+ * While the function runs, all reads and writes of a cached slot use the copy in memory, so
+ * writes to several variables packed into the same slot result in a single SSTORE when the
+ * function returns, which is skipped if the value did not change. Since the optimiser already
+ * re-uses storage values within basic blocks, a slot is only cached if it is accessed inside a
+ * loop or in parts of the function that are separated by control flow.
+ *
+ * All functions share the memory area directly after the free memory pointer, which is reserved
+ * when the contract is initialised: a function that caches slots does not call other functions,
+ * so no two of them can be active at the same time.
+ */
+class StorageCache: private ASTConstVisitor
+{
+public:
+	/// Analyses the body and the modifiers of @a _function.
+	StorageCache(FunctionDefinition const& _function, CompilerContext const& _context);
+
+	/// @returns true if no slot is cached.
+	bool empty() const { return m_slots.empty(); }
+	/// @returns true if the slot @a _slot is cached.
+	bool contains(u256 const& _slot) const { return m_slots.count(_slot); }
+	/// @returns the memory address of the copy of the cached slot @a _slot.
+	u256 address(u256 const& _slot) const;
+	/// @returns the number of bytes of memory the cache needs.
+	size_t memorySize() const;
+
+	/// Appends code that copies the cached slots to memory.
+	void appendLoad(CompilerContext& _context) const;
+	/// Appends code that writes the cached slots the function changed back to storage.
+	void appendWriteBack(CompilerContext& _context) const;
+
+	/// @returns true and sets @a _location to the storage slot and byte offset of the value if
+	/// @a _expression accesses a value-type state variable or a value-type member of a struct
+	/// state variable in a way the cache can handle.
+	static bool directStorageLocation(
+		Expression const& _expression,
+		CompilerContext const& _context,
+		std::pair<u256, unsigned>& _location
+	);
+
+	/// Start of the memory area the functions keep their caches in.
+	static u256 const memoryStart;
+
+private:
+	struct SlotUsage
+	{
+		/// Part of the function (between two control flow constructs) with the first access.
+		size_t firstSegment = 0;
+		bool accessedInLoop = false;
+		bool accessedInSeveralSegments = false;
+		bool written = false;
+	};
+	struct CachedSlot
+	{
+		u256 slot;
+		/// Whether the function can write to the slot, which requires to keep the original value.
+		bool written;
+	};
+
+	virtual bool visit(IfStatement const& _ifStatement) override;
+	virtual bool visit(WhileStatement const& _whileStatement) override;
+	virtual bool visit(ForStatement const& _forStatement) override;
+	virtual void endVisit(Continue const&) override { m_segment++; }
+	virtual void endVisit(Break const&) override { m_segment++; }
+	virtual void endVisit(Return const&) override { m_segment++; }
+	virtual void endVisit(Throw const&) override { m_segment++; }
+	virtual bool visit(InlineAssembly const&) override;
+	virtual bool visit(Conditional const& _conditional) override;
+	virtual bool visit(BinaryOperation const& _operation) override;
+	virtual void endVisit(FunctionCall const& _functionCall) override;
+	virtual void endVisit(VariableDeclaration const& _variable) override;
+	virtual bool visit(MemberAccess const& _memberAccess) override;
+	virtual void endVisit(Identifier const& _identifier) override;
+
+	/// Records an access to the value accessed by @a _expression if it is cacheable.
+	/// @returns true if it was recorded.
+	bool recordAccess(Expression const& _expression);
+	/// Rules out caching if @a _variable is a storage pointer.
+	void recordDeclaration(VariableDeclaration const& _variable);
+	/// Records that the state variable referenced by @a _expression (if any) is used in a way
+	/// the cache cannot handle.
+	void recordOtherUse(Expression const& _expression);
+
+	CompilerContext const& m_context;
+	/// False if the function contains anything that rules out caching.
+	bool m_cacheable = true;
+	/// Number of the current part of the function between two control flow constructs.
+	size_t m_segment = 0;
+	size_t m_loopDepth = 0;
+	std::map<u256, SlotUsage> m_usage;
+	/// Struct state variables that are not only accessed through their value-type members.
+	std::set<VariableDeclaration const*> m_usedAsWhole;
+
+	/// The cached slots in the order of their copies in memory. The original values of the
+	/// slots the function writes to follow after the copies.
+	std::vector<CachedSlot> m_cachedSlots;
+	/// Index into m_cachedSlots for every cached slot.
+	std::map<u256, size_t> m_slots;
+};
+
+}
+}
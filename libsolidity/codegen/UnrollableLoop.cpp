@@ -0,0 +1,208 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Loops with a number of iterations known at compile time.
+ */
+
+#include <libsolidity/codegen/UnrollableLoop.h>
+
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTUtils.h>
+#include <libsolidity/ast/TypeProvider.h>
+#include <libsolidity/codegen/CompilerContext.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace
+{
+
+/// Estimated size of the code generated for an AST node in bytes.
+size_t const c_bytesPerNode = 5;
+
+/// Estimates the size of the code for a part of a loop and checks whether it can be repeated.
+class CodeScanner: private ASTConstVisitor
+{
+public:
+	/// @a _counter is the loop counter, which must not be written to, if given. @a _innerLoops
+	/// are the loops inside @a _node that were already analysed.
+	CodeScanner(
+		ASTNode const& _node,
+		VariableDeclaration const* _counter,
+		map<ForStatement const*, UnrollableLoop> const& _innerLoops
+	):
+		m_counter(_counter),
+		m_innerLoops(_innerLoops)
+	{
+		_node.accept(*this);
+	}
+
+	bool repeatable() const { return m_repeatable; }
+	size_t bytes() const { return m_bytes; }
+
+private:
+	virtual bool visitNode(ASTNode const&) override
+	{
+		m_bytes += c_bytesPerNode;
+		return true;
+	}
+	virtual bool visit(ForStatement const& _forStatement) override
+	{
+		// The body of an unrolled loop is counted once below.
+		auto innerLoop = m_innerLoops.find(&_forStatement);
+		if (innerLoop != m_innerLoops.end() && innerLoop->second.unroll && innerLoop->second.iterations > 1)
+			m_bytes += size_t(innerLoop->second.iterations - 1) * innerLoop->second.bytesPerIteration;
+		return visitNode(_forStatement);
+	}
+	virtual bool visit(InlineAssembly const&) override
+	{
+		m_repeatable = false;
+		return false;
+	}
+	virtual bool visit(PlaceholderStatement const&) override
+	{
+		m_repeatable = false;
+		return false;
+	}
+	virtual bool visit(NewExpression const& _newExpression) override
+	{
+		auto functionType = dynamic_cast<FunctionType const*>(_newExpression.annotation().type.get());
+		if (functionType && functionType->kind() == FunctionType::Kind::Creation)
+			m_repeatable = false;
+		return visitNode(_newExpression);
+	}
+	virtual void endVisit(Identifier const& _identifier) override
+	{
+		if (
+			m_counter &&
+			_identifier.annotation().lValueRequested &&
+			_identifier.annotation().referencedDeclaration == m_counter
+		)
+			m_repeatable = false;
+	}
+
+	VariableDeclaration const* m_counter;
+	map<ForStatement const*, UnrollableLoop> const& m_innerLoops;
+	bool m_repeatable = true;
+	size_t m_bytes = 0;
+};
+
+}
+
+UnrollableLoopFinder::UnrollableLoopFinder(Block const& _body, CompilerContext& _context):
+	m_context(_context)
+{
+	_body.accept(*this);
+}
+
+bool UnrollableLoopFinder::visit(ForStatement const& _forStatement)
+{
+	// Inner loops are analysed first, since their size counts for this loop.
+	_forStatement.body().accept(*this);
+	if (boost::optional<UnrollableLoop> loop = unrollableLoop(_forStatement))
+		m_loops[&_forStatement] = *loop;
+	return false;
+}
+
+boost::optional<UnrollableLoop> UnrollableLoopFinder::unrollableLoop(ForStatement const& _forStatement)
+{
+	auto condition = dynamic_cast<BinaryOperation const*>(_forStatement.condition());
+	if (
+		!condition ||
+		(condition->getOperator() != Token::LessThan && condition->getOperator() != Token::LessThanOrEqual) ||
+		!_forStatement.initializationExpression() ||
+		!_forStatement.loopExpression()
+	)
+		return boost::none;
+	VariableDeclaration const* counter = referencedVariable(&condition->leftExpression());
+	if (!counter || !counter->isLocalVariable() || *counter->annotation().type != *TypeProvider::uint256())
+		return boost::none;
+
+	// The initialisation has to be ``uint i = a`` or ``i = a``.
+	Expression const* start = nullptr;
+	Statement const& initialisation = *_forStatement.initializationExpression();
+	if (auto declaration = dynamic_cast<VariableDeclarationStatement const*>(&initialisation))
+	{
+		if (declaration->declarations().size() == 1 && declaration->declarations().front().get() == counter)
+			start = declaration->initialValue();
+	}
+	else if (auto statement = dynamic_cast<ExpressionStatement const*>(&initialisation))
+		if (auto assignment = dynamic_cast<Assignment const*>(&statement->expression()))
+			if (assignment->assignmentOperator() == Token::Assign && referencedVariable(&assignment->leftHandSide()) == counter)
+				start = &assignment->rightHandSide();
+	boost::optional<u256> startValue = start ? constantValue(*start) : boost::none;
+	if (!startValue)
+		return boost::none;
+
+	// The loop expression has to be ``i++``, ``++i`` or ``i += c``.
+	u256 step = 1;
+	Expression const& increment = _forStatement.loopExpression()->expression();
+	if (auto operation = dynamic_cast<UnaryOperation const*>(&increment))
+	{
+		if (operation->getOperator() != Token::Inc || referencedVariable(&operation->subExpression()) != counter)
+			return boost::none;
+	}
+	else if (auto assignment = dynamic_cast<Assignment const*>(&increment))
+	{
+		if (assignment->assignmentOperator() != Token::AssignAdd || referencedVariable(&assignment->leftHandSide()) != counter)
+			return boost::none;
+		boost::optional<u256> stepValue = constantValue(assignment->rightHandSide());
+		if (!stepValue || *stepValue == 0)
+			return boost::none;
+		step = *stepValue;
+	}
+	else
+		return boost::none;
+
+	// The bound is constant or the length of a statically-sized array.
+	boost::optional<u256> bound;
+	Expression const& boundExpression = condition->rightExpression();
+	auto memberAccess = dynamic_cast<MemberAccess const*>(&boundExpression);
+	if (memberAccess && memberAccess->memberName() == "length")
+	{
+		auto arrayType = dynamic_cast<ArrayType const*>(memberAccess->expression().annotation().type.get());
+		if (arrayType && !arrayType->isDynamicallySized() && referencedVariable(&memberAccess->expression()))
+			bound = arrayType->length();
+	}
+	else
+		bound = constantValue(boundExpression);
+	if (!bound)
+		return boost::none;
+
+	bigint first = *startValue;
+	bigint end = bigint(*bound) + (condition->getOperator() == Token::LessThanOrEqual ? 1 : 0);
+	bigint iterations = first < end ? (end - first + bigint(step) - 1) / bigint(step) : bigint(0);
+	if (first + iterations * bigint(step) >= bigint(1) << 256)
+		return boost::none;
+
+	CodeScanner body(_forStatement.body(), counter, m_loops);
+	if (!body.repeatable())
+		return boost::none;
+	CodeScanner loopExpression(*_forStatement.loopExpression(), nullptr, m_loops);
+
+	UnrollableLoop loop;
+	loop.iterations = u256(iterations);
+	loop.bytesPerIteration = body.bytes() + loopExpression.bytes();
+	loop.unroll = iterations <= m_context.maxUnrolledIterations(loop.bytesPerIteration);
+	return loop;
+}
+
+boost::optional<u256> UnrollableLoopFinder::constantValue(Expression const& _expression)
+{
+	return m_context.constantFolder().valueAs(_expression, *TypeProvider::uint256(), m_context);
+}
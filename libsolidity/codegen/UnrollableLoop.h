@@ -0,0 +1,87 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Loops with a number of iterations known at compile time.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTVisitor.h>
+
+#include <libdevcore/Common.h>
+
+#include <boost/optional.hpp>
+
+#include <map>
+
+namespace dev
+{
+namespace solidity
+{
+
+class CompilerContext;
+
+/**
+ * A ``for`` loop whose number of iterations is known at compile time, so that its body can be
+ * repeated that many times without checking the condition.
+ */
+struct UnrollableLoop
+{
+	/// Number of times the body is executed.
+	u256 iterations;
+	/// Estimated size of the code of the body and the loop expression in bytes.
+	size_t bytesPerIteration = 0;
+	/// True if unrolling the loop pays off.
+	bool unroll = false;
+};
+
+/**
+ * Finds the loops with a known number of iterations in the body of a function or modifier.
+ *
+ * The counter of such a loop is a ``uint256`` local variable ``i``, the loop has the form
+ * ``for (i = a; i < b; i += c)``, where the initialisation can also declare the counter, the
+ * condition can also be ``i <= b`` and the loop expression ``i++`` or ``++i``. The values ``a``,
+ * ``b`` and ``c`` are constant or ``b`` is the length of a statically-sized array. The counter
+ * must not be written to in the body and must not overflow after the last iteration, since the
+ * loop would not end then. Loops whose body contains inline assembly (which could change the
+ * counter), the placeholder ``_`` or contract creations (which would copy the code of the created
+ * contract) are not considered.
+ *
+ * Whether unrolling a loop pays off depends on the number of runs the optimiser is told to
+ * expect. The size of the code of unrolled inner loops counts for their enclosing loops.
+ */
+class UnrollableLoopFinder: private ASTConstVisitor
+{
+public:
+	UnrollableLoopFinder(Block const& _body, CompilerContext& _context);
+
+	std::map<ForStatement const*, UnrollableLoop> const& loops() const { return m_loops; }
+
+private:
+	virtual bool visit(ForStatement const& _forStatement) override;
+
+	/// @returns the loop @a _forStatement if its number of iterations is known.
+	boost::optional<UnrollableLoop> unrollableLoop(ForStatement const& _forStatement);
+	/// @returns the value of @a _expression as ``uint256`` if it is constant.
+	boost::optional<u256> constantValue(Expression const& _expression);
+
+	CompilerContext& m_context;
+	std::map<ForStatement const*, UnrollableLoop> m_loops;
+};
+
+}
+}
@@ -143,7 +143,7 @@ private:
 
 void assembly::CodeGenerator::assemble(
 	Block const& _parsedData,
-	AsmAnalysisInfo& _analysisInfo,
+	AsmAnalysisInfo const& _analysisInfo,
 	eth::Assembly& _assembly,
 	julia::ExternalIdentifierAccess const& _identifierAccess,
 	bool _useNamedLabelsForFunctions
@@ -44,7 +44,7 @@ public:
 	/// Performs code generation and appends generated to to _assembly.
 	static void assemble(
 		Block const& _parsedData,
-		AsmAnalysisInfo& _analysisInfo,
+		AsmAnalysisInfo const& _analysisInfo,
 		eth::Assembly& _assembly,
 		julia::ExternalIdentifierAccess const& _identifierAccess = julia::ExternalIdentifierAccess(),
 		bool _useNamedLabelsForFunctions = false
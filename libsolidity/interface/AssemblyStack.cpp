@@ -88,6 +88,7 @@ MachineAssemblyObject AssemblyStack::assemble(Machine _machine) const
 	case Machine::EVM:
 	{
 		MachineAssemblyObject object;
+		eth::AssemblyItemTables::Scope itemScope(make_shared<eth::AssemblyItemTables>());
 		eth::Assembly assembly;
 		assembly::CodeGenerator::assemble(*m_parserResult, *m_analysisInfo, assembly);
 		object.bytecode = make_shared<eth::LinkerObject>(assembly.assemble());
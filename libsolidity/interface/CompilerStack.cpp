@@ -27,6 +27,8 @@
 #include <libsolidity/interface/Version.h>
 #include <libsolidity/analysis/SemVerHandler.h>
 #include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTStringTable.h>
+#include <libsolidity/ast/TypeProvider.h>
 #include <libsolidity/parsing/Scanner.h>
 #include <libsolidity/parsing/Parser.h>
 #include <libsolidity/analysis/GlobalContext.h>
@@ -38,9 +40,12 @@
 #include <libsolidity/analysis/SyntaxChecker.h>
 #include <libsolidity/analysis/ViewPureChecker.h>
 #include <libsolidity/codegen/Compiler.h>
+#include <libsolidity/codegen/InlineAssemblyCache.h>
+#include <libsolidity/codegen/ABIRoutineStore.h>
 #include <libsolidity/formal/SMTChecker.h>
 #include <libsolidity/interface/ABI.h>
 #include <libsolidity/interface/Natspec.h>
+#include <libsolidity/interface/StorageLayout.h>
 #include <libsolidity/interface/GasEstimator.h>
 
 #include <libsolidity/oraclize/OraclizePass.h>
@@ -93,6 +98,11 @@ void CompilerStack::reset(bool _keepSources)
 	m_optimize = false;
 	m_optimizeRuns = 200;
 	m_globalContext.reset();
+	m_typeProvider.reset();
+	m_astStrings.reset();
+	m_inlineAssemblyCache.reset();
+	m_abiRoutineStore.reset();
+	m_assemblyItemTables.reset();
 	m_scopes.clear();
 	m_sourceOrder.clear();
 	m_contracts.clear();
@@ -100,10 +110,15 @@ void CompilerStack::reset(bool _keepSources)
 }
 
 bool CompilerStack::addSource(string const& _name, string const& _content, bool _isLibrary)
+{
+	return addSource(_name, make_shared<string const>(_content), _isLibrary);
+}
+
+bool CompilerStack::addSource(string const& _name, shared_ptr<string const> _content, bool _isLibrary)
 {
 	bool existed = m_sources.count(_name) != 0;
 	reset(true);
-	m_sources[_name].scanner = make_shared<Scanner>(CharStream(_content), _name);
+	m_sources[_name].scanner = make_shared<Scanner>(CharStream(move(_content)), _name);
 	m_sources[_name].isLibrary = _isLibrary;
 	m_stackState = SourcesSet;
 	return existed;
@@ -116,6 +131,7 @@ bool CompilerStack::parse()
 		return false;
 	m_errorReporter.clear();
 	ASTNode::resetID();
+	m_astStrings = make_shared<ASTStringTable>();
 
 	if (SemVerVersion{string(VersionString)}.isPrerelease())
 		m_errorReporter.warning("This is a pre-release compiler version, please do not use it in production.");
@@ -128,17 +144,16 @@ bool CompilerStack::parse()
 		string const& path = sourcesToParse[i];
 		Source& source = m_sources[path];
 		source.scanner->reset();
-		source.ast = Parser(m_errorReporter).parse(source.scanner);
+		source.ast = Parser(m_errorReporter, m_astStrings).parse(source.scanner);
 		if (!source.ast)
 			solAssert(!Error::containsOnlyWarnings(m_errorReporter.errors()), "Parser returned null but did not report error.");
 		else
 		{
 			source.ast->annotation().path = path;
-			for (auto const& newSource: loadMissingSources(*source.ast, path))
+			for (auto& newSource: loadMissingSources(*source.ast, path))
 			{
 				string const& newPath = newSource.first;
-				string const& newContents = newSource.second;
-				m_sources[newPath].scanner = make_shared<Scanner>(CharStream(newContents), newPath);
+				m_sources[newPath].scanner = make_shared<Scanner>(CharStream(move(newSource.second)), newPath);
 				sourcesToParse.push_back(newPath);
 			}
 		}
@@ -156,6 +171,9 @@ bool CompilerStack::analyze()
 {
 	if (m_stackState != ParsingSuccessful)
 		return false;
+	// Member lists cached in the canonical types refer to the contracts of the last analysis.
+	m_typeProvider = make_shared<TypeProvider>();
+	TypeProvider::Scope typeScope(*m_typeProvider);
 	resolveImports();
 
 	bool noErrors = true;
@@ -294,6 +312,11 @@ bool CompilerStack::compile()
 		if (!parseAndAnalyze())
 			return false;
 
+	TypeProvider::Scope typeScope(*m_typeProvider);
+	m_assemblyItemTables = make_shared<eth::AssemblyItemTables>();
+	eth::AssemblyItemTables::Scope itemScope(m_assemblyItemTables);
+	m_inlineAssemblyCache = make_shared<InlineAssemblyCache>();
+	m_abiRoutineStore = make_shared<ABIRoutineStore>();
 	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
 	for (Source const* source: m_sourceOrder)
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
@@ -396,7 +419,7 @@ eth::LinkerObject const& CompilerStack::cloneObject(string const& _contractName)
 }
 
 /// FIXME: cache this string
-string CompilerStack::assemblyString(string const& _contractName, StringMap _sourceCodes) const
+string CompilerStack::assemblyString(string const& _contractName, StringMap const& _sourceCodes) const
 {
 	Contract const& currentContract = contract(_contractName);
 	if (currentContract.compiler)
@@ -405,8 +428,17 @@ string CompilerStack::assemblyString(string const& _contractName, StringMap _sou
 		return string();
 }
 
+string CompilerStack::optimiserReport(string const& _contractName) const
+{
+	Contract const& currentContract = contract(_contractName);
+	if (currentContract.compiler)
+		return currentContract.compiler->optimiserReport();
+	else
+		return string();
+}
+
 /// FIXME: cache the JSON
-Json::Value CompilerStack::assemblyJSON(string const& _contractName, StringMap _sourceCodes) const
+Json::Value CompilerStack::assemblyJSON(string const& _contractName, StringMap const& _sourceCodes) const
 {
 	Contract const& currentContract = contract(_contractName);
 	if (currentContract.compiler)
@@ -445,6 +477,7 @@ Json::Value const& CompilerStack::contractABI(Contract const& _contract) const
 	solAssert(_contract.contract, "");
 
 	// caches the result
+	TypeProvider::Scope typeScope(*m_typeProvider);
 	if (!_contract.abi)
 		_contract.abi.reset(new Json::Value(ABI::generate(*_contract.contract)));
 
@@ -464,6 +497,7 @@ Json::Value const& CompilerStack::natspecUser(Contract const& _contract) const
 	solAssert(_contract.contract, "");
 
 	// caches the result
+	TypeProvider::Scope typeScope(*m_typeProvider);
 	if (!_contract.userDocumentation)
 		_contract.userDocumentation.reset(new Json::Value(Natspec::userDocumentation(*_contract.contract)));
 
@@ -483,6 +517,7 @@ Json::Value const& CompilerStack::natspecDev(Contract const& _contract) const
 	solAssert(_contract.contract, "");
 
 	// caches the result
+	TypeProvider::Scope typeScope(*m_typeProvider);
 	if (!_contract.devDocumentation)
 		_contract.devDocumentation.reset(new Json::Value(Natspec::devDocumentation(*_contract.contract)));
 
@@ -491,12 +526,32 @@ Json::Value const& CompilerStack::natspecDev(Contract const& _contract) const
 
 Json::Value CompilerStack::methodIdentifiers(string const& _contractName) const
 {
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
+
+	TypeProvider::Scope typeScope(*m_typeProvider);
 	Json::Value methodIdentifiers(Json::objectValue);
 	for (auto const& it: contractDefinition(_contractName).interfaceFunctions())
 		methodIdentifiers[it.second->externalSignature()] = toHex(it.first.ref());
 	return methodIdentifiers;
 }
 
+Json::Value const& CompilerStack::storageLayout(string const& _contractName) const
+{
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
+
+	Contract const& c = contract(_contractName);
+	solAssert(c.contract, "");
+
+	// caches the result
+	TypeProvider::Scope typeScope(*m_typeProvider);
+	if (!c.storageLayout)
+		c.storageLayout.reset(new Json::Value(StorageLayout::generate(*c.contract)));
+
+	return *c.storageLayout;
+}
+
 string const& CompilerStack::metadata(string const& _contractName) const
 {
 	if (m_stackState != CompilationSuccessful)
@@ -521,6 +576,46 @@ SourceUnit const& CompilerStack::ast(string const& _sourceName) const
 	return *source(_sourceName).ast;
 }
 
+ASTStringTable const& CompilerStack::astStrings() const
+{
+	if (m_stackState < ParsingSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
+
+	return *m_astStrings;
+}
+
+TypeProvider& CompilerStack::typeProvider() const
+{
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
+
+	return *m_typeProvider;
+}
+
+InlineAssemblyCache const& CompilerStack::inlineAssemblyCache() const
+{
+	if (m_stackState != CompilationSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+
+	return *m_inlineAssemblyCache;
+}
+
+ABIRoutineStore const& CompilerStack::abiRoutineStore() const
+{
+	if (m_stackState != CompilationSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+
+	return *m_abiRoutineStore;
+}
+
+eth::AssemblyItemTables const& CompilerStack::assemblyItemTables() const
+{
+	if (m_stackState != CompilationSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+
+	return *m_assemblyItemTables;
+}
+
 ContractDefinition const& CompilerStack::contractDefinition(string const& _contractName) const
 {
 	if (m_stackState != CompilationSuccessful)
@@ -705,7 +800,7 @@ void CompilerStack::compileContract(
 	for (auto const* dependency: _contract.annotation().contractDependencies)
 		compileContract(*dependency, _compiledContracts);
 
-	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_optimize, m_optimizeRuns);
+	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_optimize, m_optimizeRuns, m_inlineAssemblyCache, m_abiRoutineStore);
 	Contract& compiledContract = m_contracts.at(_contract.fullyQualifiedName());
 	string metadata = createMetadata(compiledContract);
 	bytes cborEncodedHash =
@@ -762,7 +857,7 @@ void CompilerStack::compileContract(
 
 	try
 	{
-		Compiler cloneCompiler(m_optimize, m_optimizeRuns);
+		Compiler cloneCompiler(m_optimize, m_optimizeRuns, m_inlineAssemblyCache, m_abiRoutineStore);
 		cloneCompiler.compileClone(_contract, _compiledContracts);
 		compiledContract.cloneObject = cloneCompiler.assembledObject();
 	}
@@ -849,15 +944,16 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 			continue;
 
 		solAssert(s.second.scanner, "Scanner not available");
+		string const& content = s.second.scanner->source();
 		meta["sources"][s.first]["keccak256"] =
-			"0x" + toHex(dev::keccak256(s.second.scanner->source()).asBytes());
+			"0x" + toHex(dev::keccak256(content).asBytes());
 		if (m_metadataLiteralSources)
-			meta["sources"][s.first]["content"] = s.second.scanner->source();
+			meta["sources"][s.first]["content"] = content;
 		else
 		{
 			meta["sources"][s.first]["urls"] = Json::arrayValue;
 			meta["sources"][s.first]["urls"].append(
-				"bzzr://" + toHex(dev::swarmHash(s.second.scanner->source()).asBytes())
+				"bzzr://" + toHex(dev::swarmHash(content).asBytes())
 			);
 		}
 	}
@@ -975,6 +1071,8 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 	if (!assemblyItems(_contractName) && !runtimeAssemblyItems(_contractName))
 		return Json::Value();
 
+	TypeProvider::Scope typeScope(*m_typeProvider);
+	eth::AssemblyItemTables::Scope itemScope(m_assemblyItemTables);
 	using Gas = GasEstimator::GasConsumption;
 	Json::Value output(Json::objectValue);
 
@@ -45,6 +45,7 @@ namespace eth
 {
 class Assembly;
 class AssemblyItem;
+class AssemblyItemTables;
 using AssemblyItems = std::vector<AssemblyItem>;
 }
 
@@ -62,6 +63,10 @@ class GlobalContext;
 class Natspec;
 class Error;
 class DeclarationContainer;
+class ASTStringTable;
+class TypeProvider;
+class InlineAssemblyCache;
+class ABIRoutineStore;
 
 /**
  * Easy to use and self-contained Solidity compiler with as few header dependencies as possible.
@@ -129,6 +134,8 @@ class CompilerStack : boost::noncopyable
 	/// Adds a source object (e.g. file) to the parser. After this, parse has to be called again.
 	/// @returns true if a source object by the name already existed and was replaced.
 	bool addSource(std::string const &_name, std::string const &_content, bool _isLibrary = false);
+	/// Adds a source object whose contents are shared with the caller instead of being copied.
+	bool addSource(std::string const &_name, std::shared_ptr<std::string const> _content, bool _isLibrary = false);
 
 	/// Parses all source units that were added
 	/// @returns false on error.
@@ -160,6 +167,22 @@ class CompilerStack : boost::noncopyable
 	/// @returns the parsed source unit with the supplied name.
 	SourceUnit const &ast(std::string const &_sourceName) const;
 
+	/// @returns the table the identifiers and literals of all parsed source units are interned in.
+	ASTStringTable const &astStrings() const;
+
+	/// @returns the provider of the canonical types of the analysed source units. Code that
+	/// uses the source units with their types has to make it current (@see TypeProvider::Scope).
+	TypeProvider& typeProvider() const;
+
+	/// @returns the cache of the inline assembly routines generated during compilation.
+	InlineAssemblyCache const &inlineAssemblyCache() const;
+
+	/// @returns the store of the ABI coding routines generated during compilation.
+	ABIRoutineStore const &abiRoutineStore() const;
+
+	/// @returns the tables the constants and source locations of the assembly items are interned in.
+	eth::AssemblyItemTables const &assemblyItemTables() const;
+
 	/// Helper function for logs printing. Do only use in error cases, it's quite expensive.
 	/// line and columns are numbered starting from 1 with following order:
 	/// start line, start column, end line, end column
@@ -203,12 +226,16 @@ class CompilerStack : boost::noncopyable
 	/// @return a verbose text representation of the assembly.
 	/// @arg _sourceCodes is the map of input files to source code strings
 	/// Prerequisite: Successful compilation.
-	std::string assemblyString(std::string const &_contractName, StringMap _sourceCodes = StringMap()) const;
+	std::string assemblyString(std::string const &_contractName, StringMap const& _sourceCodes = StringMap()) const;
+
+	/// @returns a report of the per-iteration statistics of the bytecode optimiser.
+	/// Prerequisite: Successful compilation.
+	std::string optimiserReport(std::string const& _contractName) const;
 
 	/// @returns a JSON representation of the assembly.
 	/// @arg _sourceCodes is the map of input files to source code strings
 	/// Prerequisite: Successful compilation.
-	Json::Value assemblyJSON(std::string const &_contractName, StringMap _sourceCodes = StringMap()) const;
+	Json::Value assemblyJSON(std::string const &_contractName, StringMap const& _sourceCodes = StringMap()) const;
 
 	/// @returns a JSON representing the contract ABI.
 	/// Prerequisite: Successful call to parse or compile.
@@ -225,6 +252,10 @@ class CompilerStack : boost::noncopyable
 	/// @returns a JSON representing a map of method identifiers (hashes) to function names.
 	Json::Value methodIdentifiers(std::string const &_contractName) const;
 
+	/// @returns a JSON representing the storage layout of the contract.
+	/// Prerequisite: Successful call to parse or compile.
+	Json::Value const &storageLayout(std::string const &_contractName) const;
+
 	/// @returns the Contract Metadata
 	std::string const &metadata(std::string const &_contractName) const;
 
@@ -282,6 +313,7 @@ class CompilerStack : boost::noncopyable
 		mutable std::unique_ptr<Json::Value const> abi;
 		mutable std::unique_ptr<Json::Value const> userDocumentation;
 		mutable std::unique_ptr<Json::Value const> devDocumentation;
+		mutable std::unique_ptr<Json::Value const> storageLayout;
 		mutable std::unique_ptr<std::string const> sourceMapping;
 		mutable std::unique_ptr<std::string const> runtimeSourceMapping;
 	};
@@ -343,6 +375,16 @@ class CompilerStack : boost::noncopyable
 	std::vector<Remapping> m_remappings;
 	std::map<std::string const, Source> m_sources;
 	std::shared_ptr<GlobalContext> m_globalContext;
+	/// Canonical types of the analysed source units, handed out while this stack analyses and
+	/// compiles them.
+	std::shared_ptr<TypeProvider> m_typeProvider;
+	/// Identifiers and literals of all source units, shared between the parsers of one compilation.
+	std::shared_ptr<ASTStringTable> m_astStrings;
+	/// Inline assembly routines generated for the contracts of one compilation.
+	std::shared_ptr<InlineAssemblyCache> m_inlineAssemblyCache;
+	std::shared_ptr<ABIRoutineStore> m_abiRoutineStore;
+	/// Constants and source locations of the assembly items of one compilation.
+	std::shared_ptr<eth::AssemblyItemTables> m_assemblyItemTables;
 	std::map<ASTNode const *, std::shared_ptr<DeclarationContainer>> m_scopes;
 	std::vector<Source const *> m_sourceOrder;
 	std::map<std::string const, Contract> m_contracts;
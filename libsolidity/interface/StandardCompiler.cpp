@@ -262,7 +262,7 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 					"Mismatch between content and supplied hash for \"" + sourceName + "\""
 				));
 			else
-				m_compilerStack.addSource(sourceName, content);
+				m_compilerStack.addSource(sourceName, make_shared<string const>(move(content)));
 		}
 		else if (sources[sourceName]["urls"].isArray())
 		{
@@ -286,7 +286,7 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 						));
 					else
 					{
-						m_compilerStack.addSource(sourceName, result.responseOrErrorMessage);
+						m_compilerStack.addSource(sourceName, make_shared<string const>(move(result.responseOrErrorMessage)));
 						found = true;
 						break;
 					}
@@ -466,7 +466,7 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 		string file = contractName.substr(0, colon);
 		string name = contractName.substr(colon + 1);
 
-		// ABI, documentation and metadata
+		// ABI, documentation, metadata and storage layout
 		Json::Value contractData(Json::objectValue);
 		if (isArtifactRequested(outputSelection, file, name, "abi"))
 			contractData["abi"] = m_compilerStack.contractABI(contractName);
@@ -476,6 +476,8 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 			contractData["userdoc"] = m_compilerStack.natspecUser(contractName);
 		if (isArtifactRequested(outputSelection, file, name, "devdoc"))
 			contractData["devdoc"] = m_compilerStack.natspecDev(contractName);
+		if (isArtifactRequested(outputSelection, file, name, "storageLayout"))
+			contractData["storageLayout"] = m_compilerStack.storageLayout(contractName);
 
 		// EVM
 		Json::Value evmData(Json::objectValue);
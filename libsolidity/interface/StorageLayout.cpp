@@ -0,0 +1,105 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Generates the description of the storage layout of a contract.
+ */
+
+#include <libsolidity/interface/StorageLayout.h>
+#include <libsolidity/ast/AST.h>
+
+#include <libdevcore/CommonIO.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+Json::Value StorageLayout::generate(ContractDefinition const& _contractDef)
+{
+	Json::Value layout(Json::objectValue);
+	layout["storage"] = Json::arrayValue;
+	layout["types"] = Json::objectValue;
+
+	u256 slots = 0;
+	for (auto const& variable: ContractType(_contractDef).stateVariables())
+	{
+		VariableDeclaration const& declaration = *get<0>(variable);
+		u256 const& slot = get<1>(variable);
+		auto const* contract = dynamic_cast<ContractDefinition const*>(declaration.scope());
+		solAssert(contract, "");
+		Json::Value entry;
+		entry["label"] = declaration.name();
+		entry["contract"] = contract->sourceUnitName() + ":" + contract->name();
+		entry["slot"] = toString(slot);
+		entry["offset"] = get<2>(variable);
+		entry["type"] = addType(*declaration.annotation().type, layout["types"]);
+		layout["storage"].append(entry);
+		slots = max(slots, slot + declaration.annotation().type->storageSize());
+	}
+	layout["numberOfSlots"] = toString(slots);
+	return layout;
+}
+
+string StorageLayout::addType(Type const& _type, Json::Value& _types)
+{
+	string key = _type.identifier();
+	if (_types.isMember(key))
+		return key;
+
+	// Objects are stored in a map, so the reference stays valid while member types are added.
+	Json::Value& type = _types[key] = Json::objectValue;
+	type["label"] = _type.toString(true);
+	if (_type.isValueType())
+		type["numberOfBytes"] = toString(_type.storageBytes());
+	else
+		type["numberOfBytes"] = toString(_type.storageSize() * 32);
+
+	if (auto mappingType = dynamic_cast<MappingType const*>(&_type))
+	{
+		type["encoding"] = "mapping";
+		type["key"] = addType(*mappingType->keyType(), _types);
+		type["value"] = addType(*mappingType->valueType(), _types);
+	}
+	else if (auto arrayType = dynamic_cast<ArrayType const*>(&_type))
+	{
+		if (arrayType->isByteArray())
+			type["encoding"] = "bytes";
+		else
+		{
+			type["encoding"] = arrayType->isDynamicallySized() ? "dynamic_array" : "inplace";
+			type["base"] = addType(*arrayType->baseType(), _types);
+		}
+	}
+	else if (auto structType = dynamic_cast<StructType const*>(&_type))
+	{
+		type["encoding"] = "inplace";
+		Json::Value members(Json::arrayValue);
+		for (auto const& member: structType->members(nullptr))
+		{
+			pair<u256, unsigned> const& offsets = structType->storageOffsetsOfMember(member.name);
+			Json::Value entry;
+			entry["label"] = member.name;
+			entry["slot"] = toString(offsets.first);
+			entry["offset"] = offsets.second;
+			entry["type"] = addType(*member.type, _types);
+			members.append(entry);
+		}
+		type["members"] = members;
+	}
+	else
+		type["encoding"] = "inplace";
+	return key;
+}
@@ -0,0 +1,54 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Generates the description of the storage layout of a contract.
+ */
+
+#pragma once
+
+#include <json/json.h>
+
+#include <string>
+
+namespace dev
+{
+namespace solidity
+{
+
+// Forward declarations
+class ContractDefinition;
+class Type;
+
+class StorageLayout
+{
+public:
+	/// Get the storage layout of the contract
+	/// @param _contractDef The contract definition
+	/// @return             A JSON object with the slot and byte offset of every state variable
+	///                     ("storage"), the number of slots they occupy ("numberOfSlots") and a
+	///                     description of the types involved, including struct layouts ("types").
+	static Json::Value generate(ContractDefinition const& _contractDef);
+
+private:
+	/// Adds the description of @a _type and of the types it contains to @a _types,
+	/// unless it is already present.
+	/// @returns the key of @a _type in @a _types.
+	static std::string addType(Type const& _type, Json::Value& _types);
+};
+
+}
+}
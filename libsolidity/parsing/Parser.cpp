@@ -56,7 +56,7 @@ public:
 	{
 		if (m_location.end < 0)
 			markEndPosition();
-		return make_shared<NodeType>(m_location, forward<Args>(_args)...);
+		return makeArenaNode<NodeType>(m_parser.m_arena, m_location, std::forward<Args>(_args)...);
 	}
 
 private:
@@ -70,6 +70,7 @@ ASTPointer<SourceUnit> Parser::parse(shared_ptr<Scanner> const& _scanner)
 	{
 		m_recursionDepth = 0;
 		m_scanner = _scanner;
+		m_arena = new ASTArena();
 		ASTNodeFactory nodeFactory(*this);
 		vector<ASTPointer<ASTNode>> nodes;
 		while (m_scanner->currentToken() != Token::EOS)
@@ -92,7 +93,7 @@ ASTPointer<SourceUnit> Parser::parse(shared_ptr<Scanner> const& _scanner)
 			}
 		}
 		solAssert(m_recursionDepth == 0, "");
-		return nodeFactory.createNode<SourceUnit>(nodes);
+		return nodeFactory.createNode<SourceUnit>(nodes, m_arena);
 	}
 	catch (FatalError const&)
 	{
@@ -142,7 +143,7 @@ ASTPointer<ImportDirective> Parser::parseImportDirective()
 	ASTNodeFactory nodeFactory(*this);
 	expectToken(Token::Import);
 	ASTPointer<ASTString> path;
-	ASTPointer<ASTString> unitAlias = make_shared<string>();
+	ASTPointer<ASTString> unitAlias = m_strings->intern("");
 	vector<pair<ASTPointer<Identifier>, ASTPointer<ASTString>>> symbolAliases;
 
 	if (m_scanner->currentToken() == Token::StringLiteral)
@@ -335,7 +336,7 @@ Parser::FunctionHeaderParserResult Parser::parseFunctionHeader(bool _forceEmptyN
 	FunctionHeaderParserResult result;
 	expectToken(Token::Function);
 	if (_forceEmptyName || m_scanner->currentToken() == Token::LParen)
-		result.name = make_shared<ASTString>(); // anonymous function
+		result.name = m_strings->intern(""); // anonymous function
 	else
 		result.name = expectIdentifierToken();
 	VarDeclParserOptions options;
@@ -578,7 +579,7 @@ ASTPointer<VariableDeclaration> Parser::parseVariableDeclaration(
 
 	if (_options.allowEmptyName && m_scanner->currentToken() != Token::Identifier)
 	{
-		identifier = make_shared<ASTString>("");
+		identifier = m_strings->intern("");
 		solAssert(type != nullptr, "");
 		nodeFactory.setEndPositionFromNode(type);
 	}
@@ -1518,7 +1519,7 @@ ASTPointer<Expression> Parser::expressionFromIndexAccessStructure(
 		Identifier const& identifier = dynamic_cast<Identifier const&>(*_path[i]);
 		expression = nodeFactory.createNode<MemberAccess>(
 			expression,
-			make_shared<ASTString>(identifier.name())
+			m_strings->intern(identifier.name())
 		);
 	}
 	for (auto const& index: _indices)
@@ -1576,7 +1577,7 @@ ASTPointer<ASTString> Parser::expectIdentifierToken()
 
 ASTPointer<ASTString> Parser::getLiteralAndAdvance()
 {
-	ASTPointer<ASTString> identifier = make_shared<ASTString>(m_scanner->currentLiteral());
+	ASTPointer<ASTString> identifier = m_strings->intern(m_scanner->currentLiteral());
 	m_scanner->next();
 	return identifier;
 }
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTStringTable.h>
 #include <libsolidity/parsing/ParserBase.h>
 
 namespace dev
@@ -35,7 +36,11 @@ class Scanner;
 class Parser: public ParserBase
 {
 public:
-	explicit Parser(ErrorReporter& _errorReporter): ParserBase(_errorReporter) {}
+	/// @param _strings table used to intern identifiers and literals, a fresh one is used if not given.
+	explicit Parser(ErrorReporter& _errorReporter, std::shared_ptr<ASTStringTable> _strings = nullptr):
+		ParserBase(_errorReporter),
+		m_strings(_strings ? std::move(_strings) : std::make_shared<ASTStringTable>())
+	{}
 
 	ASTPointer<SourceUnit> parse(std::shared_ptr<Scanner> const& _scanner);
 
@@ -166,6 +171,10 @@ private:
 
 	/// Flag that signifies whether '_' is parsed as a PlaceholderStatement or a regular identifier.
 	bool m_insideModifier = false;
+	/// Arena the nodes of the source unit currently being parsed are allocated in.
+	ASTArenaPointer m_arena;
+	/// Table identifiers and literals are interned in, shared by all parsers of a compilation.
+	std::shared_ptr<ASTStringTable> m_strings;
 };
 
 }
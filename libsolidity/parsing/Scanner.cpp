@@ -51,10 +51,15 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <tuple>
 #include <libsolidity/interface/Exceptions.h>
 #include <libsolidity/parsing/Scanner.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 namespace dev
@@ -100,6 +105,97 @@ int hexValue(char c)
 		return c - 'A' + 10;
 	else return -1;
 }
+
+/// Block-wise scanning helpers. Each of them @returns the first position in
+/// [_pos, _size) of _data whose character does not belong to the run being
+/// skipped, or _size if the run extends to the end of the input.
+/// With SSE2 available, 16 characters are classified at a time.
+
+#if defined(__SSE2__)
+/// @returns the index of the first zero bit in the 16-bit movemask @a _mask,
+/// or 16 if all characters matched.
+inline size_t firstMismatch(int _mask)
+{
+	return _mask == 0xffff ? 16 : __builtin_ctz(~unsigned(_mask));
+}
+
+/// @returns a byte mask of the characters in @a _chars that lie in [_low, _high].
+/// Only valid for ASCII bounds, characters >= 0x80 compare as negative.
+inline __m128i inRange(__m128i _chars, char _low, char _high)
+{
+	return _mm_and_si128(
+		_mm_cmpgt_epi8(_chars, _mm_set1_epi8(_low - 1)),
+		_mm_cmplt_epi8(_chars, _mm_set1_epi8(_high + 1))
+	);
+}
+#endif
+
+size_t skipWhiteSpaceRun(char const* _data, size_t _pos, size_t _size)
+{
+#if defined(__SSE2__)
+	for (; _pos + 16 <= _size; _pos += 16)
+	{
+		__m128i chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_data + _pos));
+		__m128i matches = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\n'))),
+			_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\r')))
+		);
+		size_t offset = firstMismatch(_mm_movemask_epi8(matches));
+		if (offset < 16)
+			return _pos + offset;
+	}
+#endif
+	while (_pos < _size && isWhiteSpace(_data[_pos]))
+		++_pos;
+	return _pos;
+}
+
+size_t skipIdentifierPartRun(char const* _data, size_t _pos, size_t _size)
+{
+#if defined(__SSE2__)
+	for (; _pos + 16 <= _size; _pos += 16)
+	{
+		__m128i chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_data + _pos));
+		__m128i matches = _mm_or_si128(
+			_mm_or_si128(inRange(chars, 'a', 'z'), inRange(chars, 'A', 'Z')),
+			_mm_or_si128(
+				inRange(chars, '0', '9'),
+				_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('_')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('$')))
+			)
+		);
+		size_t offset = firstMismatch(_mm_movemask_epi8(matches));
+		if (offset < 16)
+			return _pos + offset;
+	}
+#endif
+	while (_pos < _size && isIdentifierPart(_data[_pos]))
+		++_pos;
+	return _pos;
+}
+
+/// @returns the position of the next line terminator, or _size if there is none.
+size_t findLineTerminator(char const* _data, size_t _pos, size_t _size)
+{
+	// memchr is vectorised by all relevant C libraries.
+	void const* found = memchr(_data + _pos, '\n', _size - _pos);
+	return found ? static_cast<char const*>(found) - _data : _size;
+}
+
+/// @returns the position of the '*' of the next "*/", or _size if there is none.
+size_t findMultiLineCommentEnd(char const* _data, size_t _pos, size_t _size)
+{
+	while (_pos < _size)
+	{
+		void const* found = memchr(_data + _pos, '*', _size - _pos);
+		if (!found)
+			break;
+		_pos = static_cast<char const*>(found) - _data;
+		if (_pos + 1 < _size && _data[_pos + 1] == '/')
+			return _pos;
+		++_pos;
+	}
+	return _size;
+}
 } // end anonymous namespace
 
 
@@ -236,11 +332,13 @@ Token::Value Scanner::selectToken(char _next, Token::Value _then, Token::Value _
 
 bool Scanner::skipWhitespace()
 {
-	int const startPosition = sourcePos();
-	while (isWhiteSpace(m_char))
-		advance();
-	// Return whether or not we skipped any characters.
-	return sourcePos() != startPosition;
+	// m_char is not necessarily the character at the current position (see
+	// skipMultiLineComment), so it is consumed separately.
+	if (!isWhiteSpace(m_char))
+		return false;
+	advance();
+	m_char = m_source.advanceTo(skipWhiteSpaceRun(m_source.data(), sourcePos(), m_source.size()));
+	return true;
 }
 
 bool Scanner::skipWhitespaceExceptLF()
@@ -258,8 +356,8 @@ Token::Value Scanner::skipSingleLineComment()
 	// to be part of the single-line comment; it is recognized
 	// separately by the lexical grammar and becomes part of the
 	// stream of input elements for the syntactic grammar
-	while (!isLineTerminator(m_char))
-		if (!advance()) break;
+	if (!isLineTerminator(m_char))
+		m_char = m_source.advanceTo(findLineTerminator(m_source.data(), sourcePos(), m_source.size()));
 
 	return Token::Whitespace;
 }
@@ -297,22 +395,18 @@ Token::Value Scanner::scanSingleLineDocComment()
 Token::Value Scanner::skipMultiLineComment()
 {
 	advance();
-	while (!isSourcePastEndOfInput())
-	{
-		char ch = m_char;
-		advance();
+	size_t end = findMultiLineCommentEnd(m_source.data(), sourcePos(), m_source.size());
+	m_char = m_source.advanceTo(end);
+	if (isSourcePastEndOfInput())
+		// Unterminated multi-line comment.
+		return Token::Illegal;
 
-		// If we have reached the end of the multi-line comment, we
-		// consume the '/' and insert a whitespace. This way all
-		// multi-line comments are treated as whitespace.
-		if (ch == '*' && m_char == '/')
-		{
-			m_char = ' ';
-			return Token::Whitespace;
-		}
-	}
-	// Unterminated multi-line comment.
-	return Token::Illegal;
+	// If we have reached the end of the multi-line comment, we
+	// consume the '/' and insert a whitespace. This way all
+	// multi-line comments are treated as whitespace.
+	advance();
+	m_char = ' ';
+	return Token::Whitespace;
 }
 
 Token::Value Scanner::scanMultiLineDocComment()
@@ -438,7 +532,8 @@ void Scanner::scanToken()
 		case '\n':
 		case ' ':
 		case '\t':
-			token = selectToken(Token::Whitespace);
+			skipWhitespace();
+			token = Token::Whitespace;
 			break;
 		case '"':
 		case '\'':
@@ -803,8 +898,10 @@ tuple<Token::Value, unsigned, unsigned> Scanner::scanIdentifierOrKeyword()
 	LiteralScope literal(this, LITERAL_TYPE_STRING);
 	addLiteralCharAndAdvance();
 	// Scan the rest of the identifier characters.
-	while (isIdentifierPart(m_char)) //get full literal
-		addLiteralCharAndAdvance();
+	size_t start = sourcePos();
+	size_t end = skipIdentifierPartRun(m_source.data(), start, m_source.size());
+	m_nextToken.literal.append(m_source.data() + start, end - start);
+	m_char = m_source.advanceTo(end);
 	literal.complete();
 	return Token::fromIdentifierOrKeyword(m_nextToken.literal);
 }
@@ -816,7 +913,16 @@ char CharStream::advanceAndGet(size_t _chars)
 	m_position += _chars;
 	if (isPastEndOfInput())
 		return 0;
-	return m_source[m_position];
+	return m_data[m_position];
+}
+
+char CharStream::advanceTo(size_t _position)
+{
+	solAssert(_position >= m_position, "");
+	m_position = min(_position, m_size);
+	if (isPastEndOfInput())
+		return 0;
+	return m_data[m_position];
 }
 
 char CharStream::rollback(size_t _amount)
@@ -830,29 +936,30 @@ string CharStream::lineAtPosition(int _position) const
 {
 	// if _position points to \n, it returns the line before the \n
 	using size_type = string::size_type;
-	size_type searchStart = min<size_type>(m_source.size(), _position);
+	string const& source = *m_source;
+	size_type searchStart = min<size_type>(source.size(), _position);
 	if (searchStart > 0)
 		searchStart--;
-	size_type lineStart = m_source.rfind('\n', searchStart);
+	size_type lineStart = source.rfind('\n', searchStart);
 	if (lineStart == string::npos)
 		lineStart = 0;
 	else
 		lineStart++;
-	return m_source.substr(lineStart, min(m_source.find('\n', lineStart),
-										  m_source.size()) - lineStart);
+	return source.substr(lineStart, min(source.find('\n', lineStart), source.size()) - lineStart);
 }
 
 tuple<int, int> CharStream::translatePositionToLineColumn(int _position) const
 {
 	using size_type = string::size_type;
-	size_type searchPosition = min<size_type>(m_source.size(), _position);
-	int lineNumber = count(m_source.begin(), m_source.begin() + searchPosition, '\n');
+	string const& source = *m_source;
+	size_type searchPosition = min<size_type>(source.size(), _position);
+	int lineNumber = count(source.begin(), source.begin() + searchPosition, '\n');
 	size_type lineStart;
 	if (searchPosition == 0)
 		lineStart = 0;
 	else
 	{
-		lineStart = m_source.rfind('\n', searchPosition - 1);
+		lineStart = source.rfind('\n', searchPosition - 1);
 		lineStart = lineStart == string::npos ? 0 : lineStart + 1;
 	}
 	return tuple<int, int>(lineNumber, searchPosition - lineStart);
@@ -67,20 +67,39 @@ class AstRawString;
 class AstValueFactory;
 class ParserRecorder;
 
+/**
+ * Character stream over an immutable source buffer. The buffer is shared, so copies of
+ * a CharStream (and of Scanners using it) do not copy the source text.
+ */
 class CharStream
 {
 public:
-	CharStream(): m_position(0) {}
-	explicit CharStream(std::string const& _source): m_source(_source), m_position(0) {}
+	CharStream(): CharStream(std::make_shared<std::string const>()) {}
+	explicit CharStream(std::string const& _source): CharStream(std::make_shared<std::string const>(_source)) {}
+	explicit CharStream(std::string&& _source): CharStream(std::make_shared<std::string const>(std::move(_source))) {}
+	explicit CharStream(std::shared_ptr<std::string const> _source):
+		m_source(std::move(_source)), m_data(m_source->data()), m_size(m_source->size()), m_position(0) {}
+
 	int position() const { return m_position; }
-	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_source.size(); }
-	char get(size_t _charsForward = 0) const { return m_source[m_position + _charsForward]; }
+	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_size; }
+	char get(size_t _charsForward = 0) const { return m_data[m_position + _charsForward]; }
 	char advanceAndGet(size_t _chars = 1);
+	/// Moves forward to the absolute position @a _position, which must not be before the
+	/// current position. @returns the character at the new position or 0 at the end of input.
+	char advanceTo(size_t _position);
 	char rollback(size_t _amount);
 
+	///@{
+	///@name Raw access for block-wise scanning
+	char const* data() const { return m_data; }
+	size_t size() const { return m_size; }
+	///@}
+
 	void reset() { m_position = 0; }
 
-	std::string const& source() const { return m_source; }
+	std::string const& source() const { return *m_source; }
+	/// @returns the shared buffer holding the source text.
+	std::shared_ptr<std::string const> const& sharedSource() const { return m_source; }
 
 	///@{
 	///@name Error printing helper functions
@@ -91,7 +110,10 @@ public:
 	///@}
 
 private:
-	std::string m_source;
+	std::shared_ptr<std::string const> m_source;
+	/// Cached pointer into and size of m_source, used on the hot scanning path.
+	char const* m_data;
+	size_t m_size;
 	size_t m_position;
 };
 
@@ -104,7 +126,8 @@ public:
 
 	explicit Scanner(CharStream const& _source = CharStream(), std::string const& _sourceName = "") { reset(_source, _sourceName); }
 
-	std::string source() const { return m_source.source(); }
+	std::string const& source() const { return m_source.source(); }
+	std::shared_ptr<std::string const> const& sharedSource() const { return m_source.sharedSource(); }
 
 	/// Resets the scanner as if newly constructed with _source and _sourceName as input.
 	void reset(CharStream const& _source, std::string const& _sourceName);
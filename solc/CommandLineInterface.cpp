@@ -106,6 +106,7 @@ static string const g_strNatspecUser = "userdoc";
 static string const g_strOpcodes = "opcodes";
 static string const g_strOptimize = "optimize";
 static string const g_strOptimizeRuns = "optimize-runs";
+static string const g_strOptimizeReport = "optimize-report";
 static string const g_strOutputDir = "output-dir";
 static string const g_strOverwrite = "overwrite";
 static string const g_strSignatureHashes = "hashes";
@@ -114,6 +115,7 @@ static string const g_strSourceList = "sourceList";
 static string const g_strSrcMap = "srcmap";
 static string const g_strSrcMapRuntime = "srcmap-runtime";
 static string const g_strStandardJSON = "standard-json";
+static string const g_strStorageLayout = "storage-layout";
 static string const g_strPrettyJson = "pretty-json";
 static string const g_strVersion = "version";
 
@@ -151,9 +153,11 @@ static string const g_argNatspecUser = g_strNatspecUser;
 static string const g_argOpcodes = g_strOpcodes;
 static string const g_argOptimize = g_strOptimize;
 static string const g_argOptimizeRuns = g_strOptimizeRuns;
+static string const g_argOptimizeReport = g_strOptimizeReport;
 static string const g_argOutputDir = g_strOutputDir;
 static string const g_argSignatureHashes = g_strSignatureHashes;
 static string const g_argStandardJSON = g_strStandardJSON;
+static string const g_argStorageLayout = g_strStorageLayout;
 static string const g_argVersion = g_strVersion;
 static string const g_stdinFileName = g_stdinFileNameStr;
 
@@ -177,7 +181,8 @@ static set<string> const g_combinedJsonArgs{
 	g_strOpcodes,
 	g_strSignatureHashes,
 	g_strSrcMap,
-	g_strSrcMapRuntime};
+	g_strSrcMapRuntime,
+	g_strStorageLayout};
 
 /// Possible arguments to for --machine
 static set<string> const g_machineArgs{
@@ -219,7 +224,9 @@ static bool needsHumanTargetedStdout(po::variables_map const &_args)
 			 g_argNatspecUser,
 			 g_argNatspecDev,
 			 g_argOpcodes,
-			 g_argSignatureHashes})
+			 g_argOptimizeReport,
+			 g_argSignatureHashes,
+			 g_argStorageLayout})
 		if (_args.count(arg))
 			return true;
 	return false;
@@ -322,6 +329,19 @@ void CommandLineInterface::handleABI(string const &_contract)
 			 << data << endl;
 }
 
+void CommandLineInterface::handleStorageLayout(string const &_contract)
+{
+	if (!m_args.count(g_argStorageLayout))
+		return;
+
+	string data = dev::jsonCompactPrint(m_compiler->storageLayout(_contract));
+	if (m_args.count(g_argOutputDir))
+		createFile(m_compiler->filesystemFriendlyName(_contract) + "_storage.json", data);
+	else
+		cout << "Contract Storage Layout:" << endl
+			 << data << endl;
+}
+
 void CommandLineInterface::handleNatspec(bool _natspecDev, string const &_contract)
 {
 	std::string argName;
@@ -532,7 +552,7 @@ Allowed options)",
 	desc.add_options()(g_argHelp.c_str(), "Show help message and exit.")(g_argVersion.c_str(), "Show version and exit.")(g_strLicense.c_str(), "Show licensing information and exit.")(g_argOptimize.c_str(), "Enable bytecode optimizer.")(
 		g_argOptimizeRuns.c_str(),
 		po::value<unsigned>()->value_name("n")->default_value(200),
-		"Estimated number of contract runs for optimizer tuning.")(g_argAddStandard.c_str(), "Add standard contracts.")(g_argPrettyJson.c_str(), "Output JSON in pretty format. Currently it only works with the combined JSON output.")(
+		"Estimated number of contract runs for optimizer tuning.")(g_argOptimizeReport.c_str(), "Per-iteration statistics of the bytecode optimizer.")(g_argAddStandard.c_str(), "Add standard contracts.")(g_argPrettyJson.c_str(), "Output JSON in pretty format. Currently it only works with the combined JSON output.")(
 		g_argLibraries.c_str(),
 		po::value<vector<string>>()->value_name("libs"),
 		"Direct string or file containing library addresses. Syntax: "
@@ -569,7 +589,7 @@ Allowed options)",
 		po::value<uint>()->value_name("price"),
 		"Specify gas price to use for Oraclize queries.");
 	po::options_description outputComponents("Output Components");
-	outputComponents.add_options()(g_argAst.c_str(), "AST of all source files.")(g_argAstJson.c_str(), "AST of all source files in JSON format.")(g_argAstCompactJson.c_str(), "AST of all source files in a compact JSON format.")(g_argAsm.c_str(), "EVM assembly of the contracts.")(g_argAsmJson.c_str(), "EVM assembly of the contracts in JSON format.")(g_argOpcodes.c_str(), "Opcodes of the contracts.")(g_argBinary.c_str(), "Binary of the contracts in hex.")(g_argBinaryRuntime.c_str(), "Binary of the runtime part of the contracts in hex.")(g_argCloneBinary.c_str(), "Binary of the clone contracts in hex.")(g_argAbi.c_str(), "ABI specification of the contracts.")(g_argSignatureHashes.c_str(), "Function signature hashes of the contracts.")(g_argNatspecUser.c_str(), "Natspec user documentation of all contracts.")(g_argNatspecDev.c_str(), "Natspec developer documentation of all contracts.")(g_argMetadata.c_str(), "Combined Metadata JSON whose Swarm hash is stored on-chain.")(g_argFormal.c_str(), "Translated source suitable for formal analysis.");
+	outputComponents.add_options()(g_argAst.c_str(), "AST of all source files.")(g_argAstJson.c_str(), "AST of all source files in JSON format.")(g_argAstCompactJson.c_str(), "AST of all source files in a compact JSON format.")(g_argAsm.c_str(), "EVM assembly of the contracts.")(g_argAsmJson.c_str(), "EVM assembly of the contracts in JSON format.")(g_argOpcodes.c_str(), "Opcodes of the contracts.")(g_argBinary.c_str(), "Binary of the contracts in hex.")(g_argBinaryRuntime.c_str(), "Binary of the runtime part of the contracts in hex.")(g_argCloneBinary.c_str(), "Binary of the clone contracts in hex.")(g_argAbi.c_str(), "ABI specification of the contracts.")(g_argSignatureHashes.c_str(), "Function signature hashes of the contracts.")(g_argNatspecUser.c_str(), "Natspec user documentation of all contracts.")(g_argNatspecDev.c_str(), "Natspec developer documentation of all contracts.")(g_argMetadata.c_str(), "Combined Metadata JSON whose Swarm hash is stored on-chain.")(g_argStorageLayout.c_str(), "Slots and offsets of the state variables of all contracts.")(g_argFormal.c_str(), "Translated source suitable for formal analysis.");
 	desc.add(outputComponents);
 
 	po::options_description allOptions = desc;
@@ -885,6 +905,8 @@ void CommandLineInterface::handleCombinedJSON()
 			contractData[g_strNatspecDev] = dev::jsonCompactPrint(m_compiler->natspecDev(contractName));
 		if (requests.count(g_strNatspecUser))
 			contractData[g_strNatspecUser] = dev::jsonCompactPrint(m_compiler->natspecUser(contractName));
+		if (requests.count(g_strStorageLayout))
+			contractData[g_strStorageLayout] = dev::jsonCompactPrint(m_compiler->storageLayout(contractName));
 	}
 
 	bool needsSourceList = requests.count(g_strAst) || requests.count(g_strSrcMap) || requests.count(g_strSrcMapRuntime);
@@ -1177,6 +1199,15 @@ void CommandLineInterface::outputCompilationResults()
 			}
 		}
 
+		if (m_args.count(g_argOptimizeReport))
+		{
+			string report = m_compiler->optimiserReport(contract);
+			if (m_args.count(g_argOutputDir))
+				createFile(m_compiler->filesystemFriendlyName(contract) + ".optreport", report);
+			else
+				cout << "Optimizer report:" << endl << report << endl;
+		}
+
 		if (m_args.count(g_argGas))
 			handleGasEstimation(contract);
 
@@ -1186,6 +1217,7 @@ void CommandLineInterface::outputCompilationResults()
 		handleABI(contract);
 		handleNatspec(true, contract);
 		handleNatspec(false, contract);
+		handleStorageLayout(contract);
 	} // end of contracts iteration
 
 	if (m_args.count(g_argFormal))
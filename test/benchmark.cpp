@@ -0,0 +1,337 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Micro-benchmarks for individual compiler components.
+ */
+
+#include <libsolidity/parsing/Parser.h>
+#include <libsolidity/parsing/Scanner.h>
+#include <libsolidity/ast/ASTStringTable.h>
+#include <libsolidity/interface/CompilerStack.h>
+#include <libsolidity/interface/ErrorReporter.h>
+#include <libsolidity/interface/GasEstimator.h>
+#include <libsolidity/codegen/InlineAssemblyCache.h>
+#include <libsolidity/codegen/ABIRoutineStore.h>
+#include <libsolidity/codegen/ABIFunctions.h>
+#include <libsolidity/ast/TypeProvider.h>
+#include <libevmasm/AssemblyItem.h>
+#include <libdevcore/CommonIO.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <string>
+#include <iostream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+namespace po = boost::program_options;
+
+namespace
+{
+
+using Sources = map<string, shared_ptr<string const>>;
+
+/// Reads all ".sol" files given directly or found below the given directories, keyed by their path.
+Sources readSources(vector<string> const& _paths)
+{
+	Sources sources;
+	auto add = [&](boost::filesystem::path const& _file)
+	{
+		if (_file.extension() == ".sol")
+			sources[_file.generic_string()] = make_shared<string const>(readFileAsString(_file.string()));
+	};
+	for (string const& path: _paths)
+		if (boost::filesystem::is_directory(path))
+		{
+			for (auto it = boost::filesystem::recursive_directory_iterator(path); it != boost::filesystem::recursive_directory_iterator(); ++it)
+				if (boost::filesystem::is_regular_file(it->path()))
+					add(it->path());
+		}
+		else
+			add(path);
+	return sources;
+}
+
+template <class F>
+double measureSeconds(unsigned _repetitions, F const& _f)
+{
+	auto start = chrono::steady_clock::now();
+	for (unsigned i = 0; i < _repetitions; ++i)
+		_f();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkScanner(Sources const& _sources, unsigned _repetitions)
+{
+	size_t bytes = 0;
+	for (auto const& source: _sources)
+		bytes += source.second->size();
+
+	size_t tokens = 0;
+	double seconds = measureSeconds(_repetitions, [&]()
+	{
+		for (auto const& source: _sources)
+		{
+			Scanner scanner{CharStream(source.second)};
+			while (scanner.currentToken() != Token::EOS)
+			{
+				scanner.next();
+				++tokens;
+			}
+		}
+	});
+
+	cout << "Scanner: " << _sources.size() << " sources, " << bytes << " bytes, " << _repetitions << " repetitions" << endl;
+	cout << "  " << size_t(tokens / seconds) << " tokens/s, " << (bytes * _repetitions / seconds / 1e6) << " MB/s" << endl;
+}
+
+void benchmarkParser(Sources const& _sources, unsigned _repetitions)
+{
+	size_t nodes = 0;
+	size_t nodeBytes = 0;
+	size_t arenaBytes = 0;
+	double seconds = measureSeconds(_repetitions, [&]()
+	{
+		nodes = 0;
+		nodeBytes = 0;
+		arenaBytes = 0;
+		for (auto const& source: _sources)
+		{
+			ErrorList errors;
+			ErrorReporter errorReporter(errors);
+			auto sourceUnit = Parser(errorReporter).parse(make_shared<Scanner>(CharStream(source.second)));
+			if (sourceUnit && sourceUnit->arena())
+			{
+				nodes += sourceUnit->arena()->allocationCount();
+				nodeBytes += sourceUnit->arena()->allocatedBytes();
+				arenaBytes += sourceUnit->arena()->reservedBytes();
+			}
+		}
+	});
+
+	cout << "Parser: " << _sources.size() << " sources, " << _repetitions << " repetitions" << endl;
+	cout << "  " << (seconds / _repetitions * 1000) << " ms per pass" << endl;
+	cout << "  " << nodes << " nodes in arenas, " << nodeBytes << " bytes used, " << arenaBytes << " bytes reserved" << endl;
+}
+
+void benchmarkAnalysis(Sources const& _sources, unsigned _repetitions)
+{
+	CompilerStack compiler;
+	bool success = false;
+	double seconds = measureSeconds(_repetitions, [&]()
+	{
+		compiler.reset();
+		for (auto const& source: _sources)
+			compiler.addSource(source.first, source.second);
+		success = compiler.parseAndAnalyze();
+	});
+
+	cout << "Analysis: " << _sources.size() << " sources, " << _repetitions << " repetitions";
+	cout << (success ? "" : " (with errors)") << endl;
+	cout << "  " << (seconds / _repetitions * 1000) << " ms per pass (parsing and analysis)" << endl;
+	if (compiler.state() >= CompilerStack::ParsingSuccessful)
+	{
+		ASTStringTable const& strings = compiler.astStrings();
+		cout << "  " << strings.lookups() << " identifiers and literals, " << strings.size() << " distinct, ";
+		cout << strings.characters() << " characters interned" << endl;
+	}
+}
+
+
+/// @returns the peak resident set size of the process in kilobytes.
+long peakMemoryKB()
+{
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+void benchmarkOptimiser(Sources const& _sources, unsigned _repetitions)
+{
+	CompilerStack compiler;
+	bool success = false;
+	auto compile = [&](bool _optimize)
+	{
+		compiler.reset();
+		for (auto const& source: _sources)
+			compiler.addSource(source.first, source.second);
+		compiler.setOptimiserSettings(_optimize);
+		success = compiler.compile();
+	};
+	double secondsWithout = measureSeconds(_repetitions, [&]() { compile(false); });
+	long memoryWithout = peakMemoryKB();
+	double secondsWith = measureSeconds(_repetitions, [&]() { compile(true); });
+
+	cout << "Optimiser: " << _sources.size() << " sources, " << _repetitions << " repetitions";
+	cout << (success ? "" : " (with errors)") << endl;
+	cout << "  " << (secondsWithout / _repetitions * 1000) << " ms per pass without optimiser, ";
+	cout << (secondsWith / _repetitions * 1000) << " ms per pass with optimiser" << endl;
+	cout << "  " << ((secondsWith - secondsWithout) / _repetitions * 1000) << " ms per pass spent in the optimiser" << endl;
+	cout << "  peak memory " << memoryWithout << " KB without optimiser, " << peakMemoryKB() << " KB with optimiser" << endl;
+	if (success)
+	{
+		eth::AssemblyItemTables const& itemTables = compiler.assemblyItemTables();
+		cout << "  " << itemTables.constantCount() << " pooled constants, ";
+		cout << itemTables.locationCount() << " interned source locations" << endl;
+		InlineAssemblyCache const& inlineAssembly = compiler.inlineAssemblyCache();
+		cout << "  " << inlineAssembly.routines() << " generated assembly routines parsed, ";
+		cout << inlineAssembly.reuses() << " reused (" << inlineAssembly.charactersReused() << " characters not parsed again)" << endl;
+		ABIRoutineStore const& abiRoutines = compiler.abiRoutineStore();
+		cout << "  " << abiRoutines.routines() << " ABI coding routines generated, ";
+		cout << abiRoutines.reuses() << " reused" << endl;
+	}
+}
+
+
+void benchmarkDispatch()
+{
+	for (unsigned functions: {5, 20, 100})
+	{
+		string source = "pragma solidity >=0.0;\ncontract C {\n";
+		for (unsigned i = 0; i < functions; ++i)
+			source += "\tfunction f" + to_string(i) + "() returns (uint) { return " + to_string(i) + "; }\n";
+		source += "}\n";
+
+		CompilerStack compiler;
+		compiler.addSource("", source);
+		compiler.setOptimiserSettings(true);
+		if (!compiler.compile())
+		{
+			cout << "Dispatch: " << functions << " functions (with errors)" << endl;
+			continue;
+		}
+
+		u256 minGas = u256(-1);
+		u256 maxGas = 0;
+		u256 totalGas = 0;
+		for (unsigned i = 0; i < functions; ++i)
+		{
+			GasEstimator::GasConsumption gas = GasEstimator::functionalEstimation(
+				*compiler.runtimeAssemblyItems("C"),
+				"f" + to_string(i) + "()"
+			);
+			minGas = min(minGas, gas.value);
+			maxGas = max(maxGas, gas.value);
+			totalGas += gas.value;
+		}
+
+		cout << "Dispatch: " << functions << " functions, ";
+		cout << compiler.runtimeObject("C").bytecode.size() << " bytes runtime code" << endl;
+		cout << "  gas per call: " << minGas << " min, " << (totalGas / functions) << " average, " << maxGas << " max" << endl;
+	}
+}
+
+void benchmarkWhiskers(unsigned _repetitions)
+{
+	TypePointer uint8Array = TypeProvider::array(DataLocation::Memory, TypeProvider::integer(8, IntegerType::Modifier::Unsigned));
+	TypePointer uintArray = TypeProvider::array(DataLocation::Memory, TypeProvider::uint256());
+	TypePointers types{
+		TypeProvider::uint256(),
+		TypeProvider::address(),
+		TypeProvider::boolean(),
+		TypeProvider::fixedBytes(32),
+		TypeProvider::bytesMemory(),
+		TypeProvider::stringMemory(),
+		uint8Array,
+		TypeProvider::array(DataLocation::Memory, uintArray)
+	};
+	size_t characters = 0;
+	// A new ABIFunctions object per pass, since it would otherwise return the functions it already generated.
+	double seconds = measureSeconds(_repetitions, [&]()
+	{
+		ABIFunctions abi;
+		for (size_t i = 0; i < types.size(); ++i)
+		{
+			TypePointers prefix(types.begin(), types.begin() + i + 1);
+			abi.tupleEncoder(prefix, prefix);
+			abi.tupleDecoder(prefix, false);
+			abi.tupleDecoder(prefix, true);
+		}
+		characters = abi.requestedFunctions().size();
+	});
+
+	cout << "Whiskers: ABI coder routines for " << types.size() << " types, " << _repetitions << " repetitions" << endl;
+	cout << "  " << (seconds / _repetitions * 1000) << " ms per pass, " << characters << " characters generated per pass" << endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+	po::options_description options(
+		R"(solbench, micro-benchmarks for compiler components.
+Usage: solbench [Options] path...
+Paths can be source files or directories, which are searched for ".sol" files.
+
+Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		("help", "Show this help screen.")
+		("scanner", "Measure scanner throughput over the input sources.")
+		("parser", "Measure the time it takes to parse the input sources.")
+		("analysis", "Measure the time it takes to parse and analyze the input sources as one compilation.")
+		("optimiser", "Measure the time and memory it takes to compile the input sources with and without optimiser.")
+		("dispatch", "Measure the gas a call spends in the function selector of contracts with 5, 20 and 100 functions.")
+		("whiskers", "Measure the time it takes to generate the ABI coder routines from their templates.")
+		("repetitions", po::value<unsigned>()->default_value(100), "Number of passes over the input.")
+		("input", po::value<vector<string>>(), "Input paths.");
+	po::positional_options_description positional;
+	positional.add("input", -1);
+
+	po::variables_map arguments;
+	try
+	{
+		po::command_line_parser cmdLineParser(argc, argv);
+		cmdLineParser.options(options).positional(positional);
+		po::store(cmdLineParser.run(), arguments);
+	}
+	catch (po::error const& _exception)
+	{
+		cerr << _exception.what() << endl;
+		return 1;
+	}
+
+	if (arguments.count("help") || (!arguments.count("input") && !arguments.count("dispatch") && !arguments.count("whiskers")))
+	{
+		cout << options;
+		return 0;
+	}
+	unsigned repetitions = arguments["repetitions"].as<unsigned>();
+	if (arguments.count("dispatch"))
+		benchmarkDispatch();
+	if (arguments.count("whiskers"))
+		benchmarkWhiskers(repetitions);
+	if (!arguments.count("input"))
+		return 0;
+
+	auto sources = readSources(arguments["input"].as<vector<string>>());
+	if (arguments.count("scanner"))
+		benchmarkScanner(sources, repetitions);
+	if (arguments.count("parser"))
+		benchmarkParser(sources, repetitions);
+	if (arguments.count("analysis"))
+		benchmarkAnalysis(sources, repetitions);
+	if (arguments.count("optimiser"))
+		benchmarkOptimiser(sources, repetitions);
+
+	return 0;
+}
@@ -121,6 +121,27 @@ BOOST_AUTO_TEST_CASE(parameter_collision)
 	BOOST_CHECK_THROW(m.render(), WhiskersError);
 }
 
+BOOST_AUTO_TEST_CASE(incomplete_tags)
+{
+	string templ = "<> </a> <a/> <#b> <#> <c#> <e>";
+	string result = Whiskers(templ)("e", "E").render();
+	BOOST_CHECK_EQUAL(result, "<> </a> <a/> <#b> <#> <c#> E");
+}
+
+BOOST_AUTO_TEST_CASE(template_reuse)
+{
+	string templ = "<a><#b>[<c>]</b>";
+	vector<map<string, string>> list(1);
+	list[0]["c"] = "C";
+	BOOST_CHECK_EQUAL(Whiskers(templ)("a", "A")("b", list).render(), "A[C]");
+	list.resize(2);
+	list[1]["c"] = "D";
+	BOOST_CHECK_EQUAL(Whiskers(templ)("a", "X")("b", list).render(), "X[C][D]");
+	Whiskers withoutList(templ);
+	withoutList("a", "A");
+	BOOST_CHECK_THROW(withoutList.render(), WhiskersError);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -0,0 +1,109 @@
+/*
+    This file is part of solidity.
+
+    solidity is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    solidity is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the AssemblyItem class.
+ */
+
+#include <libevmasm/Assembly.h>
+#include <libevmasm/AssemblyItem.h>
+
+#include "../TestHelper.h"
+
+using namespace std;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(AssemblyItemTest)
+
+BOOST_AUTO_TEST_CASE(data_round_trip)
+{
+	vector<u256> values{0, 1, u256(-1) >> 192, (u256(-1) >> 192) + 1, u256(1) << 255, u256(-1)};
+	for (u256 const& value: values)
+	{
+		AssemblyItem item(value);
+		BOOST_CHECK_EQUAL(item.data(), value);
+		item.setData(value + 1);
+		BOOST_CHECK_EQUAL(item.data(), value + 1);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(comparison)
+{
+	u256 small = 7;
+	u256 wide = (u256(1) << 200) + 7;
+	BOOST_CHECK(AssemblyItem(wide) == AssemblyItem(wide));
+	BOOST_CHECK(AssemblyItem(wide) != AssemblyItem(wide + 1));
+	BOOST_CHECK(AssemblyItem(small) != AssemblyItem(wide));
+	BOOST_CHECK(AssemblyItem(small) < AssemblyItem(wide));
+	BOOST_CHECK(!(AssemblyItem(wide) < AssemblyItem(small)));
+	BOOST_CHECK(AssemblyItem(wide) < AssemblyItem(wide + 1));
+	BOOST_CHECK(!(AssemblyItem(wide) < AssemblyItem(wide)));
+	BOOST_CHECK(AssemblyItem(PushTag, small) != AssemblyItem(Push, small));
+}
+
+BOOST_AUTO_TEST_CASE(locations)
+{
+	SourceLocation location(3, 7, make_shared<string>("source"));
+	AssemblyItem item(Instruction::ADD, location);
+	BOOST_CHECK(item.location() == location);
+	BOOST_CHECK(AssemblyItem(Instruction::ADD).location().isEmpty());
+	// Locations are interned by contents, not by the identity of the source name.
+	AssemblyItem other(Instruction::MUL, SourceLocation(3, 7, make_shared<string>("source")));
+	BOOST_CHECK_EQUAL(&other.location(), &item.location());
+	item.setLocation(SourceLocation(3, 8, location.sourceName));
+	BOOST_CHECK(item.location() == SourceLocation(3, 8, location.sourceName));
+	BOOST_CHECK(other.location() == location);
+}
+
+BOOST_AUTO_TEST_CASE(tables)
+{
+	u256 wide = (u256(1) << 200) + 7;
+	AssemblyItem outside(wide);
+	weak_ptr<AssemblyItemTables> released;
+	{
+		shared_ptr<Assembly> assembly;
+		{
+			auto tables = make_shared<AssemblyItemTables>();
+			released = tables;
+			AssemblyItemTables::Scope scope(tables);
+			assembly = make_shared<Assembly>();
+			assembly->append(AssemblyItem(wide, SourceLocation(3, 7, make_shared<string>("source"))));
+			BOOST_CHECK_EQUAL(tables->constantCount(), 1);
+			BOOST_CHECK_EQUAL(tables->locationCount(), 1);
+		}
+		// The assembly keeps the tables of its items alive.
+		BOOST_REQUIRE(!released.expired());
+		AssemblyItem const& item = assembly->items().front();
+		BOOST_CHECK_EQUAL(item.location().start, 3);
+		// Equal values from different tables are equal items.
+		BOOST_CHECK(item == outside);
+		BOOST_CHECK_EQUAL(item.hash(), outside.hash());
+	}
+	BOOST_CHECK(released.expired());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
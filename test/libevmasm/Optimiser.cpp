@@ -25,6 +25,8 @@
 #include <libevmasm/JumpdestRemover.h>
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/BlockDeduplicator.h>
+#include <libevmasm/ConstantOptimiser.h>
+#include <libevmasm/Inliner.h>
 #include <libevmasm/Assembly.h>
 
 #include <boost/test/unit_test.hpp>
@@ -645,6 +647,27 @@ BOOST_AUTO_TEST_CASE(cse_access_previous_sequence)
 	// 0, SLOAD, 1, ADD, SSTORE, 0 SLOAD
 }
 
+BOOST_AUTO_TEST_CASE(cse_counts_rule_hits)
+{
+	AssemblyItems input{u256(2), u256(3), Instruction::ADD, Instruction::CALLVALUE, Instruction::MUL};
+	map<size_t, size_t> ruleHits;
+	eth::KnownState emptyState;
+	eth::CommonSubexpressionEliminator cse(emptyState, &ruleHits);
+	cse.feedItems(input.begin(), input.end());
+	cse.getOptimizedItems();
+	size_t hits = 0;
+	for (auto const& rule: ruleHits)
+		hits += rule.second;
+	BOOST_CHECK_EQUAL(hits, 1);
+	// Eliminators without a counter do not count.
+	eth::KnownState otherState;
+	eth::CommonSubexpressionEliminator other(otherState);
+	other.feedItems(input.begin(), input.end());
+	other.getOptimizedItems();
+	BOOST_CHECK_EQUAL(ruleHits.size(), 1);
+	BOOST_CHECK_EQUAL(ruleHits.begin()->second, 1);
+}
+
 BOOST_AUTO_TEST_CASE(cse_optimise_return)
 {
 	checkCSE(
@@ -653,6 +676,27 @@ BOOST_AUTO_TEST_CASE(cse_optimise_return)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(known_state_copy_is_independent)
+{
+	eth::KnownState state = createInitialState(AssemblyItems{
+		u256(5),
+		u256(0),
+		Instruction::SSTORE
+	});
+	auto copy = state.copy();
+	// Storing at an unknown slot destroys the knowledge about slot zero, but only in the copy.
+	for (auto const& item: addDummyLocations({Instruction::CALLVALUE, Instruction::CALLER, Instruction::SSTORE}))
+		copy->feedItem(item, true);
+	BOOST_CHECK_EQUAL(state.storageContent().size(), 1);
+	BOOST_CHECK(copy->storageContent() != state.storageContent());
+
+	AssemblyItems input{u256(0), Instruction::SLOAD};
+	AssemblyItems fromState = CSE(input, state);
+	BOOST_CHECK(find(fromState.begin(), fromState.end(), AssemblyItem(Instruction::SLOAD)) == fromState.end());
+	AssemblyItems fromCopy = CSE(input, *copy);
+	BOOST_CHECK(find(fromCopy.begin(), fromCopy.end(), AssemblyItem(Instruction::SLOAD)) != fromCopy.end());
+}
+
 BOOST_AUTO_TEST_CASE(control_flow_graph_remove_unused)
 {
 	// remove parts of the code that are unused
@@ -781,6 +825,41 @@ BOOST_AUTO_TEST_CASE(block_deduplicator_loops)
 	BOOST_CHECK_EQUAL(pushTags.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(block_deduplicator_fallthrough)
+{
+	// Blocks continue after JUMPI and across tags, so tags 1 and 2 only differ in
+	// the code following tag 3 and tag 4, respectively.
+	AssemblyItems input{
+		AssemblyItem(PushTag, 1),
+		AssemblyItem(PushTag, 2),
+		AssemblyItem(PushTag, 5),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		u256(7),
+		AssemblyItem(PushTag, 5),
+		Instruction::JUMPI,
+		AssemblyItem(Tag, 3),
+		u256(8),
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		u256(7),
+		AssemblyItem(PushTag, 5),
+		Instruction::JUMPI,
+		AssemblyItem(Tag, 4),
+		u256(9),
+		Instruction::STOP,
+		AssemblyItem(Tag, 5)
+	};
+	BlockDeduplicator dedup(input);
+	BOOST_CHECK(!dedup.deduplicate());
+
+	// Making the tails equal allows both blocks to be unified.
+	input[16] = u256(8);
+	BOOST_CHECK(dedup.deduplicate());
+	BOOST_CHECK_EQUAL(dedup.replacedTags().at(2), 1);
+	BOOST_CHECK_EQUAL(dedup.replacedTags().at(4), 3);
+}
+
 BOOST_AUTO_TEST_CASE(clear_unreachable_code)
 {
 	AssemblyItems items{
@@ -849,10 +928,83 @@ BOOST_AUTO_TEST_CASE(peephole_pop_calldatasize)
 		Instruction::LT,
 		Instruction::POP
 	};
+	// All three rewrites are performed in a single run.
 	PeepholeOptimiser peepOpt(items);
-	for (size_t i = 0; i < 3; i++)
-		BOOST_CHECK(peepOpt.optimise());
+	BOOST_CHECK(peepOpt.optimise());
 	BOOST_CHECK(items.empty());
+	BOOST_CHECK(!peepOpt.optimise());
+}
+
+BOOST_AUTO_TEST_CASE(peephole_pop_addmod)
+{
+	AssemblyItems items{
+		Instruction::CALLVALUE,
+		Instruction::CALLVALUE,
+		Instruction::CALLVALUE,
+		Instruction::ADDMOD,
+		Instruction::POP
+	};
+	AssemblyItems original = items;
+	// Replacing ADDMOD POP by three POPs would make the code bigger.
+	PeepholeOptimiser peepOpt(items);
+	BOOST_CHECK(!peepOpt.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(items.begin(), items.end(), original.begin(), original.end());
+}
+
+BOOST_AUTO_TEST_CASE(peephole_backtracking)
+{
+	AssemblyItems items{
+		Instruction::CALLVALUE,
+		u256(1),
+		u256(2),
+		Instruction::ADD,
+		Instruction::POP,
+		Instruction::SWAP1,
+		Instruction::SWAP1
+	};
+	AssemblyItems expectation{
+		Instruction::CALLVALUE
+	};
+	PeepholeOptimiser peepOpt(items);
+	BOOST_REQUIRE(peepOpt.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(peephole_custom_rule)
+{
+	PeepholeRules rules;
+	rules.add(PeepholeRule{
+		"DoubleNot",
+		2,
+		[](AssemblyItem const& _item) { return _item == Instruction::NOT; },
+		[](AssemblyItems::const_iterator _in, AssemblyItems::const_iterator _end, AssemblyItems&) -> size_t
+		{
+			return (_end - _in >= 2 && _in[1] == Instruction::NOT) ? 2 : 0;
+		}
+	});
+	AssemblyItems items{
+		Instruction::CALLVALUE,
+		Instruction::NOT,
+		Instruction::NOT,
+		Instruction::NOT,
+		u256(2),
+		Instruction::POP
+	};
+	AssemblyItems expectation{
+		Instruction::CALLVALUE,
+		Instruction::NOT,
+		u256(2),
+		Instruction::POP
+	};
+	PeepholeOptimiser peepOpt(items, rules);
+	BOOST_REQUIRE(peepOpt.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
 }
 
 BOOST_AUTO_TEST_CASE(jumpdest_removal)
@@ -938,6 +1090,138 @@ BOOST_AUTO_TEST_CASE(jumpdest_removal_subassemblies)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(inliner)
+{
+	AssemblyItem jumpInto(Instruction::JUMP);
+	jumpInto.setJumpType(AssemblyItem::JumpType::IntoFunction);
+	AssemblyItem jumpOutOf(Instruction::JUMP);
+	jumpOutOf.setJumpType(AssemblyItem::JumpType::OutOfFunction);
+	AssemblyItems items{
+		AssemblyItem(PushTag, 1),
+		u256(7),
+		AssemblyItem(PushTag, 2),
+		jumpInto,
+		AssemblyItem(Tag, 1),
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		u256(1),
+		Instruction::ADD,
+		Instruction::SWAP1,
+		jumpOutOf
+	};
+	AssemblyItems expectation{
+		AssemblyItem(PushTag, 1),
+		u256(7),
+		u256(1),
+		Instruction::ADD,
+		Instruction::SWAP1,
+		Instruction::POP,
+		AssemblyItem(Tag, 1),
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		u256(1),
+		Instruction::ADD,
+		Instruction::SWAP1,
+		jumpOutOf
+	};
+	Inliner inliner(items, 200, false);
+	BOOST_REQUIRE(inliner.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(inliner_return_address_mismatch)
+{
+	AssemblyItem jumpInto(Instruction::JUMP);
+	jumpInto.setJumpType(AssemblyItem::JumpType::IntoFunction);
+	AssemblyItem jumpOutOf(Instruction::JUMP);
+	jumpOutOf.setJumpType(AssemblyItem::JumpType::OutOfFunction);
+	// The function jumps to the slot below its single argument, but the caller passes two.
+	AssemblyItems items{
+		AssemblyItem(PushTag, 1),
+		u256(7),
+		u256(8),
+		AssemblyItem(PushTag, 2),
+		jumpInto,
+		AssemblyItem(Tag, 1),
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		u256(1),
+		Instruction::ADD,
+		Instruction::SWAP1,
+		jumpOutOf
+	};
+	AssemblyItems original = items;
+	Inliner inliner(items, 200, false);
+	BOOST_CHECK(!inliner.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		original.begin(), original.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(optimiser_statistics)
+{
+	Assembly main;
+	AssemblyPointer sub = make_shared<Assembly>();
+	auto t1 = sub->newTag();
+	sub->append(t1);
+	sub->append(u256(2));
+	sub->append(u256(3));
+	sub->append(Instruction::ADD);
+	sub->append(t1.pushTag());
+	sub->append(Instruction::JUMP);
+	auto t2 = sub->newTag();
+	sub->append(t2); // Unreferenced, will be removed.
+	sub->append(Instruction::STOP);
+	main.appendSubroutine(sub);
+	main.append(u256(8));
+
+	main.optimise(true);
+
+	auto const& iterations = sub->optimiserIterations();
+	BOOST_REQUIRE(iterations.size() >= 2);
+	BOOST_CHECK_EQUAL(iterations.front().itemsBefore, 8);
+	BOOST_CHECK(iterations.front().changes > 0);
+	BOOST_CHECK_EQUAL(iterations.back().changes, 0);
+	BOOST_CHECK_EQUAL(iterations.back().itemsAfter, sub->items().size());
+	// Chunks that did not change since the previous sweep are not analysed again.
+	BOOST_CHECK(iterations.back().cseChunksReused > 0);
+	// "2 3 ADD" is folded by a simplification rule.
+	BOOST_CHECK(!iterations.front().simplifications.empty());
+	string report = main.optimiserReport();
+	BOOST_CHECK(report.find("sub 0:") != string::npos);
+	BOOST_CHECK(report.find("simplification rules applied:") != string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(constant_optimiser_repeated)
+{
+	// The second run uses the cached representations and has to produce the same code,
+	// including the data for the copied constant.
+	u256 copied("0x1e2c8a7b3f4d5e6f708192a3b4c5d6e7f8091a2b3c4d5e6f708192a3b4c5d6e7");
+	u256 computed = ~u256(0xff);
+	AssemblyItems items;
+	for (unsigned i = 0; i < 10; ++i)
+		items.push_back(copied);
+	items.push_back(computed);
+	AssemblyItems results[2];
+	for (auto& result: results)
+	{
+		Assembly assembly;
+		result = items;
+		BOOST_CHECK_EQUAL(ConstantOptimisationMethod::optimiseConstants(false, 1, assembly, result), 2);
+		auto data = find_if(result.begin(), result.end(), [](AssemblyItem const& _item) { return _item.type() == PushData; });
+		BOOST_REQUIRE(data != result.end());
+		BOOST_CHECK(assembly.data(h256(data->data())) == toBigEndian(copied));
+	}
+	BOOST_CHECK_EQUAL_COLLECTIONS(results[0].begin(), results[0].end(), results[1].begin(), results[1].end());
+	AssemblyItems computation{u256(0xff), Instruction::NOT};
+	BOOST_CHECK(search(results[0].begin(), results[0].end(), computation.begin(), computation.end()) != results[0].end());
+	BOOST_CHECK(find(results[0].begin(), results[0].end(), AssemblyItem(computed)) == results[0].end());
+}
+
 BOOST_AUTO_TEST_CASE(cse_sub_zero)
 {
 	checkCSE({
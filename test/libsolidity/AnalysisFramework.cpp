@@ -44,6 +44,7 @@ AnalysisFramework::parseAnalyseAndReturnError(
 	bool _allowMultipleErrors
 )
 {
+	m_typeScope.reset();
 	m_compiler.reset();
 	m_compiler.addSource("", _insertVersionPragma ? "pragma solidity >=0.0;\n" + _source : _source);
 	if (!m_compiler.parse())
@@ -51,7 +52,8 @@ AnalysisFramework::parseAnalyseAndReturnError(
 		BOOST_ERROR("Parsing contract failed in analysis test suite:" + formatErrors());
 	}
 
-	m_compiler.analyze();
+	if (m_compiler.analyze())
+		m_typeScope.reset(new TypeProvider::Scope(m_compiler.typeProvider()));
 
 	std::shared_ptr<Error const> firstError;
 	for (auto const& currentError: m_compiler.errors())
@@ -23,6 +23,7 @@
 #include <test/libsolidity/ErrorCheck.h>
 
 #include <libsolidity/interface/CompilerStack.h>
+#include <libsolidity/ast/TypeProvider.h>
 
 #include <functional>
 #include <string>
@@ -68,6 +69,8 @@ protected:
 
 	std::vector<std::string> m_warningsToFilter = {"This is a pre-release compiler version"};
 	dev::solidity::CompilerStack m_compiler;
+	/// Makes the types of the last successfully analysed source unit available to the test.
+	std::unique_ptr<TypeProvider::Scope> m_typeScope;
 };
 
 
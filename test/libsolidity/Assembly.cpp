@@ -28,8 +28,13 @@
 #include <libsolidity/parsing/Scanner.h>
 #include <libsolidity/parsing/Parser.h>
 #include <libsolidity/analysis/NameAndTypeResolver.h>
+#include <libsolidity/analysis/SyntaxChecker.h>
 #include <libsolidity/codegen/Compiler.h>
+#include <libsolidity/codegen/InlineAssemblyCache.h>
+#include <libsolidity/codegen/ABIRoutineStore.h>
+#include <libsolidity/interface/CompilerStack.h>
 #include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/TypeProvider.h>
 #include <libsolidity/analysis/TypeChecker.h>
 #include <libsolidity/interface/ErrorReporter.h>
 
@@ -46,14 +51,20 @@ namespace test
 namespace
 {
 
-eth::AssemblyItems compileContract(const string& _sourceCode)
+eth::AssemblyItems compileContract(
+	const string& _sourceCode,
+	shared_ptr<ABIRoutineStore> const& _abiRoutineStore = nullptr
+)
 {
+	TypeProvider typeProvider;
+	TypeProvider::Scope typeScope(typeProvider);
 	ErrorList errors;
 	ErrorReporter errorReporter(errors);
 	Parser parser(errorReporter);
 	ASTPointer<SourceUnit> sourceUnit;
 	BOOST_REQUIRE_NO_THROW(sourceUnit = parser.parse(make_shared<Scanner>(CharStream(_sourceCode))));
 	BOOST_CHECK(!!sourceUnit);
+	BOOST_REQUIRE(SyntaxChecker(errorReporter).checkSyntax(*sourceUnit));
 
 	map<ASTNode const*, shared_ptr<DeclarationContainer>> scopes;
 	NameAndTypeResolver resolver({}, scopes, errorReporter);
@@ -77,7 +88,7 @@ eth::AssemblyItems compileContract(const string& _sourceCode)
 	for (ASTPointer<ASTNode> const& node: sourceUnit->nodes())
 		if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
 		{
-			Compiler compiler;
+			Compiler compiler(false, 200, nullptr, _abiRoutineStore);
 			compiler.compileContract(*contract, map<ContractDefinition const*, Assembly const*>{}, bytes());
 
 			return compiler.runtimeAssemblyItems();
@@ -127,6 +138,75 @@ BOOST_AUTO_TEST_CASE(location_test)
 	checkAssemblyLocations(items, locations);
 }
 
+BOOST_AUTO_TEST_CASE(inline_assembly_cache)
+{
+	// Both contracts request the same ABI coding routines, which are parsed only once.
+	char const* sourceCode = R"(
+		pragma solidity >=0.0;
+		pragma experimental ABIEncoderV2;
+		contract C {
+			function f(uint[] x, string y) public returns (uint[], string) { return (x, y); }
+		}
+		contract D {
+			function g(uint[] x, string y) public returns (uint[], string) { return (x, y); }
+		}
+	)";
+	CompilerStack compiler;
+	compiler.addSource("", sourceCode);
+	BOOST_REQUIRE(compiler.compile());
+	InlineAssemblyCache const& cache = compiler.inlineAssemblyCache();
+	BOOST_CHECK_EQUAL(cache.routines(), 1);
+	BOOST_CHECK(cache.reuses() >= 1);
+	BOOST_CHECK(cache.charactersReused() > 0);
+	BOOST_CHECK(
+		compiler.runtimeAssemblyItems("C")->size() ==
+		compiler.runtimeAssemblyItems("D")->size()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(abi_routine_store)
+{
+	// The contracts request different encoders and decoders, which share the routines for
+	// the uint array.
+	char const* sourceCode = R"(
+		pragma solidity >=0.0;
+		pragma experimental ABIEncoderV2;
+		contract C {
+			function f(uint[] x) public returns (uint[]) { return x; }
+		}
+		contract D {
+			function g(uint[] x, string y) public returns (uint[], string) { return (x, y); }
+		}
+	)";
+	CompilerStack compiler;
+	compiler.addSource("", sourceCode);
+	BOOST_REQUIRE(compiler.compile());
+	ABIRoutineStore const& store = compiler.abiRoutineStore();
+	BOOST_CHECK(store.routines() > 0);
+	BOOST_CHECK(store.reuses() > 0);
+	// The inline assembly blocks differ, so they do not share the cache.
+	BOOST_CHECK_EQUAL(compiler.inlineAssemblyCache().routines(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(abi_routine_store_locations)
+{
+	// Routines from the store are located as if the block of all requested routines was parsed,
+	// also if they were generated for another contract.
+	char const* sourceCode = R"(
+		pragma experimental ABIEncoderV2;
+		contract C {
+			function f(uint[] x, string y) public returns (uint[], string) { return (x, y); }
+		}
+	)";
+	vector<SourceLocation> locations;
+	for (AssemblyItem const& item: compileContract(sourceCode))
+		locations.push_back(item.location());
+	auto store = make_shared<ABIRoutineStore>();
+	checkAssemblyLocations(compileContract(sourceCode, store), locations);
+	checkAssemblyLocations(compileContract(sourceCode, store), locations);
+	BOOST_CHECK(store->reuses() > 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
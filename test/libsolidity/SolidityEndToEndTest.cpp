@@ -324,6 +324,41 @@ BOOST_AUTO_TEST_CASE(multiple_functions)
 	ABI_CHECK(callContractFunction("i_am_not_there()", bytes()), bytes());
 }
 
+BOOST_AUTO_TEST_CASE(many_functions)
+{
+	// Enough functions for the selector to be split into a binary search.
+	char const* sourceCode = R"(
+		contract test {
+			function f0() returns(uint n) { return 0; }
+			function f1() returns(uint n) { return 1; }
+			function f2() returns(uint n) { return 2; }
+			function f3() returns(uint n) { return 3; }
+			function f4() returns(uint n) { return 4; }
+			function f5() returns(uint n) { return 5; }
+			function f6() returns(uint n) { return 6; }
+			function f7() returns(uint n) { return 7; }
+			function f8() returns(uint n) { return 8; }
+			function f9() returns(uint n) { return 9; }
+			function f10() returns(uint n) { return 10; }
+			function f11() returns(uint n) { return 11; }
+			function f12() returns(uint n) { return 12; }
+			function f13() returns(uint n) { return 13; }
+			function f14() returns(uint n) { return 14; }
+			function f15() returns(uint n) { return 15; }
+			function f16() returns(uint n) { return 16; }
+			function f17() returns(uint n) { return 17; }
+			function f18() returns(uint n) { return 18; }
+			function f19() returns(uint n) { return 19; }
+			function() payable { }
+		}
+	)";
+	compileAndRun(sourceCode);
+	for (unsigned i = 0; i < 20; ++i)
+		ABI_CHECK(callContractFunction("f" + to_string(i) + "()"), encodeArgs(u256(i)));
+	ABI_CHECK(callContractFunction("f20()"), encodeArgs());
+	ABI_CHECK(callContractFunction("i_am_not_there()"), encodeArgs());
+}
+
 BOOST_AUTO_TEST_CASE(named_args)
 {
 	char const* sourceCode = R"(
@@ -4732,6 +4767,76 @@ BOOST_AUTO_TEST_CASE(array_copy_calldata_storage)
 		4, 3, 32));
 }
 
+BOOST_AUTO_TEST_CASE(array_copy_packed_memory_storage)
+{
+	char const* sourceCode = R"(
+		contract c {
+			uint16[] data;
+			int8[3] small;
+			function set(uint16[] x, int8[3] y) returns (uint) {
+				data = x;
+				small = y;
+				return data.length;
+			}
+			function setCalldata(uint16[] x) external {
+				data = x;
+			}
+			function grow() { data.length = 32; }
+			function get() returns (uint16[]) { return data; }
+			function getSmall() returns (int8[3]) { return small; }
+		}
+	)";
+	compileAndRun(sourceCode);
+	// 40 elements take three slots, the last one only partially.
+	bytes elements;
+	for (unsigned i = 0; i < 40; ++i)
+		elements += encodeArgs(u256(i + 1));
+	// Higher order bits are cleaned up when copying.
+	bytes dirtyElements = elements;
+	dirtyElements[29] = 0xff;
+	ABI_CHECK(
+		callContractFunction("set(uint16[],int8[3])", encodeArgs(0x80, u256(-1), 5, u256(-128), 40) + dirtyElements),
+		encodeArgs(40)
+	);
+	ABI_CHECK(callContractFunction("get()"), encodeArgs(0x20, 40) + elements);
+	ABI_CHECK(callContractFunction("getSmall()"), encodeArgs(u256(-1), 5, u256(-128)));
+	// Copying a shorter array clears the remaining elements in the last slot.
+	bytes shortElements(elements.begin(), elements.begin() + 17 * 32);
+	ABI_CHECK(callContractFunction("setCalldata(uint16[])", encodeArgs(0x20, 17) + shortElements), encodeArgs());
+	ABI_CHECK(callContractFunction("get()"), encodeArgs(0x20, 17) + shortElements);
+	ABI_CHECK(callContractFunction("grow()"), encodeArgs());
+	ABI_CHECK(callContractFunction("get()"), encodeArgs(0x20, 32) + shortElements + bytes(15 * 32, 0));
+}
+
+BOOST_AUTO_TEST_CASE(memory_copy_large)
+{
+	char const* sourceCode = R"(
+		contract c {
+			function f(bytes x) returns (bytes) { return x; }
+			function g(uint[] x) returns (uint[]) { return x; }
+		}
+	)";
+	compileAndRun(sourceCode);
+	// Large areas are copied using the identity precompile.
+	for (size_t length: {0, 31, 33, 511, 512, 513, 2000})
+	{
+		bytes data(length);
+		for (size_t i = 0; i < length; ++i)
+			data[i] = uint8_t(i * 7);
+		ABI_CHECK(
+			callContractFunction("f(bytes)", encodeArgs(0x20, length) + encode(data, false)),
+			encodeArgs(0x20, length) + encode(data, false)
+		);
+		bytes words;
+		for (size_t i = 0; i < length / 16; ++i)
+			words += encodeArgs(u256(i) << 200);
+		ABI_CHECK(
+			callContractFunction("g(uint256[])", encodeArgs(0x20, length / 16) + words),
+			encodeArgs(0x20, length / 16) + words
+		);
+	}
+}
+
 BOOST_AUTO_TEST_CASE(array_copy_nested_array)
 {
 	char const* sourceCode = R"(
@@ -5515,6 +5620,31 @@ BOOST_AUTO_TEST_CASE(struct_delete_struct_in_mapping)
 	ABI_CHECK(callContractFunction("deleteIt()"), encodeArgs(0));
 }
 
+BOOST_AUTO_TEST_CASE(uninitialized_storage_pointer_aliases_state_variable)
+{
+	char const* sourceCode = R"(
+		contract C {
+			uint public x;
+			struct S { uint a; }
+			function f(bool b) returns (uint) {
+				x = 1;
+				if (b) {
+					x += 1;
+				}
+				S storage p;
+				p.a = 5;
+				x += 1;
+				return x;
+			}
+		}
+	)";
+	compileAndRun(sourceCode, 0, "C");
+	ABI_CHECK(callContractFunction("f(bool)", true), encodeArgs(6));
+	ABI_CHECK(callContractFunction("x()"), encodeArgs(6));
+	ABI_CHECK(callContractFunction("f(bool)", false), encodeArgs(6));
+	ABI_CHECK(callContractFunction("x()"), encodeArgs(6));
+}
+
 BOOST_AUTO_TEST_CASE(evm_exceptions_out_of_band_access)
 {
 	char const* sourceCode = R"(
@@ -6236,6 +6366,43 @@ BOOST_AUTO_TEST_CASE(memory_arrays_dynamic_index_access_write)
 	ABI_CHECK(callContractFunction("f()"), encodeArgs(u256(0x20), u256(4), data));
 }
 
+BOOST_AUTO_TEST_CASE(memory_array_shrunk_in_counted_loop)
+{
+	char const* sourceCode = R"(
+		contract C {
+			function shrink(uint[] a) internal {
+				assembly { mstore(a, 1) }
+			}
+			function f() returns (uint s) {
+				uint[] memory a = new uint[](3);
+				for (uint i = 0; i < a.length; i++)
+				{
+					s += 1 + a[i];
+					shrink(a);
+				}
+			}
+			function g() returns (uint s) {
+				uint n = 3;
+				uint[] memory a = new uint[](n);
+				shrink(a);
+				for (uint i = 0; i < n; i++)
+					s += a[i];
+			}
+			function h(uint[] a) returns (uint s) {
+				uint n = a.length;
+				shrink(a);
+				for (uint i = 0; i < n; i++)
+					s += a[i];
+			}
+		}
+	)";
+	compileAndRun(sourceCode, 0, "C");
+	ABI_CHECK(callContractFunction("f()"), encodeArgs(1));
+	ABI_CHECK(callContractFunction("g()"), bytes());
+	ABI_CHECK(callContractFunction("h(uint256[])", 0x20, 3, 1, 2, 3), bytes());
+	ABI_CHECK(callContractFunction("h(uint256[])", 0x20, 1, 7), encodeArgs(7));
+}
+
 BOOST_AUTO_TEST_CASE(memory_structs_read_write)
 {
 	char const* sourceCode = R"(
@@ -28,6 +28,7 @@
 #include <libsolidity/codegen/CompilerContext.h>
 #include <libsolidity/codegen/ExpressionCompiler.h>
 #include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/TypeProvider.h>
 #include <libsolidity/analysis/TypeChecker.h>
 #include <libsolidity/interface/ErrorReporter.h>
 #include "../TestHelper.h"
@@ -95,6 +96,8 @@ bytes compileFirstExpression(
 	vector<shared_ptr<MagicVariableDeclaration const>> _globalDeclarations = {}
 )
 {
+	TypeProvider typeProvider;
+	TypeProvider::Scope typeScope(typeProvider);
 	ASTPointer<SourceUnit> sourceUnit;
 	try
 	{
@@ -28,6 +28,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include <chrono>
+#include <functional>
 #include <string>
 #include <tuple>
 #include <memory>
@@ -105,6 +106,13 @@ public:
 	/// @returns the number of intructions in the given bytecode, not taking the metadata hash
 	/// into account.
 	size_t numInstructions(bytes const& _bytecode)
+	{
+		return countInstructions(_bytecode, [](Instruction) { return true; });
+	}
+
+	/// @returns the number of instructions in the given bytecode for which @a _predicate
+	/// returns true, not taking the metadata hash into account.
+	size_t countInstructions(bytes const& _bytecode, std::function<bool(Instruction)> const& _predicate)
 	{
 		BOOST_REQUIRE(_bytecode.size() > 5);
 		size_t metadataSize = (_bytecode[_bytecode.size() - 2] << 8) + _bytecode[_bytecode.size() - 1];
@@ -112,8 +120,9 @@ public:
 		BOOST_REQUIRE(_bytecode.size() >= metadataSize + 2);
 		bytes realCode = bytes(_bytecode.begin(), _bytecode.end() - metadataSize - 2);
 		size_t instructions = 0;
-		solidity::eachInstruction(realCode, [&](Instruction, u256 const&) {
-			instructions++;
+		solidity::eachInstruction(realCode, [&](Instruction _instr, u256 const&) {
+			if (_predicate(_instr))
+				instructions++;
 		});
 		return instructions;
 	}
@@ -581,6 +590,214 @@ BOOST_AUTO_TEST_CASE(invalid_state_at_control_flow_join)
 	compareVersions("test()");
 }
 
+BOOST_AUTO_TEST_CASE(storage_cache_across_branches_and_loops)
+{
+	char const* sourceCode = R"(
+		contract C {
+			struct S { uint64 x; uint64 y; uint128 z; }
+			S s;
+			uint total;
+			function f(uint a) returns (uint64, uint64, uint128, uint) {
+				if (a > 5)
+					s.x = uint64(a);
+				else
+					s.y = uint64(a);
+				s.z = uint128(a * 2);
+				for (uint i = 0; i < a; i++)
+					total += i;
+				return (s.x, s.y, s.z, total);
+			}
+		}
+	)";
+	compileBothVersions(sourceCode);
+	compareVersions("f(uint256)", 0);
+	compareVersions("f(uint256)", 3);
+	compareVersions("f(uint256)", 7);
+	compareVersions("f(uint256)", 7);
+	compareVersions("f(uint256)", 0);
+
+	// Both slots are only written back once.
+	bytes optimizedBytecode = compileAndRunWithOptimizer(sourceCode, 0, "C", true);
+	size_t numSSTOREs = countInstructions(optimizedBytecode, [](Instruction _instr) {
+		return _instr == Instruction::SSTORE;
+	});
+	BOOST_CHECK_EQUAL(numSSTOREs, 2);
+}
+
+BOOST_AUTO_TEST_CASE(storage_cache_of_overridden_functions)
+{
+	char const* sourceCode = R"(
+		contract B {
+			uint a;
+			uint b;
+			function f() returns (uint) {
+				for (uint i = 0; i < 3; i++)
+				{
+					a += i;
+					b += a;
+				}
+				return a + b;
+			}
+		}
+		contract C is B {
+			function f() returns (uint) { return 7; }
+			function freeMemoryPointer() returns (uint p) {
+				assembly { p := mload(0x40) }
+			}
+		}
+	)";
+	compileBothVersions(sourceCode, 0, "C");
+	compareVersions("f()");
+	// B.f is never compiled into C, so no memory is reserved for its storage cache.
+	compareVersions("freeMemoryPointer()");
+}
+
+BOOST_AUTO_TEST_CASE(array_loops_without_bounds_checks)
+{
+	char const* sourceCode = R"(
+		contract C {
+			function f(uint[] a, uint8[] b) returns (uint s, uint t) {
+				uint n = b.length;
+				uint[] memory c = new uint[](n);
+				for (uint i = 0; i < a.length; i++)
+					s += a[i] * (i + 1);
+				for (i = 0; i < n; ++i)
+				{
+					c[i] = b[i];
+					if (b[i] == 3)
+						continue;
+					t += c[i] + b[i];
+				}
+			}
+			function g(uint16[] x) external returns (uint s) {
+				for (uint i = 0; i < x.length; i += 1)
+					s += x[i] * i;
+			}
+		}
+	)";
+	compileBothVersions(sourceCode);
+	compareVersions("f(uint256[],uint8[])", u256(0x40), u256(0x60), u256(0), u256(0));
+	compareVersions(
+		"f(uint256[],uint8[])",
+		u256(0x40), u256(0xa0), u256(2), u256(5), u256(7), u256(3), u256(1), u256(3), u256(9)
+	);
+	compareVersions("g(uint16[])", u256(0x20), u256(3), u256(4), u256(5), u256(6));
+
+	// All accesses are in range, so there are no bounds checks left.
+	bytes optimizedBytecode = compileAndRunWithOptimizer(sourceCode, 0, "C", true);
+	size_t numINVALIDs = countInstructions(optimizedBytecode, [](Instruction _instr) {
+		return _instr == Instruction::INVALID;
+	});
+	BOOST_CHECK_EQUAL(numINVALIDs, 0);
+}
+
+BOOST_AUTO_TEST_CASE(constant_folding_of_internal_calls)
+{
+	char const* sourceCode = R"(
+		contract C {
+			uint constant N = 2**16;
+			uint8 constant M = 200;
+			int constant K = -7;
+			function mean(uint a, uint b) internal returns (uint) {
+				return (a + b) / 2;
+			}
+			function sumUpTo(uint n) internal returns (uint s) {
+				for (uint i = 1; i <= n; i++)
+				{
+					if (i % 7 == 0)
+						continue;
+					s += i;
+				}
+			}
+			function f(uint x) returns (uint, uint, uint8, int) {
+				return (x / (N - 1), mean(N, 10) + sumUpTo(100), M + M, K / 2 % 3);
+			}
+		}
+	)";
+	compileBothVersions(sourceCode);
+	compareVersions("f(uint256)", u256(0));
+	compareVersions("f(uint256)", u256(1) << 20);
+
+	// Only the divisions in the function selector and by the argument remain.
+	bytes optimizedBytecode = compileAndRunWithOptimizer(sourceCode, 0, "C", true);
+	size_t numDivisions = countInstructions(optimizedBytecode, [](Instruction _instr) {
+		return _instr == Instruction::DIV || _instr == Instruction::SDIV || _instr == Instruction::MOD || _instr == Instruction::SMOD;
+	});
+	BOOST_CHECK_EQUAL(numDivisions, 2);
+}
+
+BOOST_AUTO_TEST_CASE(constant_hashes_and_mapping_slots)
+{
+	char const* sourceCode = R"(
+		contract C {
+			bytes32 constant TAG = keccak256("tag");
+			string constant NAME = "alice";
+			mapping(string => uint) byName;
+			mapping(uint => mapping(bytes32 => uint)) nested;
+			function set(uint x) {
+				byName[NAME] = x;
+				nested[1][TAG] = x + 1;
+				nested[2]["tag"] += x;
+			}
+			function get() returns (uint, uint, uint, bytes4, bytes32) {
+				return (
+					byName["alice"],
+					nested[1][TAG],
+					nested[2][bytes3("tag")],
+					bytes4(keccak256("version")),
+					keccak256(uint8(1), -1, NAME, true, TAG)
+				);
+			}
+			function hash(uint x) returns (bytes32) {
+				return keccak256(x, TAG);
+			}
+		}
+	)";
+	compileBothVersions(sourceCode);
+	compareVersions("set(uint256)", u256(7));
+	compareVersions("get()");
+	compareVersions("hash(uint256)", u256(7));
+
+	// Only the hash of the argument is computed at runtime.
+	bytes optimizedBytecode = compileAndRunWithOptimizer(sourceCode, 0, "C", true);
+	size_t numHashes = countInstructions(optimizedBytecode, [](Instruction _instr) {
+		return _instr == Instruction::KECCAK256;
+	});
+	BOOST_CHECK_EQUAL(numHashes, 1);
+}
+
+BOOST_AUTO_TEST_CASE(loop_unrolling)
+{
+	char const* sourceCode = R"(
+		contract C {
+			function f(uint[3] a) returns (uint r) {
+				for (uint i = 0; i < a.length; i++)
+					r = r * 10 + a[i];
+			}
+			function g() returns (uint r) {
+				for (uint i = 1; i <= 7; i += 3) {
+					if (i == 4)
+						continue;
+					r += i;
+				}
+			}
+		}
+	)";
+	compileBothVersions(sourceCode, 0, "C", 10000);
+	compareVersions("f(uint256[3])", u256(1), u256(2), u256(3));
+	compareVersions("g()");
+
+	// The loops are only unrolled if the contract is expected to run often.
+	auto countJumps = [&](unsigned _optimizeRuns)
+	{
+		bytes optimizedBytecode = compileAndRunWithOptimizer(sourceCode, 0, "C", true, _optimizeRuns);
+		return countInstructions(optimizedBytecode, [](Instruction _instr) {
+			return _instr == Instruction::JUMPI;
+		});
+	};
+	BOOST_CHECK_LT(countJumps(10000), countJumps(1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -122,6 +122,47 @@ BOOST_AUTO_TEST_CASE(smoke_test)
 	BOOST_CHECK(successParse(text));
 }
 
+BOOST_AUTO_TEST_CASE(nodes_allocated_in_arena)
+{
+	char const* text = R"(
+		contract test {
+			uint256 stateVariable1;
+		}
+	)";
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	ASTPointer<SourceUnit> sourceUnit = Parser(errorReporter).parse(std::make_shared<Scanner>(CharStream(text)));
+	BOOST_REQUIRE(sourceUnit);
+	BOOST_REQUIRE(sourceUnit->arena());
+	BOOST_CHECK(sourceUnit->arena()->allocationCount() > 0);
+	// Nodes keep the arena alive after the source unit is gone.
+	ASTPointer<ASTNode> contract = sourceUnit->nodes().front();
+	sourceUnit.reset();
+	BOOST_REQUIRE(dynamic_pointer_cast<ContractDefinition>(contract));
+	BOOST_CHECK_EQUAL(dynamic_pointer_cast<ContractDefinition>(contract)->name(), "test");
+}
+
+BOOST_AUTO_TEST_CASE(identifiers_interned)
+{
+	char const* text = R"(
+		contract test {
+			uint256 value;
+			function f(uint256 x) returns (uint256) { value = x; return value; }
+		}
+	)";
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	auto strings = make_shared<ASTStringTable>();
+	ASTPointer<SourceUnit> sourceUnit = Parser(errorReporter, strings).parse(std::make_shared<Scanner>(CharStream(text)));
+	BOOST_REQUIRE(sourceUnit);
+	auto contract = dynamic_pointer_cast<ContractDefinition>(sourceUnit->nodes().front());
+	BOOST_REQUIRE(contract);
+	VariableDeclaration const& variable = *contract->stateVariables().front();
+	BOOST_CHECK_EQUAL(&variable.name(), strings->intern("value").get());
+	BOOST_CHECK_EQUAL(&contract->name(), strings->intern("test").get());
+	BOOST_CHECK(strings->lookups() > strings->size());
+}
+
 BOOST_AUTO_TEST_CASE(missing_variable_name_in_declaration)
 {
 	char const* text = R"(
@@ -38,6 +38,19 @@ BOOST_AUTO_TEST_CASE(test_empty)
 	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::EOS);
 }
 
+BOOST_AUTO_TEST_CASE(source_shared_between_copies)
+{
+	auto source = std::make_shared<std::string const>("contract C {}");
+	Scanner scanner(CharStream(source), "C.sol");
+	Scanner copy(scanner);
+	BOOST_CHECK(scanner.sharedSource() == source);
+	BOOST_CHECK(copy.sharedSource() == source);
+	BOOST_CHECK_EQUAL(&copy.source(), source.get());
+	BOOST_CHECK_EQUAL(copy.currentToken(), Token::Contract);
+	BOOST_CHECK_EQUAL(copy.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Contract);
+}
+
 BOOST_AUTO_TEST_CASE(smoke_test)
 {
 	Scanner scanner(CharStream("function break;765  \t  \"string1\",'string2'\nidentifier1"));
@@ -176,6 +189,31 @@ BOOST_AUTO_TEST_CASE(locations)
 	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
 }
 
+BOOST_AUTO_TEST_CASE(long_runs_locations)
+{
+	// Runs of whitespace, identifier characters and comment bodies that span
+	// several 16 byte blocks and end at different offsets inside them.
+	Scanner scanner(CharStream(
+		"a_very_long_identifier_name_$42 \t\r\n                    x"
+		"/* comment ** with * stars spanning blocks */y// line comment until the end\n"
+		"z /* unterminated comment"
+	));
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "a_very_long_identifier_name_$42");
+	BOOST_CHECK_EQUAL(scanner.currentLocation().start, 0);
+	BOOST_CHECK_EQUAL(scanner.currentLocation().end, 31);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "x");
+	BOOST_CHECK_EQUAL(scanner.currentLocation().start, 55);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "y");
+	BOOST_CHECK_EQUAL(scanner.currentLocation().start, 101);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "z");
+	BOOST_CHECK_EQUAL(scanner.currentLocation().start, 132);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Illegal);
+}
+
 BOOST_AUTO_TEST_CASE(ambiguities)
 {
 	// test scanning of some operators which need look-ahead
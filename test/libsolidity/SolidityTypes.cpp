@@ -21,6 +21,7 @@
  */
 
 #include <libsolidity/ast/Types.h>
+#include <libsolidity/ast/TypeProvider.h>
 #include <libsolidity/ast/AST.h>
 #include <libdevcore/SHA3.h>
 #include <boost/test/unit_test.hpp>
@@ -34,7 +35,18 @@ namespace solidity
 namespace test
 {
 
-BOOST_AUTO_TEST_SUITE(SolidityTypes)
+/// Makes a type provider of its own available to every test case.
+class TypeProviderFramework
+{
+public:
+	TypeProviderFramework(): m_typeScope(m_typeProvider) {}
+
+private:
+	TypeProvider m_typeProvider;
+	TypeProvider::Scope m_typeScope;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SolidityTypes, TypeProviderFramework)
 
 BOOST_AUTO_TEST_CASE(storage_layout_simple)
 {
@@ -77,6 +89,29 @@ BOOST_AUTO_TEST_CASE(storage_layout_mapping)
 	BOOST_CHECK(*members.memberStorageOffset("final") == make_pair(u256(3), unsigned(0)));
 }
 
+BOOST_AUTO_TEST_CASE(storage_layout_packed)
+{
+	TypePointers types{
+		Type::fromElementaryTypeName("uint8"),
+		Type::fromElementaryTypeName("uint256"),
+		Type::fromElementaryTypeName("uint16"),
+		make_shared<MappingType>(Type::fromElementaryTypeName("uint8"), Type::fromElementaryTypeName("uint8")),
+		Type::fromElementaryTypeName("uint8"),
+		Type::fromElementaryTypeName("uint248")
+	};
+	StorageOffsets offsets;
+	offsets.computeOffsets(types);
+	BOOST_CHECK_EQUAL(offsets.storageSize(), u256(5));
+	offsets.computeOffsets(types, StorageOffsets::packedOrder(types));
+	BOOST_CHECK_EQUAL(offsets.storageSize(), u256(4));
+	BOOST_CHECK(*offsets.offset(0) == make_pair(u256(0), unsigned(0)));
+	BOOST_CHECK(*offsets.offset(5) == make_pair(u256(0), unsigned(1)));
+	BOOST_CHECK(*offsets.offset(1) == make_pair(u256(1), unsigned(0)));
+	BOOST_CHECK(*offsets.offset(2) == make_pair(u256(2), unsigned(0)));
+	BOOST_CHECK(*offsets.offset(4) == make_pair(u256(2), unsigned(2)));
+	BOOST_CHECK(*offsets.offset(3) == make_pair(u256(3), unsigned(0)));
+}
+
 BOOST_AUTO_TEST_CASE(storage_layout_arrays)
 {
 	BOOST_CHECK(ArrayType(DataLocation::Storage, make_shared<FixedBytesType>(1), 32).storageSize() == 1);
@@ -88,6 +123,43 @@ BOOST_AUTO_TEST_CASE(storage_layout_arrays)
 	BOOST_CHECK(ArrayType(DataLocation::Storage, make_shared<FixedBytesType>(32), 9).storageSize() == 9);
 }
 
+BOOST_AUTO_TEST_CASE(canonical_types)
+{
+	BOOST_CHECK(Type::fromElementaryTypeName("uint") == TypeProvider::uint256());
+	BOOST_CHECK(Type::fromElementaryTypeName("uint256") == TypeProvider::uint256());
+	BOOST_CHECK(Type::fromElementaryTypeName("address") == TypeProvider::address());
+	BOOST_CHECK(Type::fromElementaryTypeName("byte") == TypeProvider::fixedBytes(1));
+	BOOST_CHECK(Type::fromElementaryTypeName("string") == TypeProvider::stringStorage());
+	BOOST_CHECK(Type::fromElementaryTypeName("int8") != Type::fromElementaryTypeName("uint8"));
+
+	TypePointer key = TypeProvider::address();
+	TypePointer value = TypeProvider::uint256();
+	BOOST_CHECK(TypeProvider::mapping(key, value) == TypeProvider::mapping(key, value));
+	BOOST_CHECK(TypeProvider::mapping(key, value) != TypeProvider::mapping(value, key));
+	BOOST_CHECK(TypeProvider::array(DataLocation::Storage, value) == TypeProvider::array(DataLocation::Storage, value));
+	BOOST_CHECK(TypeProvider::array(DataLocation::Storage, value) != TypeProvider::array(DataLocation::Memory, value));
+	BOOST_CHECK(TypeProvider::array(DataLocation::Storage, value, 2) != TypeProvider::array(DataLocation::Storage, value, 3));
+	BOOST_CHECK(*TypeProvider::array(DataLocation::Storage, value, 2) == ArrayType(DataLocation::Storage, value, 2));
+}
+
+BOOST_AUTO_TEST_CASE(type_provider_scopes)
+{
+	TypeProvider first;
+	TypeProvider second;
+	TypePointer uint256;
+	{
+		TypeProvider::Scope scope(first);
+		uint256 = TypeProvider::uint256();
+		{
+			TypeProvider::Scope innerScope(second);
+			BOOST_CHECK(TypeProvider::uint256() != uint256);
+			BOOST_CHECK(*TypeProvider::uint256() == *uint256);
+		}
+		BOOST_CHECK(TypeProvider::uint256() == uint256);
+	}
+	BOOST_CHECK(TypeProvider::uint256() != uint256);
+}
+
 BOOST_AUTO_TEST_CASE(type_identifiers)
 {
 	ASTNode::resetID();
@@ -411,6 +411,64 @@ BOOST_AUTO_TEST_CASE(output_selection_dependent_contract_with_import)
 	BOOST_CHECK_EQUAL(dev::jsonCompactPrint(contract["abi"]), "[{\"constant\":false,\"inputs\":[],\"name\":\"f\",\"outputs\":[],\"payable\":false,\"stateMutability\":\"nonpayable\",\"type\":\"function\"}]");
 }
 
+BOOST_AUTO_TEST_CASE(storage_layout_packed)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"outputSelection": {
+				"fileA": {
+					"A": [
+						"storageLayout"
+					]
+				}
+			}
+		},
+		"sources": {
+			"fileA": {
+				"content": "pragma experimental StoragePacking; import \"fileB\"; contract A is B { uint8 d; struct S { uint8 x; uint y; uint8 z; } S s; uint16 e; }"
+			},
+			"fileB": {
+				"content": "contract B { uint8 a; uint b; uint8 c; }"
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(result));
+	Json::Value layout = getContractResult(result, "fileA", "A")["storageLayout"];
+	BOOST_REQUIRE(layout.isObject());
+	BOOST_CHECK_EQUAL(layout["numberOfSlots"].asString(), "5");
+	Json::Value const& storage = layout["storage"];
+	BOOST_REQUIRE_EQUAL(storage.size(), 6);
+	// The base contract is not reordered and comes first.
+	vector<tuple<string, string, string, int>> expectation{
+		make_tuple("fileB:B", "a", "0", 0),
+		make_tuple("fileB:B", "b", "1", 0),
+		make_tuple("fileB:B", "c", "2", 0),
+		make_tuple("fileA:A", "d", "2", 1),
+		make_tuple("fileA:A", "s", "3", 0),
+		make_tuple("fileA:A", "e", "2", 2)
+	};
+	for (size_t i = 0; i < expectation.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL(storage[int(i)]["contract"].asString(), get<0>(expectation[i]));
+		BOOST_CHECK_EQUAL(storage[int(i)]["label"].asString(), get<1>(expectation[i]));
+		BOOST_CHECK_EQUAL(storage[int(i)]["slot"].asString(), get<2>(expectation[i]));
+		BOOST_CHECK_EQUAL(storage[int(i)]["offset"].asInt(), get<3>(expectation[i]));
+	}
+	Json::Value const& structType = layout["types"][storage[4]["type"].asString()];
+	BOOST_CHECK_EQUAL(structType["label"].asString(), "struct A.S");
+	BOOST_CHECK_EQUAL(structType["numberOfBytes"].asString(), "64");
+	BOOST_CHECK_EQUAL(
+		dev::jsonCompactPrint(structType["members"]),
+		"[{\"label\":\"x\",\"offset\":0,\"slot\":\"0\",\"type\":\"t_uint8\"},"
+		"{\"label\":\"y\",\"offset\":0,\"slot\":\"1\",\"type\":\"t_uint256\"},"
+		"{\"label\":\"z\",\"offset\":1,\"slot\":\"0\",\"type\":\"t_uint8\"}]"
+	);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }